@@ -15,6 +15,9 @@
 #include "polarphp/global/Config.h"
 #include "polarphp/runtime/ExecEnv.h"
 #include "polarphp/runtime/LifeCycle.h"
+#include "polarphp/runtime/ScriptBundle.h"
+#include "polarphp/runtime/StartupProfile.h"
+#include "polarphp/utils/RawOutStream.h"
 #include "php/global/Defs.h"
 
 #include "CLI/CLI.hpp"
@@ -26,6 +29,9 @@
 #include <string>
 
 using polar::basic::StringRef;
+using polar::runtime::StartupProfile;
+using polar::runtime::StartupPhase;
+using polar::utils::TimeRecord;
 
 void setup_command_opts(CLI::App &parser);
 
@@ -42,6 +48,7 @@ bool sg_hideExternArgs;
 bool sg_showIniCfg;
 bool sg_stripCode;
 std::string sg_configPath{};
+std::string sg_iniCacheFile{};
 std::string sg_scriptFile{};
 std::string sg_codeWithoutPhpTags{};
 std::string sg_beginCode{};
@@ -51,20 +58,61 @@ std::vector<std::string> sg_zendExtensionFilenames{};
 std::vector<std::string> sg_scriptArgs{};
 std::vector<std::string> sg_defines{};
 std::string sg_reflectWhat{};
+std::string sg_bundleFile{};
+std::string sg_makeBundleDir{};
+bool sg_bundleCompress;
+bool sg_startupProfile;
+bool sg_startupProfileJson;
 
 int main(int argc, char *argv[])
 {
+   /// the profile flags are only known once the command line is parsed,
+   /// the phases before are measured anyway, it costs a few syscalls
+   TimeRecord initStartTime = TimeRecord::getCurrentTime(true);
    polar::InitPolar polarInitializer(argc, argv);
+   TimeRecord initTime = TimeRecord::getCurrentTime(false);
    CLI::App cmdParser;
    cmdParser.formatter(std::make_shared<polar::PhpOptFormatter>());
    polarInitializer.initNgOpts(cmdParser);
    setup_command_opts(cmdParser);
    CLI11_PARSE(cmdParser, argc, argv);
+   if (sg_startupProfile || sg_startupProfileJson) {
+      TimeRecord parseTime = TimeRecord::getCurrentTime(false);
+      parseTime -= initTime;
+      initTime -= initStartTime;
+      StartupProfile &profile = StartupProfile::getInstance();
+      profile.enable();
+      profile.addRecord(StartupProfile::PROCESS_GROUP, "init_polar", initTime);
+      profile.addRecord(StartupProfile::PROCESS_GROUP, "parse_command_line", parseTime);
+   }
    /// check command semantic error
    if (sg_exitStatus != 0) {
       std::cerr << sg_errorMsg << std::endl;
       exit(sg_exitStatus);
    }
+   if (!sg_makeBundleDir.empty()) {
+      if (sg_bundleFile.empty()) {
+         std::cerr << "--make-bundle requires the output file given by --bundle" << std::endl;
+         exit(1);
+      }
+      std::string errorMsg;
+      if (!polar::runtime::ScriptBundle::build(sg_bundleFile, sg_makeBundleDir, sg_bundleCompress, errorMsg)) {
+         std::cerr << errorMsg << std::endl;
+         exit(1);
+      }
+      exit(0);
+   }
+   if (!sg_bundleFile.empty()) {
+      StartupPhase phase(StartupProfile::PROCESS_GROUP, "mount_bundle");
+      std::string errorMsg;
+      std::unique_ptr<polar::runtime::ScriptBundle> bundle =
+            polar::runtime::ScriptBundle::open(sg_bundleFile, "", errorMsg);
+      if (!bundle) {
+         std::cerr << errorMsg << std::endl;
+         exit(1);
+      }
+      polar::runtime::ScriptBundle::mount(std::move(bundle));
+   }
    polar::runtime::ExecEnv &execEnv = polar::runtime::retrieve_global_execenv();
    polar::runtime::ExecEnvInfo &execEnvInfo = execEnv.getRuntimeInfo();
    execEnv.setContainerArgc(argc);
@@ -118,6 +166,7 @@ int main(int argc, char *argv[])
    ///
    execEnvInfo.iniDefaultInitHandler = polar::runtime::cli_ini_defaults;
    execEnvInfo.phpIniPathOverride = sg_configPath;
+   execEnvInfo.iniCacheFile = sg_iniCacheFile;
    execEnvInfo.phpIniIgnoreCwd = true;
    execEnvInfo.phpIniIgnore = sg_ignoreIni;
    iniEntries += polar::runtime::HARDCODED_INI;
@@ -145,6 +194,11 @@ int main(int argc, char *argv[])
       sg_exitStatus = 1;
       exit(sg_exitStatus);
    }
+   if (sg_startupProfileJson) {
+      StartupProfile::getInstance().printJSON(polar::utils::error_stream());
+   } else if (sg_startupProfile) {
+      StartupProfile::getInstance().print(polar::utils::error_stream());
+   }
    try {
        sg_exitStatus = polar::dispatch_cli_command();
    } catch(std::exception &e) {
@@ -168,6 +222,7 @@ void setup_command_opts(CLI::App &parser)
 {
    /// order sensitive
    parser.add_option("-c, --config", sg_configPath, "Look for php.yaml file in this directory.")->type_name("<path>|<file>");
+   parser.add_option("--ini-cache", sg_iniCacheFile, "Cache the parsed ini files in <file>.")->type_name("<file>");
    parser.add_flag("-n", sg_ignoreIni, "No configuration (ini) files will be used");
    parser.add_option("-d", sg_defines, "Define INI entry foo with value 'bar'.")->type_name("foo[=bar]");
    parser.add_flag("-e, --generate-extend-info", sg_generateExtendInfo, "Generate extended information for debugger/profiler.");
@@ -186,6 +241,11 @@ void setup_command_opts(CLI::App &parser)
    parser.add_flag("-w",  polar::strip_code_opt_setter, "Output source with stripped comments and whitespace.");
    parser.add_option("-z", sg_zendExtensionFilenames, "Load Zend extension <file>.")->type_name("<file>");
    parser.add_flag("-H", sg_hideExternArgs, "Hide any passed arguments from external tools.");
+   parser.add_option("--bundle", sg_bundleFile, "Resolve scripts against the application bundle <file>.")->type_name("<file>");
+   parser.add_option("--make-bundle", sg_makeBundleDir, "Pack the scripts below <dir> into the --bundle file.")->type_name("<dir>");
+   parser.add_flag("--bundle-compress", sg_bundleCompress, "Compress the scripts packed by --make-bundle.");
+   parser.add_flag("--startup-profile", sg_startupProfile, "Print the time spent by every startup phase and module.");
+   parser.add_flag("--startup-profile-json", sg_startupProfileJson, "Print the startup profile as JSON, for the regression checks.");
 
    parser.add_option("--rf", CLI::callback_t(polar::reflection_func_opt_setter), "Show information about function <name>.")->type_name("<name>");
    parser.add_option("--rc", CLI::callback_t(polar::reflection_class_opt_setter), "Show information about class <name>.")->type_name("<name>");
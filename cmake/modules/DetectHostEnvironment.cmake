@@ -345,6 +345,7 @@ polar_check_funcs(
    cuserid
    crypt
    flock
+   fork
    ftok
    funopen
    gai_strerror
@@ -1883,6 +1883,9 @@
 /* Use zend signal handling */
 #cmakedefine ZEND_SIGNALS
 
+/* Collect polymorphic inline cache statistics */
+#cmakedefine01 ZEND_INLINE_CACHE_STATS
+
 /* */
 #cmakedefine01 ZTS
 
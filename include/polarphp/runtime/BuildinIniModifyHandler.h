@@ -42,6 +42,7 @@ ZEND_INI_MH(change_memory_limit_handler);
 ZEND_INI_MH(set_precision_handler);
 ZEND_INI_MH(set_facility_handler);
 ZEND_INI_MH(set_log_filter_handler);
+ZEND_INI_MH(update_realpath_cache_shared_size_handler);
 
 ///
 /// custom ini displayer handlers
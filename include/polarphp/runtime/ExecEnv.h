@@ -75,8 +75,28 @@ void php_message_handler_for_zend(zend_long message, const void *data);
 void php_on_timeout(int seconds);
 char *bootstrap_getenv(char *name, size_t nameLen);
 zend_string *php_resolve_path(const char *filename, size_t filename_len, const char *path);
+
+///
+/// counters of the php_resolve_path() result cache
+///
+struct ResolvePathCacheStats
+{
+   size_t entries;
+   zend_ulong hits;
+   zend_ulong negativeHits;
+   zend_ulong misses;
+   zend_ulong invalidations;
+};
+
+POLAR_DECL_EXPORT ResolvePathCacheStats php_resolve_path_cache_stats();
+POLAR_DECL_EXPORT void php_resolve_path_cache_clear();
+PHP_FUNCTION(resolve_path_cache_status);
 zend_string *php_resolve_path_for_zend(const char *filename, size_t filenameLen);
 bool seek_file_begin(zend_file_handle *fileHandle, const char *scriptFile, int *lineno);
+/// Map \p scriptFile read only and hand it to the scanner without copying,
+/// the shebang line is skipped by offset when \p lineno is given.
+bool open_mapped_script(zend_file_handle *fileHandle, const char *scriptFile, int *lineno);
+int php_stream_open_for_zend(const char *filename, zend_file_handle *handle);
 POLAR_DECL_EXPORT bool php_hash_environment();
 void cli_register_file_handles();
 POLAR_DECL_EXPORT ZEND_COLD void php_log_err_with_severity(char *logMessage, int syslogTypeInt);
@@ -133,6 +153,8 @@ struct ExecEnvInfo
 
    std::string iniEntries;
    std::string phpIniPathOverride;
+   /// binary cache of the parsed ini files, see IniCache
+   std::string iniCacheFile;
    std::string outputHandler;
    std::string unserializeCallbackFunc;
    std::string errorLog;
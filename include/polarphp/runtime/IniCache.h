@@ -0,0 +1,88 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/04.
+
+#ifndef POLARPHP_RUNTIME_INI_CACHE_H
+#define POLARPHP_RUNTIME_INI_CACHE_H
+
+#include "polarphp/basic/adt/StringMap.h"
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/runtime/internal/DepsZendVmHeaders.h"
+
+#include <string>
+#include <vector>
+
+namespace polar {
+namespace runtime {
+
+using polar::basic::StringMap;
+using polar::basic::StringRef;
+
+///
+/// Binary cache of the parsed ini files.
+///
+/// The cache keeps, for every ini file, the parser callbacks the file
+/// produced, keyed by the path, the size and the mtime of the file. When the
+/// file did not change the callbacks are replayed into the configuration
+/// hash, the file is neither read nor scanned. The files expanding
+/// environment variables are always parsed, their values depend on the
+/// process. The -d entries of the command line are never cached.
+///
+class IniCache
+{
+public:
+   /// An empty \p cacheFile disables the cache.
+   explicit IniCache(StringRef cacheFile);
+
+   /// Parse \p fileHandle through the cache, behaves like zend_parse_ini_file()
+   /// with an unbuffered, normal mode scanner.
+   int parseFile(zend_file_handle *fileHandle, zend_ini_parser_cb_t callback, void *arg);
+
+   /// Write the cache back when a file was parsed, the entries of the files
+   /// not seen by this process are dropped.
+   bool save();
+
+private:
+   struct Record
+   {
+      int type;
+      uint8_t argMask;
+      std::string args[3];
+   };
+
+   struct FileEntry
+   {
+      uint64_t size;
+      int64_t mtime;
+      bool used;
+      std::vector<Record> records;
+   };
+
+   struct RecordContext
+   {
+      zend_ini_parser_cb_t callback;
+      void *arg;
+      FileEntry *entry;
+      bool cacheable;
+   };
+
+   static void recordCallback(zval *arg1, zval *arg2, zval *arg3, int callbackType, void *arg);
+   bool load();
+   void replay(const FileEntry &entry, zend_ini_parser_cb_t callback, void *arg);
+
+   std::string m_cacheFile;
+   StringMap<FileEntry> m_files;
+   bool m_dirty;
+};
+
+} // runtime
+} // polar
+
+#endif // POLARPHP_RUNTIME_INI_CACHE_H
@@ -0,0 +1,64 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/04.
+
+#ifndef POLARPHP_RUNTIME_INI_PER_DIR_TRIE_H
+#define POLARPHP_RUNTIME_INI_PER_DIR_TRIE_H
+
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/runtime/internal/DepsZendVmHeaders.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace polar {
+namespace runtime {
+
+using polar::basic::StringRef;
+
+///
+/// The PATH sections of the ini files compiled into a trie of directories.
+///
+/// Every node holds the settings of its own section merged over the
+/// sections above it, a request path is resolved by one walk picking the
+/// deepest configured directory. The result is the one of applying the
+/// section of every leading directory of the path in turn. The strings
+/// belong to the section hashes, which must outlive the trie.
+///
+class IniPerDirTrie
+{
+public:
+   using Settings = std::vector<std::pair<zend_string *, zend_string *>>;
+
+   IniPerDirTrie();
+   ~IniPerDirTrie();
+
+   /// Add the section of the directory \p key, the key as the ini parser
+   /// stores it in the configuration hash.
+   void addSection(StringRef key, HashTable *section);
+
+   /// Merge the settings down the trie, once all the sections are added.
+   void build();
+
+   /// The settings for the script \p path, null when no section matches.
+   const Settings *lookup(StringRef path) const;
+
+private:
+   struct Node;
+   static void mergeSettings(Node *node, const Settings &inherited);
+
+   std::unique_ptr<Node> m_root;
+};
+
+} // runtime
+} // polar
+
+#endif // POLARPHP_RUNTIME_INI_PER_DIR_TRIE_H
@@ -0,0 +1,100 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/01/22.
+
+#ifndef POLARPHP_RUNTIME_REQUEST_EXECUTOR_H
+#define POLARPHP_RUNTIME_REQUEST_EXECUTOR_H
+
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/runtime/ExecEnv.h"
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef ZTS
+
+namespace polar {
+namespace runtime {
+
+///
+/// Runs requests on a fixed set of worker threads, each of them owning its
+/// own thread safe resources and ExecEnv, so one process can serve many
+/// concurrent requests.
+///
+/// The executor must be created on the thread that booted the global
+/// ExecEnv, the workers copy its runtime info when they start. A worker
+/// keeps its interpreter context between jobs, every job is wrapped in
+/// php_exec_env_startup() / php_exec_env_shutdown().
+///
+class RequestExecutor
+{
+public:
+   /// the value returned by an entry becomes the exit status of the job
+   using EntryFuncType = std::function<int()>;
+
+   /// Construct an executor with the number of threads found by
+   /// hardware_concurrency().
+   RequestExecutor();
+
+   /// Construct an executor with \p threadCount worker threads
+   RequestExecutor(unsigned threadCount);
+
+   /// Blocking destructor: waits for the queued jobs, then stops the workers.
+   ~RequestExecutor();
+
+   /// Queue the script \p filename, the returned future yields its exit status.
+   std::future<int> submitScript(StringRef filename);
+
+   /// Queue \p entry to be called inside an activated request, a C++
+   /// exception thrown by \p entry is rethrown by the future.
+   std::future<int> submit(EntryFuncType entry);
+
+   /// Blocking wait for the queue to be empty and all workers to be idle.
+   void wait();
+
+   unsigned getThreadCount() const;
+
+private:
+   struct Job
+   {
+      std::string filename;
+      EntryFuncType entry;
+      std::promise<int> exitStatus;
+   };
+
+   std::future<int> enqueue(Job job);
+   void workerLoop();
+   int runJob(Job &job);
+
+   std::vector<std::thread> m_threads;
+   std::queue<Job> m_jobs;
+   std::mutex m_queueLock;
+   std::condition_variable m_queueCondition;
+   std::condition_variable m_completionCondition;
+   unsigned m_activeThreads;
+   bool m_enableFlag;
+   /// snapshot of the booting thread's settings, copied into every worker
+   ExecEnvInfo m_runtimeInfo;
+   std::vector<std::string> m_argv;
+   uint32_t m_compileOptions;
+};
+
+} // runtime
+} // polar
+
+#endif // ZTS
+
+#endif // POLARPHP_RUNTIME_REQUEST_EXECUTOR_H
@@ -0,0 +1,57 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/01/23.
+
+#ifndef POLARPHP_RUNTIME_REQUEST_SNAPSHOT_H
+#define POLARPHP_RUNTIME_REQUEST_SNAPSHOT_H
+
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/runtime/ExecEnv.h"
+
+namespace polar {
+namespace runtime {
+
+///
+/// Keeps a fully warmed request alive in the current process and serves
+/// every following request from a fork() of it.
+///
+/// capture() runs a bootstrap script inside the active request of the
+/// global ExecEnv, the classes, functions, constants and globals it
+/// defines stay in place. exec() then forks a child that inherits that
+/// state copy-on-write, runs the request script there and exits, so the
+/// bootstrap cost is paid only once and no request can leak state into
+/// the next one.
+///
+/// The template process must be single threaded when exec() is called,
+/// don't combine it with a running RequestExecutor.
+///
+class RequestSnapshot
+{
+public:
+   RequestSnapshot();
+
+   /// Run \p bootstrapFilename in the current request and keep its state.
+   bool capture(StringRef bootstrapFilename);
+
+   /// Run \p filename on top of the captured state, \p exitStatus receives
+   /// the exit status of the request. Returns false if the request could
+   /// not be started.
+   bool exec(StringRef filename, int &exitStatus);
+
+   bool isCaptured() const;
+
+private:
+   bool m_captured;
+};
+
+} // runtime
+} // polar
+
+#endif // POLARPHP_RUNTIME_REQUEST_SNAPSHOT_H
@@ -263,8 +263,10 @@ void emit_fd_setsize_warning(int maxFd);
 #define PHP_NAMED_FE	ZEND_NAMED_FE
 #define PHP_FE			ZEND_FE
 #define PHP_DEP_FE      ZEND_DEP_FE
+#define PHP_TS_FE       ZEND_TS_FE
 #define PHP_FALIAS		ZEND_FALIAS
 #define PHP_DEP_FALIAS	ZEND_DEP_FALIAS
+#define PHP_TS_FALIAS	ZEND_TS_FALIAS
 #define PHP_ME          ZEND_ME
 #define PHP_MALIAS      ZEND_MALIAS
 #define PHP_ABSTRACT_ME ZEND_ABSTRACT_ME
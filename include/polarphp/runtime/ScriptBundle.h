@@ -0,0 +1,90 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/02/26.
+
+#ifndef POLARPHP_RUNTIME_SCRIPT_BUNDLE_H
+#define POLARPHP_RUNTIME_SCRIPT_BUNDLE_H
+
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/utils/MemoryBuffer.h"
+#include "polarphp/utils/VirtualFileSystem.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace polar {
+namespace runtime {
+
+using polar::basic::StringRef;
+using polar::basic::IntrusiveRefCountPtr;
+using polar::utils::MemoryBuffer;
+using polar::vfs::InMemoryFileSystem;
+
+///
+/// Read only tree of scripts packed into a single file.
+///
+/// A bundle is a ustar archive written by TarWriter, every member path is
+/// prefixed with "bundle/". When the archive starts with a "bundle/.compressed"
+/// member every other member holds the decimal size of the source, a new
+/// line and the zlib stream of the source.
+/// The member paths are normalized, an absolute one or one with a ".."
+/// component fails the load.
+///
+/// The archive is mapped once, the members are exposed below the mount
+/// point through an InMemoryFileSystem whose buffers point into the mapping,
+/// so opening a bundled script costs neither a syscall nor a copy. Relative
+/// paths are resolved against the mount point, like the working directory
+/// would be for plain files.
+///
+class ScriptBundle
+{
+public:
+   /// Pack every regular file below \p rootDir into \p bundlePath.
+   static bool build(StringRef bundlePath, StringRef rootDir, bool compress,
+                     std::string &errorMsg);
+
+   /// Map \p bundlePath and expose its files below \p mountPoint, the
+   /// absolute path of the bundle itself is used when it is empty.
+   static std::unique_ptr<ScriptBundle> open(StringRef bundlePath, StringRef mountPoint,
+                                             std::string &errorMsg);
+
+   /// Install \p bundle as the one include, require and the class loader
+   /// resolve against, must be done before the request threads start.
+   static void mount(std::unique_ptr<ScriptBundle> bundle);
+   static ScriptBundle *getMounted();
+
+   /// Find the source of the bundled file \p path, the text stays valid as
+   /// long as the bundle and is followed by ZEND_MMAP_AHEAD zero bytes.
+   bool getSource(StringRef path, StringRef &source) const;
+   bool isFile(StringRef path) const;
+   bool isDirectory(StringRef path) const;
+
+   StringRef getMountPoint() const;
+   size_t getFileCount() const;
+
+private:
+   ScriptBundle(std::unique_ptr<MemoryBuffer> buffer, StringRef mountPoint);
+   bool load(std::string &errorMsg);
+   bool addMember(StringRef path, StringRef data, time_t mtime, bool compressed,
+                  std::string &errorMsg);
+   StringRef keepPadded(StringRef data);
+
+   std::unique_ptr<MemoryBuffer> m_buffer;
+   std::string m_mountPoint;
+   IntrusiveRefCountPtr<InMemoryFileSystem> m_fileSystem;
+   std::vector<std::unique_ptr<char[]>> m_ownedSources;
+   size_t m_fileCount;
+};
+
+} // runtime
+} // polar
+
+#endif // POLARPHP_RUNTIME_SCRIPT_BUNDLE_H
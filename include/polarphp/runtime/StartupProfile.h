@@ -0,0 +1,102 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/02.
+
+#ifndef POLARPHP_RUNTIME_STARTUP_PROFILE_H
+#define POLARPHP_RUNTIME_STARTUP_PROFILE_H
+
+#include "polarphp/basic/adt/StringMap.h"
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/utils/Timer.h"
+
+#include <string>
+#include <vector>
+
+namespace polar {
+namespace utils {
+class RawOutStream;
+} // utils
+
+namespace runtime {
+
+using polar::basic::StringMap;
+using polar::basic::StringRef;
+using polar::utils::RawOutStream;
+using polar::utils::TimeRecord;
+
+///
+/// Time spent by the phases between main() and the first executed script.
+///
+/// Every phase belongs to a group, the report prints one TimerGroup table
+/// per group: the top level phases of the process, the phases of
+/// php_module_startup() and the startup function of every module. Nothing
+/// is recorded until the profile is enabled, the phases running before the
+/// command line is parsed are measured by hand and added afterwards.
+///
+class StartupProfile
+{
+public:
+   static constexpr const char *PROCESS_GROUP = "startup";
+   static constexpr const char *MODULE_STARTUP_GROUP = "module_startup";
+   static constexpr const char *MODULES_GROUP = "modules";
+
+   static StartupProfile &getInstance();
+
+   /// Start recording, the startup functions of the modules are timed
+   /// from now on.
+   void enable();
+   bool isEnabled() const;
+
+   void addRecord(StringRef group, StringRef name, const TimeRecord &time);
+
+   /// Print the tables of the recorded groups.
+   void print(RawOutStream &outStream);
+   /// Print the records as the members of a JSON object.
+   void printJSON(RawOutStream &outStream);
+
+private:
+   struct Group
+   {
+      std::string name;
+      std::string description;
+      StringMap<TimeRecord> records;
+   };
+
+   StartupProfile();
+   Group &getGroup(StringRef name);
+
+   bool m_enabled;
+   std::vector<Group> m_groups;
+};
+
+///
+/// Record the time spent between the construction and the destruction of
+/// the object as the phase \p name of \p group, when the profile is enabled.
+///
+class StartupPhase
+{
+public:
+   StartupPhase(StringRef group, StringRef name);
+   ~StartupPhase();
+
+private:
+   StartupPhase(const StartupPhase &) = delete;
+   StartupPhase &operator=(const StartupPhase &) = delete;
+
+   StringRef m_group;
+   StringRef m_name;
+   bool m_active;
+   TimeRecord m_startTime;
+};
+
+} // runtime
+} // polar
+
+#endif // POLARPHP_RUNTIME_STARTUP_PROFILE_H
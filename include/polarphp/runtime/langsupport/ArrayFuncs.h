@@ -95,6 +95,7 @@ PHP_FUNCTION(array_sum);
 PHP_FUNCTION(array_product);
 PHP_FUNCTION(array_filter);
 PHP_FUNCTION(array_map);
+PHP_FUNCTION(array_map_parallel);
 PHP_FUNCTION(array_key_exists);
 PHP_FUNCTION(array_chunk);
 PHP_FUNCTION(array_combine);
@@ -15,11 +15,15 @@
 #include "polarphp/runtime/RtDefs.h"
 #include "polarphp/runtime/internal/DepsZendVmHeaders.h"
 
+#include <memory>
+
 namespace polar {
 namespace runtime {
 
 #define CLASS_LOADER_G(v) retrieve_classloader_module_data().v
 
+class ClassMap;
+
 #define RT_REGISTER_STD_CLASS(class_name, obj_ctor) \
    register_std_class(&g_ ## class_name, const_cast<char *>(# class_name), obj_ctor, NULL);
 
@@ -52,6 +56,9 @@ struct ClassLoaderModuleData
    intptr_t     hashMaskHandlers;
    zend_string  *autoloadExtensions;
    HashTable    *autoloadFunctions;
+   /// registered class map, kept across the requests of the thread and
+   /// freed when the thread exits
+   std::unique_ptr<ClassMap> classMap;
 };
 
 using CreateObjectFuncType = zend_object* (*)(zend_class_entry *classType);
@@ -71,6 +78,7 @@ POLAR_DECL_EXPORT int add_classes(zend_class_entry *pce, zval *list, int sub, in
 POLAR_DECL_EXPORT _zend_string *php_object_hash(zval *obj);
 
 PHP_MINIT_FUNCTION(classloader);
+PHP_MSHUTDOWN_FUNCTION(classloader);
 PHP_RINIT_FUNCTION(classloader);
 PHP_RSHUTDOWN_FUNCTION(classloader);
 
@@ -79,6 +87,8 @@ PHP_FUNCTION(class_implements);
 PHP_FUNCTION(class_uses);
 PHP_FUNCTION(set_autoload_file_extensions);
 PHP_FUNCTION(default_class_loader);
+PHP_FUNCTION(build_class_map);
+PHP_FUNCTION(register_class_map);
 PHP_FUNCTION(retrieve_registered_class_loaders);
 PHP_FUNCTION(load_class);
 PHP_FUNCTION(register_class_loader);
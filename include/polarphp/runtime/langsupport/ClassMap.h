@@ -0,0 +1,135 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/02/20.
+
+#ifndef POLARPHP_RUNTIME_LANG_SUPPORT_CLASS_MAP_H
+#define POLARPHP_RUNTIME_LANG_SUPPORT_CLASS_MAP_H
+
+#include "polarphp/basic/adt/StringRef.h"
+#include "polarphp/utils/MemoryBuffer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace polar {
+namespace runtime {
+
+using polar::basic::StringRef;
+using polar::utils::MemoryBuffer;
+
+///
+/// Read only class name -> file index, kept in a file that is mapped as is.
+///
+/// The file is laid out as
+///   ClassMapHeader | ClassMapDir[dirCount] | ClassMapFile[fileCount]
+///   | ClassMapEntry[entryCount] | uint32_t buckets[bucketCount] | string pool
+/// every string in the pool is nul terminated. There is one entry per class
+/// declaration, the buckets are an open addressing table over the lower
+/// case class names of the first declaration of every class, a bucket holds
+/// the entry index plus one, zero marks an empty bucket.
+///
+/// Every scanned directory is recorded with its mtime and every indexed file
+/// with its mtime and size. build() only parses the files that changed and
+/// the directories whose mtime changed, files edited in place leave the
+/// mtime of their directory as is.
+///
+class ClassMap
+{
+public:
+   struct ClassMapHeader
+   {
+      char magic[4];
+      uint32_t version;
+      uint32_t classCount;
+      uint32_t entryCount;
+      uint32_t bucketCount;
+      uint32_t dirCount;
+      uint32_t fileCount;
+      uint32_t stringsSize;
+   };
+
+   struct ClassMapDir
+   {
+      int64_t mtime;
+      uint32_t pathOffset;
+      uint32_t pathLength;
+   };
+
+   struct ClassMapFile
+   {
+      int64_t mtime;
+      int64_t size;
+      uint32_t dirIndex;
+      uint32_t pathOffset;
+      uint32_t pathLength;
+      uint32_t reserved;
+   };
+
+   struct ClassMapEntry
+   {
+      uint32_t hash;
+      uint32_t fileIndex;
+      uint32_t nameOffset;
+      uint32_t nameLength;
+   };
+
+   /// Map the index stored in \p indexPath, returns nullptr if the file is
+   /// missing, truncated or not a valid index.
+   static std::unique_ptr<ClassMap> open(StringRef indexPath);
+
+   /// Scan \p roots for files ending with one of \p extensions and write the
+   /// index to \p indexPath, reusing the unchanged directories of the index
+   /// already stored there. Returns the number of indexed classes or -1.
+   static long build(StringRef indexPath, const std::vector<std::string> &roots,
+                     const std::vector<std::string> &extensions);
+
+   /// Collect the fully qualified names of the classes, interfaces and
+   /// traits declared in \p source.
+   static void extractClassNames(StringRef source, std::vector<std::string> &names);
+
+   /// Find the file declaring the class \p lcClassName, which must be lower
+   /// case and without leading backslash.
+   bool lookup(StringRef lcClassName, StringRef &filename) const;
+
+   /// Whether one of the indexed directories or files changed since the
+   /// index was built.
+   bool isStale() const;
+
+   uint32_t getClassCount() const;
+   uint32_t getEntryCount() const;
+   uint32_t getDirCount() const;
+   uint32_t getFileCount() const;
+   StringRef getDirPath(uint32_t index) const;
+   int64_t getDirMtime(uint32_t index) const;
+   const ClassMapFile &getFile(uint32_t index) const;
+   StringRef getFilePath(uint32_t index) const;
+   const ClassMapEntry &getEntry(uint32_t index) const;
+   StringRef getString(uint32_t offset, uint32_t length) const;
+   StringRef getIndexPath() const;
+
+private:
+   ClassMap(std::unique_ptr<MemoryBuffer> buffer, StringRef indexPath);
+   bool isValid() const;
+
+   std::unique_ptr<MemoryBuffer> m_buffer;
+   std::string m_indexPath;
+   const ClassMapHeader *m_header;
+   const ClassMapDir *m_dirs;
+   const ClassMapFile *m_files;
+   const ClassMapEntry *m_entries;
+   const uint32_t *m_buckets;
+   const char *m_strings;
+};
+
+} // runtime
+} // polar
+
+#endif // POLARPHP_RUNTIME_LANG_SUPPORT_CLASS_MAP_H
@@ -28,8 +28,10 @@ struct RuntimeModuleData
    HashTable *userShutdownFunctionNames = nullptr;
    zend_fcall_info arrayWalkFci;
    zend_fcall_info_cache arrayWalkFciCache;
+   zend_fcall_prepared arrayWalkPrepared;
    zend_fcall_info userCompareFci;
    zend_fcall_info_cache userCompareFciCache;
+   zend_fcall_prepared userComparePrepared;
    zend_llist *userTickFunctions = nullptr;
    zend_class_entry *incompleteClass;
 
@@ -0,0 +1,47 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#ifndef POLARPHP_RUNTIME_LANG_SUPPORT_LAZY_RANGE_H
+#define POLARPHP_RUNTIME_LANG_SUPPORT_LAZY_RANGE_H
+
+#include "polarphp/runtime/RtDefs.h"
+
+namespace polar {
+namespace runtime {
+
+///
+/// LazyRange stands in for the packed array of range() and array_fill()
+/// when the call result goes straight into a foreach, the elements are
+/// computed by the iterator instead of being stored in a zend_array.
+///
+/// Nothing but the FE_RESET_R of the caller ever sees the object, so the
+/// array semantics of every other use are untouched.
+///
+PHP_MINIT_FUNCTION(lazyrange);
+
+extern POLAR_DECL_EXPORT zend_class_entry *g_LazyRange;
+
+/// whether the result of the internal call \p execute_data is only the
+/// operand of a by value foreach in the calling user function
+bool lazy_range_consumed_by_foreach(zend_execute_data *execute_data);
+
+/// the values first, first + step, ... with the keys 0 .. size - 1, the step
+/// is applied with the wrap around arithmetic of the eager range()
+void lazy_range_init(zval *object, zend_long first, zend_ulong step, uint32_t size);
+
+/// \p size copies of \p value with the keys firstKey .. firstKey + size - 1,
+/// or firstKey, 0 .. size - 2 when firstKey is negative
+void lazy_fill_init(zval *object, zend_long firstKey, uint32_t size, zval *value);
+
+} // runtime
+} // polar
+
+#endif // POLARPHP_RUNTIME_LANG_SUPPORT_LAZY_RANGE_H
@@ -0,0 +1,34 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#ifndef POLARPHP_RUNTIME_LANG_SUPPORT_LAZY_SEQUENCE_H
+#define POLARPHP_RUNTIME_LANG_SUPPORT_LAZY_SEQUENCE_H
+
+#include "polarphp/runtime/RtDefs.h"
+
+namespace polar {
+namespace runtime {
+
+///
+/// LazySequence wraps an array or a Traversable with a pipeline of map,
+/// filter, take and chunk stages. Adding a stage returns a new sequence,
+/// nothing runs until a terminal operation (toArray, sum, reduce, count)
+/// or a foreach pulls the elements, one at a time through every stage, so
+/// no intermediate array is built.
+///
+PHP_MINIT_FUNCTION(lazysequence);
+
+extern POLAR_DECL_EXPORT zend_class_entry *g_LazySequence;
+
+} // runtime
+} // polar
+
+#endif // POLARPHP_RUNTIME_LANG_SUPPORT_LAZY_SEQUENCE_H
@@ -24,7 +24,9 @@ class AbstractIterator;
 class IteratorBridge
 {
 public:
-   IteratorBridge(zval *object, AbstractIterator *iterator);
+   /// an owned iterator, see Traversable::createsIterator(), is destroyed
+   /// with the bridge
+   IteratorBridge(zval *object, AbstractIterator *iterator, bool ownsIterator = false);
    ~IteratorBridge();
    zend_object_iterator *getZendIterator();
    static zend_object_iterator_funcs *getIteratorFuncs();
@@ -47,6 +49,7 @@ private:
 private:
    zend_object_iterator m_iterator;
    AbstractIterator *m_userspaceIterator;
+   bool m_ownsIterator;
    Variant m_current;
 };
 
@@ -151,6 +151,22 @@ public:
 
    Module &setInfoHandler(const Callback &callback);
 
+   /**
+   * Defer the registration of the functions and classes to their first use
+   *
+   * By default every function and class of the module is put into the engine
+   * tables when the module starts, which dominates the startup time of the
+   * modules binding thousands of them. A lazy module only records their names,
+   * the engine registers a function or a class the first time a script looks
+   * it up. Constants and ini entries are still registered at startup, the
+   * functions and classes not used yet are not listed by get_defined_functions()
+   * and get_declared_classes().
+   *
+   * @param lazy Whether the registration is deferred
+   * @return Module Same object to allow chaining
+   */
+   Module &setLazyRegistration(bool lazy = true);
+
    /**
    * Retrieve the module pointer
    *
@@ -16,6 +16,8 @@
 #include "polarphp/vm/lang/Argument.h"
 
 #include <list>
+#include <memory>
+#include <string>
 
 namespace polar {
 namespace vmapi {
@@ -62,6 +64,12 @@ public:
    static int processRequestShutdown(SHUTDOWN_FUNC_ARGS);
    static int processMismatch(INIT_FUNC_ARGS);
    static void processModuleInfo(ZEND_MODULE_INFO_FUNC_ARGS);
+   static int processLazyFunction(zend_string *lcname);
+   static int processLazyClass(zend_string *lcname);
+   void registerLazyClasses(const std::string &ns, const std::list<std::shared_ptr<AbstractClass>> &classes);
+   void registerLazyNamespace(const std::string &ns, Namespace &target, int moduleNumber);
+   void unregisterLazyEntries();
+   static zend_class_entry *materializeClass(ModulePrivate *module, const std::string &ns, AbstractClass &cls);
    // properties
 
    Module *m_apiPtr;
@@ -72,6 +80,8 @@ public:
    Callback m_minfoHandler;
    zend_module_entry m_entry;
    bool m_locked = false;
+   bool m_lazy = false;
+   std::unique_ptr<zend_function_entry[]> m_lazyFunctionEntries;
    std::list<std::shared_ptr<Ini>> m_iniEntries;
    std::unique_ptr<zend_ini_entry_def[]> m_zendIniDefs = nullptr;
    std::list<std::shared_ptr<Function>> m_functions;
@@ -23,6 +23,13 @@ class VMAPI_DECL_EXPORT Traversable
 {
 public:
    virtual AbstractIterator *getIterator() = 0;
+   /// Whether getIterator() allocates a new iterator with new for every
+   /// foreach, which then destroys it once done. By default the iterator
+   /// belongs to the object.
+   virtual bool createsIterator() const
+   {
+      return false;
+   }
    virtual ~Traversable() = default;
 };
 
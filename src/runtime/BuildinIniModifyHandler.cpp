@@ -425,5 +425,15 @@ POLAR_INI_MH(set_log_filter_handler)
    return FAILURE;
 }
 
+POLAR_INI_MH(update_realpath_cache_shared_size_handler)
+{
+   /// the table is mapped once before the workers fork, every thread
+   /// re-applies the startup value so this must stay idempotent
+   if (stage != POLAR_INI_STAGE_STARTUP) {
+      return FAILURE;
+   }
+   return realpath_cache_shared_startup(zend_atol(ZSTR_VAL(new_value), ZSTR_LEN(new_value)));
+}
+
 } // runtime
 } // polar
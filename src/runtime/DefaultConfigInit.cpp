@@ -68,6 +68,7 @@ POLAR_INI_BEGIN()
    POLAR_INI_ENTRY("max_file_uploads",              "20",                   POLAR_INI_SYSTEM|POLAR_INI_PERDIR, nullptr)
    STD_ZEND_INI_ENTRY("realpath_cache_size",        "4096K",                POLAR_INI_SYSTEM,                  OnUpdateLong,                      realpath_cache_size_limit, virtual_cwd_globals,   cwd_globals)
    STD_ZEND_INI_ENTRY("realpath_cache_ttl",         "120",                  POLAR_INI_SYSTEM,                  OnUpdateLong,                      realpath_cache_ttl,        virtual_cwd_globals,   cwd_globals)
+   POLAR_INI_ENTRY("realpath_cache_shared_size",    "0",                    POLAR_INI_SYSTEM,                  update_realpath_cache_shared_size_handler)
 
    POLAR_STD_INI_ENTRY("user_ini.filename",         ".user.ini",            POLAR_INI_SYSTEM,                  update_string_handler,             userIniFilename,           ExecEnvInfo,           sg_execEnvInfo)
    POLAR_STD_INI_ENTRY("user_ini.cache_ttl",        "300",                  POLAR_INI_SYSTEM,                  update_long_handler,               userIniCacheTtl,           ExecEnvInfo,           sg_execEnvInfo)
@@ -20,8 +20,14 @@
 #include "polarphp/runtime/Output.h"
 #include "polarphp/runtime/Utils.h"
 #include "polarphp/runtime/Ini.h"
+#include "polarphp/runtime/ScriptBundle.h"
+#include "polarphp/runtime/StartupProfile.h"
+#include "polarphp/utils/MemoryBuffer.h"
+#include "polarphp/utils/Process.h"
 
 #include <filesystem>
+#include <mutex>
+#include <unordered_map>
 #include <cstdio>
 #include <cstring>
 #include <sys/stat.h>
@@ -82,6 +88,9 @@ namespace polar {
 namespace runtime {
 
 namespace fs = std::filesystem;
+using polar::utils::MemoryBuffer;
+using polar::utils::WritableMemoryBuffer;
+using polar::sys::Process;
 
 extern bool sg_moduleInitialized;
 extern bool sg_moduleStartup;
@@ -148,26 +157,39 @@ bool ExecEnv::bootup()
    /// 20000419
 #endif
 #endif
-   tsrm_startup(1, 1, 0, nullptr);
-   (void)ts_resource(0);
-   ZEND_TSRMLS_CACHE_UPDATE();
-   zend_signal_startup();
-   if (!polar::runtime::php_module_startup()) {
-      // there is no way to see if we must call zend_ini_deactivate()
-      // since we cannot check if EG(ini_directives) has been initialised
-      // because the executor's constructor does not set initialize it.
-      // Apart from that there seems no need for zend_ini_deactivate() yet.
-      // So we goto out_err.
-      return false;
+   {
+      StartupPhase phase(StartupProfile::PROCESS_GROUP, "tsrm_startup");
+      tsrm_startup(1, 1, 0, nullptr);
+      /// the compiler and executor globals are reached through fixed offsets
+      /// from the thread's resource block, see CG() and EG()
+      tsrm_reserve(TSRM_ALIGNED_SIZE(sizeof(zend_compiler_globals)) +
+                   TSRM_ALIGNED_SIZE(sizeof(zend_executor_globals)));
+      (void)ts_resource(0);
+      ZEND_TSRMLS_CACHE_UPDATE();
+      zend_signal_startup();
    }
-   m_moduleStarted = true;
-   polar_try {
-      CG(in_compilation) = 0; /* not initialized but needed for several options */
-      if (!php_exec_env_startup()) {
-         std::cerr << "Could not startup." << std::endl;
+   {
+      StartupPhase phase(StartupProfile::PROCESS_GROUP, "module_startup");
+      if (!polar::runtime::php_module_startup()) {
+         // there is no way to see if we must call zend_ini_deactivate()
+         // since we cannot check if EG(ini_directives) has been initialised
+         // because the executor's constructor does not set initialize it.
+         // Apart from that there seems no need for zend_ini_deactivate() yet.
+         // So we goto out_err.
          return false;
       }
-   } polar_end_try;
+   }
+   m_moduleStarted = true;
+   {
+      StartupPhase phase(StartupProfile::PROCESS_GROUP, "exec_env_startup");
+      polar_try {
+         CG(in_compilation) = 0; /* not initialized but needed for several options */
+         if (!php_exec_env_startup()) {
+            std::cerr << "Could not startup." << std::endl;
+            return false;
+         }
+      } polar_end_try;
+   }
    m_execEnvStarted = true;
    m_runtimeInfo.duringExecEnvStartup = false;
    return true;
@@ -293,7 +315,8 @@ bool ExecEnv::execScript(StringRef filename, int &exitStatus)
 {
    bool useStdin = false;
    if (!filename.empty()) {
-      if (!fs::exists(filename.getStr())) {
+      ScriptBundle *bundle = ScriptBundle::getMounted();
+      if (!fs::exists(filename.getStr()) && !(bundle && bundle->isFile(filename))) {
          std::cerr << "script: " << filename.getData() << " is not exist" << std::endl;
          exitStatus = 1;
          return false;
@@ -308,7 +331,8 @@ bool ExecEnv::execScript(StringRef filename, int &exitStatus)
    polar_try {
       CG(in_compilation) = 0; /* not initialized but needed for several options */
       if (!useStdin) {
-         if (!seek_file_begin(&fileHandle, filename.getData(), &lineno)) {
+         if (!open_mapped_script(&fileHandle, filename.getData(), &lineno) &&
+             !seek_file_begin(&fileHandle, filename.getData(), &lineno)) {
             std::cerr << "seek_file_begin error: " << strerror(errno) << std::endl;
             exitStatus = 1;
             return false;
@@ -325,10 +349,10 @@ bool ExecEnv::execScript(StringRef filename, int &exitStatus)
          /// is also accessible.
          fileHandle.filename = PHP_STDIN_FILENAME_MARK;
          fileHandle.handle.fp = stdin;
+         fileHandle.type = ZEND_HANDLE_FP;
+         fileHandle.opened_path = nullptr;
+         fileHandle.free_filename = 0;
       }
-      fileHandle.type = ZEND_HANDLE_FP;
-      fileHandle.opened_path = nullptr;
-      fileHandle.free_filename = 0;
       if (!translatedPath.empty()) {
          m_runtimeInfo.entryScriptFilename = translatedPath;
       } else {
@@ -1144,7 +1168,110 @@ POLAR_DECL_EXPORT char *bootstrap_getenv(char *, size_t)
 ///
 /// need review for memory leak, we remove stream, so we need check the result
 ///
-zend_string *php_resolve_path(const char *filename, size_t filenameLen, const char *path)
+namespace {
+
+///
+/// process wide cache of the include path walk done by php_resolve_path(),
+/// shared by every thread and request. Both hits and misses are recorded,
+/// an entry lives for realpath_cache_ttl seconds and a hit is dropped as
+/// soon as the stat of its resolved file no longer matches.
+///
+class ResolvePathCache
+{
+public:
+   struct Entry
+   {
+      std::string resolvedPath;
+      time_t expires;
+      dev_t device;
+      ino_t inode;
+   };
+
+   /// returns false when the key has to be resolved again, a cached miss
+   /// leaves resolvedPath empty
+   bool lookup(const std::string &key, time_t now, std::string &resolvedPath)
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto iter = m_entries.find(key);
+      if (iter == m_entries.end()) {
+         ++m_stats.misses;
+         return false;
+      }
+      Entry &entry = iter->second;
+      if (entry.expires <= now) {
+         m_entries.erase(iter);
+         ++m_stats.misses;
+         return false;
+      }
+      if (entry.resolvedPath.empty()) {
+         ++m_stats.negativeHits;
+         resolvedPath.clear();
+         return true;
+      }
+      zend_stat_t info;
+      if (VCWD_STAT(entry.resolvedPath.c_str(), &info) != 0 ||
+          info.st_dev != entry.device || info.st_ino != entry.inode) {
+         m_entries.erase(iter);
+         ++m_stats.invalidations;
+         ++m_stats.misses;
+         return false;
+      }
+      ++m_stats.hits;
+      resolvedPath = entry.resolvedPath;
+      return true;
+   }
+
+   void store(const std::string &key, time_t expires, const char *resolvedPath)
+   {
+      Entry entry;
+      entry.expires = expires;
+      entry.device = 0;
+      entry.inode = 0;
+      if (resolvedPath) {
+         zend_stat_t info;
+         if (VCWD_STAT(resolvedPath, &info) != 0) {
+            return;
+         }
+         entry.resolvedPath = resolvedPath;
+         entry.device = info.st_dev;
+         entry.inode = info.st_ino;
+      }
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_entries.size() >= MAX_ENTRIES) {
+         m_entries.clear();
+      }
+      m_entries[key] = std::move(entry);
+   }
+
+   void clear()
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_entries.clear();
+   }
+
+   ResolvePathCacheStats getStats()
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      ResolvePathCacheStats stats = m_stats;
+      stats.entries = m_entries.size();
+      return stats;
+   }
+
+private:
+   static constexpr size_t MAX_ENTRIES = 4096;
+   std::mutex m_mutex;
+   std::unordered_map<std::string, Entry> m_entries;
+   ResolvePathCacheStats m_stats = {0, 0, 0, 0, 0};
+};
+
+ResolvePathCache &retrieve_resolve_path_cache()
+{
+   static ResolvePathCache cache;
+   return cache;
+}
+
+zend_string *resolve_in_include_path(const char *filename, size_t filenameLen, const char *path,
+                                      const char *execFname, size_t execFnameLength)
 {
    char resolvedPath[MAXPATHLEN];
    char trypath[MAXPATHLEN];
@@ -1152,31 +1279,6 @@ zend_string *php_resolve_path(const char *filename, size_t filenameLen, const ch
    const char *end;
    const char *p;
    const char *actualPath;
-   zend_string *execFilename;
-   if (!filename || CHECK_NULL_PATH(filename, filenameLen)) {
-      return nullptr;
-   }
-   /// polarphp does not handle stream protocol
-   for (p = filename; isalnum((int)*p) || *p == '+' || *p == '-' || *p == '.'; p++);
-   if ((*filename == '.' &&
-        (IS_SLASH(filename[1]) ||
-         ((filename[1] == '.') && IS_SLASH(filename[2])))) ||
-       IS_ABSOLUTE_PATH(filename, filenameLen) ||
-    #ifdef POLAR_OS_WIN32
-       /* This should count as an absolute local path as well, however
-                                                                                                                                                                                                                        IS_ABSOLUTE_PATH doesn't care about this path form till now. It
-                                                                                                                                                                                                                        might be a big thing to extend, thus just a local handling for
-                                                                                                                                                                                                                        now. */
-       filenameLen >=2 && IS_SLASH(filename[0]) && !IS_SLASH(filename[1]) ||
-    #endif
-       !path ||
-       !*path) {
-      if (tsrm_realpath(filename, resolvedPath)) {
-         return zend_string_init(resolvedPath, strlen(resolvedPath), 0);
-      } else {
-         return nullptr;
-      }
-   }
    ptr = path;
    while (ptr && *ptr) {
       /// polarphp does not use stream
@@ -1209,30 +1311,174 @@ zend_string *php_resolve_path(const char *filename, size_t filenameLen, const ch
 
    /* check in calling scripts' current working directory as a fall back case
        */
+   if (execFname &&
+       execFnameLength > 0 &&
+       filenameLen < (MAXPATHLEN - 2) &&
+       execFnameLength + 1 + filenameLen + 1 < MAXPATHLEN) {
+      memcpy(trypath, execFname, execFnameLength + 1);
+      memcpy(trypath+execFnameLength + 1, filename, filenameLen+1);
+      actualPath = trypath;
+      /* Check for stream wrapper */
+      for (p = trypath; isalnum((int)*p) || *p == '+' || *p == '-' || *p == '.'; p++);
+      if (tsrm_realpath(actualPath, resolvedPath)) {
+         return zend_string_init(resolvedPath, strlen(resolvedPath), 0);
+      }
+   }
+   return nullptr;
+}
+
+} // anonymous namespace
+
+zend_string *php_resolve_path(const char *filename, size_t filenameLen, const char *path)
+{
+   char resolvedPath[MAXPATHLEN];
+   const char *p;
+   zend_string *execFilename;
+   const char *execFname = nullptr;
+   size_t execFnameLength = 0;
+   if (!filename || CHECK_NULL_PATH(filename, filenameLen)) {
+      return nullptr;
+   }
+   /// polarphp does not handle stream protocol
+   for (p = filename; isalnum((int)*p) || *p == '+' || *p == '-' || *p == '.'; p++);
+   if ((*filename == '.' &&
+        (IS_SLASH(filename[1]) ||
+         ((filename[1] == '.') && IS_SLASH(filename[2])))) ||
+       IS_ABSOLUTE_PATH(filename, filenameLen) ||
+    #ifdef POLAR_OS_WIN32
+       /* This should count as an absolute local path as well, however
+                                                                                                                                                                                                                        IS_ABSOLUTE_PATH doesn't care about this path form till now. It
+                                                                                                                                                                                                                        might be a big thing to extend, thus just a local handling for
+                                                                                                                                                                                                                        now. */
+       filenameLen >=2 && IS_SLASH(filename[0]) && !IS_SLASH(filename[1]) ||
+    #endif
+       !path ||
+       !*path) {
+      if (tsrm_realpath(filename, resolvedPath)) {
+         return zend_string_init(resolvedPath, strlen(resolvedPath), 0);
+      } else {
+         return nullptr;
+      }
+   }
    if (zend_is_executing() &&
        (execFilename = zend_get_executed_filename_ex()) != nullptr) {
-      const char *exec_fname = ZSTR_VAL(execFilename);
-      size_t execFnameLength = ZSTR_LEN(execFilename);
-      while ((--execFnameLength < SIZE_MAX) && !IS_SLASH(exec_fname[execFnameLength]));
-      if (execFnameLength > 0 &&
-          filenameLen < (MAXPATHLEN - 2) &&
-          execFnameLength + 1 + filenameLen + 1 < MAXPATHLEN) {
-         memcpy(trypath, exec_fname, execFnameLength + 1);
-         memcpy(trypath+execFnameLength + 1, filename, filenameLen+1);
-         actualPath = trypath;
-         /* Check for stream wrapper */
-         for (p = trypath; isalnum((int)*p) || *p == '+' || *p == '-' || *p == '.'; p++);
-         if (tsrm_realpath(actualPath, resolvedPath)) {
-            return zend_string_init(resolvedPath, strlen(resolvedPath), 0);
+      execFname = ZSTR_VAL(execFilename);
+      execFnameLength = ZSTR_LEN(execFilename);
+      while ((--execFnameLength < SIZE_MAX) && !IS_SLASH(execFname[execFnameLength]));
+      if (execFnameLength == SIZE_MAX) {
+         execFnameLength = 0;
+      }
+   }
+   /// the realpath cache being disabled (open_basedir) disables this one too
+   if (CWDG(realpath_cache_size_limit) == 0 || CWDG(realpath_cache_ttl) <= 0) {
+      return resolve_in_include_path(filename, filenameLen, path, execFname, execFnameLength);
+   }
+   char cwd[MAXPATHLEN];
+   if (!VCWD_GETCWD(cwd, MAXPATHLEN)) {
+      cwd[0] = '\0';
+   }
+   std::string key;
+   key.reserve(filenameLen + strlen(path) + execFnameLength + strlen(cwd) + 3);
+   key.append(filename, filenameLen).push_back('\0');
+   key.append(path).push_back('\0');
+   key.append(execFname ? execFname : "", execFnameLength).push_back('\0');
+   key.append(cwd);
+   ResolvePathCache &cache = retrieve_resolve_path_cache();
+   time_t now = time(nullptr);
+   std::string cached;
+   if (cache.lookup(key, now, cached)) {
+      return cached.empty() ? nullptr : zend_string_init(cached.c_str(), cached.size(), 0);
+   }
+   zend_string *resolved = resolve_in_include_path(filename, filenameLen, path, execFname, execFnameLength);
+   cache.store(key, now + CWDG(realpath_cache_ttl), resolved ? ZSTR_VAL(resolved) : nullptr);
+   return resolved;
+}
+
+ResolvePathCacheStats php_resolve_path_cache_stats()
+{
+   return retrieve_resolve_path_cache().getStats();
+}
+
+void php_resolve_path_cache_clear()
+{
+   retrieve_resolve_path_cache().clear();
+}
+
+///
+/// proto array resolve_path_cache_status()
+/// Return the counters of the include path resolution cache
+///
+PHP_FUNCTION(resolve_path_cache_status)
+{
+   if (zend_parse_parameters_none() == FAILURE) {
+      return;
+   }
+   ResolvePathCacheStats stats = php_resolve_path_cache_stats();
+   array_init_size(return_value, 6);
+   add_assoc_bool_ex(return_value, "enabled", sizeof("enabled")-1,
+                     CWDG(realpath_cache_size_limit) != 0 && CWDG(realpath_cache_ttl) > 0);
+   add_assoc_long_ex(return_value, "entries", sizeof("entries")-1, (zend_long)stats.entries);
+   add_assoc_long_ex(return_value, "hits", sizeof("hits")-1, (zend_long)stats.hits);
+   add_assoc_long_ex(return_value, "negative_hits", sizeof("negative_hits")-1, (zend_long)stats.negativeHits);
+   add_assoc_long_ex(return_value, "misses", sizeof("misses")-1, (zend_long)stats.misses);
+   add_assoc_long_ex(return_value, "invalidations", sizeof("invalidations")-1, (zend_long)stats.invalidations);
+}
+
+namespace {
+
+/// resolve \p filename the way php_resolve_path() does, but against the
+/// index of the mounted bundle, "." in the include path is its mount point
+zend_string *resolve_bundled_path(ScriptBundle *bundle, StringRef filename, StringRef includePath)
+{
+   if (filename.empty()) {
+      return nullptr;
+   }
+   std::vector<std::string> candidates;
+   if (IS_ABSOLUTE_PATH(filename.getData(), filename.size()) ||
+       filename.startsWith("./") || filename.startsWith("../")) {
+      candidates.push_back(filename.getStr());
+   } else {
+      while (!includePath.empty()) {
+         std::pair<StringRef, StringRef> parts = includePath.split(DEFAULT_DIR_SEPARATOR);
+         if (parts.first == "." || parts.first.empty()) {
+            candidates.push_back((bundle->getMountPoint() + "/" + filename).getStr());
+         } else {
+            candidates.push_back((parts.first + "/" + filename).getStr());
+         }
+         includePath = parts.second;
+      }
+      /// check in the calling scripts' directory
+      if (zend_is_executing()) {
+         StringRef executedFile(zend_get_executed_filename());
+         size_t slash = executedFile.rfind('/');
+         if (slash != StringRef::npos) {
+            candidates.push_back((executedFile.substr(0, slash) + "/" + filename).getStr());
+         }
+      }
+   }
+   for (std::string &candidate : candidates) {
+      if (bundle->isFile(candidate)) {
+         if (!IS_ABSOLUTE_PATH(candidate.c_str(), candidate.size())) {
+            candidate = bundle->getMountPoint().getStr() + "/" + candidate;
          }
+         return zend_string_init(candidate.c_str(), candidate.size(), 0);
       }
    }
    return nullptr;
 }
 
+} // anonymous namespace
+
 zend_string *php_resolve_path_for_zend(const char *filename, size_t filenameLen)
 {
    ExecEnvInfo &execEnvInfo = retrieve_global_execenv_runtime_info();
+   if (ScriptBundle *bundle = ScriptBundle::getMounted()) {
+      zend_string *resolved = resolve_bundled_path(bundle, StringRef(filename, filenameLen),
+                                                   execEnvInfo.includePath);
+      if (resolved) {
+         return resolved;
+      }
+   }
    return php_resolve_path(filename, filenameLen, execEnvInfo.includePath.c_str());
 }
 
@@ -1268,6 +1514,98 @@ bool seek_file_begin(zend_file_handle *fileHandle, const char *scriptFile, int *
    return true;
 }
 
+namespace {
+
+/// closer of the handles set up by open_mapped_script(), the stream handle
+/// is the buffer owning the source text
+void mapped_script_closer(void *handle)
+{
+   delete static_cast<MemoryBuffer *>(handle);
+}
+
+} // anonymous namespace
+
+bool open_mapped_script(zend_file_handle *fileHandle, const char *scriptFile, int *lineno)
+{
+   StringRef bundled;
+   std::unique_ptr<MemoryBuffer> buffer;
+   ScriptBundle *bundle = ScriptBundle::getMounted();
+   if (bundle && bundle->getSource(scriptFile, bundled)) {
+      /// the bundle keeps the source padded and alive, the handle only owns
+      /// this view of it
+      buffer = MemoryBuffer::getMemBuffer(bundled, scriptFile, false);
+   } else {
+      auto bufferOrError = MemoryBuffer::getFile(scriptFile, -1, false, false);
+      if (!bufferOrError) {
+         return false;
+      }
+      buffer = std::move(bufferOrError.get());
+   }
+   size_t size = buffer->getBufferSize();
+   size_t tail = size % Process::getPageSize();
+   /// the scanner reads up to ZEND_MMAP_AHEAD bytes past the end of the
+   /// source, a mapping is used as is when the zero filled rest of its last
+   /// page covers them, anything else is copied once into a padded buffer
+   if (bundled.empty() &&
+       (buffer->getBufferKind() != MemoryBuffer::BufferKind::MemoryBuffer_MMap ||
+        tail == 0 || tail > Process::getPageSize() - ZEND_MMAP_AHEAD)) {
+      std::unique_ptr<WritableMemoryBuffer> padded =
+            WritableMemoryBuffer::getNewMemBuffer(size + ZEND_MMAP_AHEAD, scriptFile);
+      if (!padded) {
+         return false;
+      }
+      std::memcpy(padded->getBufferStart(), buffer->getBufferStart(), size);
+      buffer = std::move(padded);
+   }
+   const char *source = buffer->getBufferStart();
+   size_t offset = 0;
+   if (lineno) {
+      *lineno = 1;
+      /* #!php support */
+      if (size >= 2 && source[0] == '#' && source[1] == '!') {
+         offset = 2;
+         while (offset < size && source[offset] != '\n' && source[offset] != '\r') {
+            ++offset;
+         }
+         /* handle situations where line is terminated by \r\n */
+         if (offset < size && source[offset] == '\r') {
+            ++offset;
+         }
+         if (offset < size && source[offset] == '\n') {
+            ++offset;
+         }
+         *lineno = 2;
+      }
+   }
+   zend_stream &stream = fileHandle->handle.stream;
+   std::memset(&stream, 0, sizeof(stream));
+   stream.mmap.buf = const_cast<char *>(source) + offset;
+   stream.mmap.len = size - offset;
+   stream.closer = mapped_script_closer;
+   stream.handle = buffer.release();
+   fileHandle->type = ZEND_HANDLE_MAPPED;
+   fileHandle->filename = scriptFile;
+   fileHandle->opened_path = nullptr;
+   fileHandle->free_filename = 0;
+   return true;
+}
+
+int php_stream_open_for_zend(const char *filename, zend_file_handle *handle)
+{
+   if (open_mapped_script(handle, filename, nullptr)) {
+      handle->opened_path = zend_string_init(filename, strlen(filename), 0);
+      return SUCCESS;
+   }
+   /// not a regular file, let the engine read it through stdio
+   handle->type = ZEND_HANDLE_FP;
+   handle->opened_path = nullptr;
+   handle->handle.fp = zend_fopen(filename, &handle->opened_path);
+   handle->filename = filename;
+   handle->free_filename = 0;
+   std::memset(&handle->handle.stream.mmap, 0, sizeof(zend_mmap));
+   return handle->handle.fp ? SUCCESS : FAILURE;
+}
+
 bool php_hash_environment()
 {
    //   memset(PG(http_globals), 0, sizeof(PG(http_globals)));
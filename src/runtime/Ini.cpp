@@ -12,6 +12,8 @@
 #include "polarphp/global/SystemDetection.h"
 
 #include "polarphp/runtime/Ini.h"
+#include "polarphp/runtime/IniCache.h"
+#include "polarphp/runtime/IniPerDirTrie.h"
 #include "polarphp/runtime/Output.h"
 #include "polarphp/runtime/ExecEnv.h"
 #include "polarphp/runtime/internal/DepsZendVmHeaders.h"
@@ -27,6 +29,10 @@
 #include <dirent.h>
 #endif
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #ifdef POLAR_OS_WIN32
 #define TRANSLATE_SLASHES_LOWER(path) \
 { \
@@ -57,6 +63,8 @@ char *sg_phpIniOpenedPath = nullptr;
 static php_extension_lists sg_extensionLists;
 char *sg_phpIniScannedPath = nullptr;
 char *sg_phpIniScannedFiles = nullptr;
+static std::vector<std::string> sg_perDirSections;
+static std::unique_ptr<polar::runtime::IniPerDirTrie> sg_perDirTrie;
 
 namespace polar {
 namespace runtime {
@@ -227,6 +235,7 @@ static void php_ini_parser_callback(zval *arg1, zval *arg2, zval *arg3, int call
 
       char *key = nullptr;
       size_t key_len;
+      bool is_path_section = false;
 
       /* PATH sections */
       if (!zend_binary_strncasecmp(Z_STRVAL_P(arg1), Z_STRLEN_P(arg1), "PATH", sizeof("PATH") - 1, sizeof("PATH") - 1)) {
@@ -235,6 +244,7 @@ static void php_ini_parser_callback(zval *arg1, zval *arg2, zval *arg3, int call
          key_len = Z_STRLEN_P(arg1) - sizeof("PATH") + 1;
          sg_isSpecialSection = true;
          sg_hasPerDirConfig = 1;
+         is_path_section = true;
 
          /* make the path lowercase on Windows, for case insensitivity. Does nothing for other platforms */
          TRANSLATE_SLASHES_LOWER(key);
@@ -268,6 +278,10 @@ static void php_ini_parser_callback(zval *arg1, zval *arg2, zval *arg3, int call
             key++;
             key_len--;
          }
+         /* Remember the PATH sections for the per-dir lookup trie */
+         if (is_path_section && target_hash == &sg_configurationHash) {
+            sg_perDirSections.emplace_back(key, key_len);
+         }
          /* Search for existing entry and if it does not exist create one */
          if ((entry = zend_hash_str_find(target_hash, key, key_len)) == nullptr) {
             zval section_arr;
@@ -355,6 +369,24 @@ static void php_load_zend_extension_callback(void *arg)
 static void php_load_zend_extension_callback(void *arg) { }
 #endif
 
+///
+/// Compile the PATH sections into a trie of directories, a request path is
+/// then resolved by a single walk applying the settings of the deepest
+/// configured directory.
+///
+static void php_build_per_dir_trie()
+{
+   sg_perDirTrie.reset(new IniPerDirTrie);
+   for (const std::string &key : sg_perDirSections) {
+      zval *section = zend_hash_str_find(&sg_configurationHash, key.c_str(), key.size());
+      if (section && Z_TYPE_P(section) == IS_ARRAY) {
+         sg_perDirTrie->addSection(key, Z_ARRVAL_P(section));
+      }
+   }
+   sg_perDirSections.clear();
+   sg_perDirTrie->build();
+}
+
 ///
 /// need review for memory leak
 ///
@@ -375,6 +407,13 @@ bool php_init_config()
    zend_llist_init(&sg_extensionLists.engine, sizeof(char *), reinterpret_cast<llist_dtor_func_t>(free_estring), 1);
    zend_llist_init(&sg_extensionLists.functions, sizeof(char *), reinterpret_cast<llist_dtor_func_t>(free_estring), 1);
    openBaseDir = execEnvInfo.openBaseDir;
+   /// the cache must be known before any ini file is read, it comes from
+   /// the command line or the environment
+   StringRef iniCacheFile = execEnvInfo.iniCacheFile;
+   if (iniCacheFile.empty() && getenv("POLARPHP_INI_CACHE")) {
+      iniCacheFile = getenv("POLARPHP_INI_CACHE");
+   }
+   IniCache iniCache(iniCacheFile);
    std::string &phpIniexecPathOverride = execEnvInfo.phpIniPathOverride;
    if (!phpIniexecPathOverride.empty()) {
       phpIniFileName = phpIniexecPathOverride;
@@ -556,7 +595,7 @@ bool php_init_config()
    if (fh.handle.fp) {
       fh.type = ZEND_HANDLE_FP;
       RESET_ACTIVE_INI_HASH();
-      zend_parse_ini_file(&fh, 1, ZEND_INI_SCANNER_NORMAL, (zend_ini_parser_cb_t) php_ini_parser_callback, &sg_configurationHash);
+      iniCache.parseFile(&fh, (zend_ini_parser_cb_t) php_ini_parser_callback, &sg_configurationHash);
 
       {
          zval tmp;
@@ -630,7 +669,7 @@ bool php_init_config()
                         fh2.filename = iniFile;
                         fh2.type = ZEND_HANDLE_FP;
 
-                        if (zend_parse_ini_file(&fh2, 1, ZEND_INI_SCANNER_NORMAL, (zend_ini_parser_cb_t) php_ini_parser_callback, &sg_configurationHash) == SUCCESS) {
+                        if (iniCache.parseFile(&fh2, (zend_ini_parser_cb_t) php_ini_parser_callback, &sg_configurationHash) == SUCCESS) {
                            /* Here, add it to the list of ini files read */
                            l = (int)strlen(iniFile);
                            total_l += l + 2;
@@ -667,17 +706,22 @@ bool php_init_config()
       /* Make sure an empty sg_phpIniScannedPath ends up as nullptr */
       sg_phpIniScannedPath = nullptr;
    }
+   iniCache.save();
    std::string &iniEntries = execEnvInfo.iniEntries;
    if (!iniEntries.empty()) {
       /* Reset active ini section */
       RESET_ACTIVE_INI_HASH();
       zend_parse_ini_string(const_cast<char *>(iniEntries.c_str()), 1, ZEND_INI_SCANNER_NORMAL, (zend_ini_parser_cb_t) php_ini_parser_callback, &sg_configurationHash);
    }
+   if (sg_hasPerDirConfig) {
+      php_build_per_dir_trie();
+   }
    return true;
 }
 
 int php_shutdown_config(void)
 {
+   sg_perDirTrie.reset();
    zend_hash_destroy(&sg_configurationHash);
    if (sg_phpIniOpenedPath) {
       free(sg_phpIniOpenedPath);
@@ -740,8 +784,6 @@ int php_ini_has_per_dir_config(void)
 
 void php_ini_activate_per_dir_config(char *path, size_t path_len)
 {
-   zval *tmp2;
-   char *ptr;
 #ifdef POLAR_OS_WIN32
    char path_bak[MAXPATHLEN];
 #endif
@@ -762,17 +804,14 @@ void php_ini_activate_per_dir_config(char *path, size_t path_len)
    path = path_bak;
 #endif
 
-   /* Walk through each directory in path and apply any found per-dir-system-configuration from sg_configurationHash */
-   if (sg_hasPerDirConfig && path && path_len) {
-      ptr = path + 1;
-      while ((ptr = strchr(ptr, '/')) != nullptr) {
-         *ptr = 0;
-         /* Search for source array matching the path from sg_configurationHash */
-         if ((tmp2 = zend_hash_str_find(&sg_configurationHash, path, strlen(path))) != nullptr) {
-            php_ini_activate_config(Z_ARRVAL_P(tmp2), POLAR_INI_SYSTEM, POLAR_INI_STAGE_ACTIVATE);
+   /* Walk through each directory in path down the per-dir trie, the deepest
+    * configured directory holds the settings of the directories above it */
+   if (sg_hasPerDirConfig && sg_perDirTrie && path && path_len) {
+      const IniPerDirTrie::Settings *settings = sg_perDirTrie->lookup(StringRef(path, path_len));
+      if (settings) {
+         for (auto &setting : *settings) {
+            zend_alter_ini_entry_ex(setting.first, setting.second, POLAR_INI_SYSTEM, POLAR_INI_STAGE_ACTIVATE, 0);
          }
-         *ptr = '/';
-         ptr++;
       }
    }
 }
@@ -0,0 +1,283 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/04.
+
+#include "polarphp/runtime/IniCache.h"
+#include "polarphp/global/PolarVersion.h"
+#include "polarphp/utils/MemoryBuffer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace polar {
+namespace runtime {
+
+using polar::utils::MemoryBuffer;
+
+namespace {
+
+const char INI_CACHE_MAGIC[4] = {'P', 'I', 'N', 'C'};
+const uint32_t INI_CACHE_VERSION = 1;
+
+/// the constants in the values are resolved by the parser, a cache written
+/// by another build is not trusted
+const char INI_CACHE_BUILD[] = POLARPHP_VERSION " " ZEND_MODULE_BUILD_ID;
+
+template <typename T>
+void write_value(std::string &buffer, T value)
+{
+   buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void write_string(std::string &buffer, StringRef str)
+{
+   write_value<uint32_t>(buffer, static_cast<uint32_t>(str.size()));
+   buffer.append(str.getData(), str.size());
+}
+
+class CacheReader
+{
+public:
+   CacheReader(StringRef data)
+      : m_data(data),
+        m_failed(false)
+   {}
+
+   template <typename T>
+   T readValue()
+   {
+      T value = T();
+      if (m_data.size() < sizeof(T)) {
+         m_failed = true;
+         return value;
+      }
+      memcpy(&value, m_data.getData(), sizeof(T));
+      m_data = m_data.substr(sizeof(T));
+      return value;
+   }
+
+   StringRef readString()
+   {
+      uint32_t length = readValue<uint32_t>();
+      if (m_failed || m_data.size() < length) {
+         m_failed = true;
+         return StringRef();
+      }
+      StringRef str = m_data.substr(0, length);
+      m_data = m_data.substr(length);
+      return str;
+   }
+
+   bool isFailed() const
+   {
+      return m_failed;
+   }
+
+   bool isDone() const
+   {
+      return m_data.empty();
+   }
+
+private:
+   StringRef m_data;
+   bool m_failed;
+};
+
+} // anonymous namespace
+
+IniCache::IniCache(StringRef cacheFile)
+   : m_cacheFile(cacheFile.getStr()),
+     m_dirty(false)
+{
+   if (!m_cacheFile.empty() && !load()) {
+      m_files.clear();
+   }
+}
+
+bool IniCache::load()
+{
+   auto bufferOrError = MemoryBuffer::getFile(m_cacheFile, -1, false);
+   if (!bufferOrError) {
+      return false;
+   }
+   CacheReader reader(bufferOrError.get()->getBuffer());
+   char magic[sizeof(INI_CACHE_MAGIC)];
+   for (char &c : magic) {
+      c = reader.readValue<char>();
+   }
+   if (reader.isFailed() || memcmp(magic, INI_CACHE_MAGIC, sizeof(magic)) != 0 ||
+       reader.readValue<uint32_t>() != INI_CACHE_VERSION ||
+       reader.readString() != INI_CACHE_BUILD) {
+      return false;
+   }
+   uint32_t fileCount = reader.readValue<uint32_t>();
+   for (uint32_t i = 0; i < fileCount && !reader.isFailed(); ++i) {
+      StringRef path = reader.readString();
+      FileEntry &entry = m_files[path];
+      entry.size = reader.readValue<uint64_t>();
+      entry.mtime = reader.readValue<int64_t>();
+      entry.used = false;
+      uint32_t recordCount = reader.readValue<uint32_t>();
+      for (uint32_t j = 0; j < recordCount && !reader.isFailed(); ++j) {
+         Record record;
+         record.type = reader.readValue<int32_t>();
+         record.argMask = reader.readValue<uint8_t>();
+         for (int k = 0; k < 3; ++k) {
+            if (record.argMask & (1 << k)) {
+               record.args[k] = reader.readString().getStr();
+            }
+         }
+         entry.records.push_back(std::move(record));
+      }
+   }
+   return !reader.isFailed() && reader.isDone();
+}
+
+bool IniCache::save()
+{
+   if (m_cacheFile.empty() || !m_dirty) {
+      return true;
+   }
+   std::string buffer(INI_CACHE_MAGIC, sizeof(INI_CACHE_MAGIC));
+   write_value<uint32_t>(buffer, INI_CACHE_VERSION);
+   write_string(buffer, INI_CACHE_BUILD);
+   uint32_t fileCount = 0;
+   for (auto &item : m_files) {
+      if (item.getValue().used) {
+         ++fileCount;
+      }
+   }
+   write_value<uint32_t>(buffer, fileCount);
+   for (auto &item : m_files) {
+      const FileEntry &entry = item.getValue();
+      if (!entry.used) {
+         continue;
+      }
+      write_string(buffer, item.getKey());
+      write_value<uint64_t>(buffer, entry.size);
+      write_value<int64_t>(buffer, entry.mtime);
+      write_value<uint32_t>(buffer, static_cast<uint32_t>(entry.records.size()));
+      for (const Record &record : entry.records) {
+         write_value<int32_t>(buffer, record.type);
+         write_value<uint8_t>(buffer, record.argMask);
+         for (int k = 0; k < 3; ++k) {
+            if (record.argMask & (1 << k)) {
+               write_string(buffer, record.args[k]);
+            }
+         }
+      }
+   }
+   /// concurrent processes may start with the same cache, every one of
+   /// them writes its own file and renames it over the cache
+   std::string tempPath = m_cacheFile + "." + std::to_string(getpid()) + ".tmp";
+   FILE *file = fopen(tempPath.c_str(), "wb");
+   if (!file) {
+      return false;
+   }
+   bool ok = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+   ok = (fclose(file) == 0) && ok;
+   if (!ok || std::rename(tempPath.c_str(), m_cacheFile.c_str()) != 0) {
+      std::remove(tempPath.c_str());
+      return false;
+   }
+   m_dirty = false;
+   return true;
+}
+
+int IniCache::parseFile(zend_file_handle *fileHandle, zend_ini_parser_cb_t callback, void *arg)
+{
+   zend_stat_t statBuf;
+   if (m_cacheFile.empty() || fileHandle->type != ZEND_HANDLE_FP ||
+       zend_fstat(fileno(fileHandle->handle.fp), &statBuf) != 0) {
+      return zend_parse_ini_file(fileHandle, 1, ZEND_INI_SCANNER_NORMAL, callback, arg);
+   }
+   StringRef path(fileHandle->filename);
+   auto iter = m_files.find(path);
+   if (iter != m_files.end() &&
+       iter->getValue().size == static_cast<uint64_t>(statBuf.st_size) &&
+       iter->getValue().mtime == static_cast<int64_t>(statBuf.st_mtime)) {
+      zend_file_handle_dtor(fileHandle);
+      iter->getValue().used = true;
+      replay(iter->getValue(), callback, arg);
+      return SUCCESS;
+   }
+   FileEntry entry;
+   entry.size = statBuf.st_size;
+   entry.mtime = statBuf.st_mtime;
+   entry.used = true;
+   RecordContext context{callback, arg, &entry, true};
+   std::string filename = path.getStr();
+   int result = zend_parse_ini_file(fileHandle, 1, ZEND_INI_SCANNER_NORMAL,
+                                    reinterpret_cast<zend_ini_parser_cb_t>(recordCallback), &context);
+   if (result != SUCCESS) {
+      m_files.erase(filename);
+      return result;
+   }
+   /// ${var} is expanded from the environment at parse time
+   auto bufferOrError = MemoryBuffer::getFile(filename, -1, false);
+   if (!context.cacheable || !bufferOrError ||
+       bufferOrError.get()->getBuffer().find("${") != StringRef::npos) {
+      m_files.erase(filename);
+      m_dirty = true;
+      return result;
+   }
+   m_files[filename] = std::move(entry);
+   m_dirty = true;
+   return result;
+}
+
+void IniCache::recordCallback(zval *arg1, zval *arg2, zval *arg3, int callbackType, void *arg)
+{
+   RecordContext *context = reinterpret_cast<RecordContext *>(arg);
+   /// the callback may rewrite the section names in place, copy them first
+   Record record;
+   record.type = callbackType;
+   record.argMask = 0;
+   zval *args[3] = {arg1, arg2, arg3};
+   for (int i = 0; i < 3; ++i) {
+      if (!args[i]) {
+         continue;
+      }
+      if (Z_TYPE_P(args[i]) != IS_STRING) {
+         context->cacheable = false;
+         continue;
+      }
+      record.argMask |= 1 << i;
+      record.args[i].assign(Z_STRVAL_P(args[i]), Z_STRLEN_P(args[i]));
+   }
+   context->entry->records.push_back(std::move(record));
+   context->callback(arg1, arg2, arg3, callbackType, context->arg);
+}
+
+void IniCache::replay(const FileEntry &entry, zend_ini_parser_cb_t callback, void *arg)
+{
+   for (const Record &record : entry.records) {
+      zval values[3];
+      zval *args[3] = {nullptr, nullptr, nullptr};
+      for (int i = 0; i < 3; ++i) {
+         if (record.argMask & (1 << i)) {
+            /// the same persistent strings the system ini parser produces
+            ZVAL_NEW_STR(&values[i], zend_string_init(record.args[i].data(), record.args[i].size(), 1));
+            args[i] = &values[i];
+         }
+      }
+      callback(args[0], args[1], args[2], record.type, arg);
+      for (int i = 0; i < 3; ++i) {
+         if (args[i]) {
+            zend_string_release_ex(Z_STR_P(args[i]), 1);
+         }
+      }
+   }
+}
+
+} // runtime
+} // polar
@@ -0,0 +1,130 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/04.
+
+#include "polarphp/runtime/IniPerDirTrie.h"
+#include "polarphp/basic/adt/StringMap.h"
+
+#include <string>
+
+namespace polar {
+namespace runtime {
+
+using polar::basic::StringMap;
+
+struct IniPerDirTrie::Node
+{
+   StringMap<std::unique_ptr<Node>> children;
+   HashTable *section = nullptr;
+   Settings settings;
+};
+
+namespace {
+
+///
+/// Split \p path the way the per-dir lookup compares the prefixes: the
+/// first separator searched for is the one after the first character, every
+/// component except the last one is handed to \p callback.
+///
+template <typename CallbackType>
+void walk_components(StringRef path, CallbackType callback)
+{
+   size_t begin = 0;
+   size_t slash;
+   while ((slash = path.find('/', begin == 0 ? 1 : begin)) != StringRef::npos) {
+      if (!callback(path.slice(begin, slash))) {
+         return;
+      }
+      begin = slash + 1;
+   }
+}
+
+} // anonymous namespace
+
+IniPerDirTrie::IniPerDirTrie()
+   : m_root(new Node)
+{}
+
+IniPerDirTrie::~IniPerDirTrie()
+{}
+
+void IniPerDirTrie::addSection(StringRef key, HashTable *section)
+{
+   /// [PATH=/] leaves an empty key, no leading directory of a path is empty
+   if (key.empty()) {
+      return;
+   }
+   Node *node = m_root.get();
+   /// the key is a directory, it is walked as if a file followed it
+   std::string directory = key.getStr() + "/";
+   walk_components(directory, [&node](StringRef component) {
+      std::unique_ptr<Node> &child = node->children[component];
+      if (!child) {
+         child.reset(new Node);
+      }
+      node = child.get();
+      return true;
+   });
+   node->section = section;
+}
+
+void IniPerDirTrie::mergeSettings(Node *node, const Settings &inherited)
+{
+   node->settings = inherited;
+   if (node->section) {
+      zend_string *name;
+      zval *value;
+      ZEND_HASH_FOREACH_STR_KEY_VAL(node->section, name, value) {
+         if (!name || Z_TYPE_P(value) != IS_STRING) {
+            continue;
+         }
+         bool overridden = false;
+         for (auto &setting : node->settings) {
+            if (zend_string_equals(setting.first, name)) {
+               setting.second = Z_STR_P(value);
+               overridden = true;
+               break;
+            }
+         }
+         if (!overridden) {
+            node->settings.emplace_back(name, Z_STR_P(value));
+         }
+      } ZEND_HASH_FOREACH_END();
+   }
+   for (auto &child : node->children) {
+      mergeSettings(child.getValue().get(), node->settings);
+   }
+}
+
+void IniPerDirTrie::build()
+{
+   mergeSettings(m_root.get(), {});
+}
+
+const IniPerDirTrie::Settings *IniPerDirTrie::lookup(StringRef path) const
+{
+   const Node *node = m_root.get();
+   const Node *deepest = nullptr;
+   walk_components(path, [&node, &deepest](StringRef component) {
+      auto iter = node->children.find(component);
+      if (iter == node->children.end()) {
+         return false;
+      }
+      node = iter->getValue().get();
+      if (!node->settings.empty()) {
+         deepest = node;
+      }
+      return true;
+   });
+   return deepest ? &deepest->settings : nullptr;
+}
+
+} // runtime
+} // polar
@@ -17,11 +17,13 @@
 #include "polarphp/runtime/Ini.h"
 #include "polarphp/runtime/Reentrancy.h"
 #include "polarphp/runtime/Spprintf.h"
+#include "polarphp/runtime/StartupProfile.h"
 
 #include "polarphp/runtime/Ticks.h"
 #include "polarphp/global/Config.h"
 
 #include <cstring>
+#include <string>
 #include <sys/wait.h>
 
 namespace polar {
@@ -109,7 +111,21 @@ void cli_ini_defaults(HashTable *configuration_hash)
 
 void php_disable_functions()
 {
-
+   char *list = INI_STR(const_cast<char *>("disable_functions"));
+   if (!list || !*list) {
+      return;
+   }
+   /// the names are separated by spaces or commas
+   std::string names(list);
+   size_t pos = 0;
+   while ((pos = names.find_first_not_of(" ,", pos)) != std::string::npos) {
+      size_t end = names.find_first_of(" ,", pos);
+      if (end == std::string::npos) {
+         end = names.size();
+      }
+      zend_disable_function(&names[pos], end - pos);
+      pos = end;
+   }
 }
 
 void php_disable_classes()
@@ -165,7 +181,10 @@ bool php_module_startup()
 
    sg_moduleShutdown = false;
    sg_moduleStartup = true;
-   execEnv.activate();
+   {
+      StartupPhase phase(StartupProfile::MODULE_STARTUP_GROUP, "activate");
+      execEnv.activate();
+   }
 
    if (sg_moduleInitialized) {
       return true;
@@ -177,9 +196,9 @@ bool php_module_startup()
    zuf.error_function = php_error_callback;
    zuf.printf_function = php_printf;
    zuf.write_function = php_output_wrapper;
-   /// polarphp does not use php stream
+   /// polarphp does not use php stream, scripts are mapped directly
    zuf.fopen_function = nullptr;
-   zuf.stream_open_function = nullptr;
+   zuf.stream_open_function = php_stream_open_for_zend;
    /// need review whether need execute timeout mechanism
    zuf.on_timeout = nullptr;
    zuf.message_handler = php_message_handler_for_zend;
@@ -189,7 +208,10 @@ bool php_module_startup()
    zuf.printf_to_smart_str_function = php_printf_to_smart_str;
    zuf.getenv_function = bootstrap_getenv;
    zuf.resolve_path_function = php_resolve_path_for_zend;
-   zend_startup(&zuf, nullptr);
+   {
+      StartupPhase phase(StartupProfile::MODULE_STARTUP_GROUP, "zend_startup");
+      zend_startup(&zuf, nullptr);
+   }
 
 #if HAVE_SETLOCALE
    setlocale(LC_CTYPE, "");
@@ -212,7 +234,10 @@ bool php_module_startup()
    le_index_ptr = zend_register_list_destructors_ex(nullptr, nullptr, "index pointer", 0);
 
    /* Register constants */
-   php_register_buildin_constants();
+   {
+      StartupPhase phase(StartupProfile::MODULE_STARTUP_GROUP, "register_buildin_constants");
+      php_register_buildin_constants();
+   }
 
    php_binary_init();
    std::string &polarBinary = execEnvInfo.polarBinary;
@@ -226,15 +251,21 @@ bool php_module_startup()
    /// this will read in php.ini, set up the configuration parameters,
    /// load zend extensions and register php function extensions
    /// to be loaded later
-   if (!php_init_config()) {
-      return false;
+   {
+      StartupPhase phase(StartupProfile::MODULE_STARTUP_GROUP, "init_config");
+      if (!php_init_config()) {
+         return false;
+      }
+   }
+   {
+      StartupPhase phase(StartupProfile::MODULE_STARTUP_GROUP, "register_ini_entries");
+      /// Register PHP core ini entries
+      /// TODO refactor
+      ///
+      REGISTER_INI_ENTRIES();
+      /* Register Zend ini entries */
+      zend_register_standard_ini_entries();
    }
-   /// Register PHP core ini entries
-   /// TODO refactor
-   ///
-   REGISTER_INI_ENTRIES();
-   /* Register Zend ini entries */
-   zend_register_standard_ini_entries();
 
 #ifdef POLAR_OS_WIN32
    /* Until the current ini values was setup, the current cp is 65001.
@@ -263,9 +294,12 @@ bool php_module_startup()
    zend_set_utility_values(&zuv);
 
    /* startup extensions statically compiled in */
-   if (!php_register_internal_extensions()) {
-      php_printf("Unable to start polarphp standard library (libpdk)\n");
-      return false;
+   {
+      StartupPhase phase(StartupProfile::MODULE_STARTUP_GROUP, "register_extensions");
+      if (!php_register_internal_extensions()) {
+         php_printf("Unable to start polarphp standard library (libpdk)\n");
+         return false;
+      }
    }
 
    /// load and startup extensions compiled as shared objects (aka DLLs)
@@ -275,17 +309,25 @@ bool php_module_startup()
    /// which is always an internal extension and to be initialized
    /// ahead of all other internals
 
-   php_ini_register_extensions();
-   zend_startup_modules();
-   /* start Zend extensions */
-   zend_startup_extensions();
-   zend_collect_module_handlers();
-   /* disable certain classes and functions as requested by php.ini */
-   php_disable_functions();
-   php_disable_classes();
-
-   if (zend_post_startup() != SUCCESS) {
-      return false;
+   {
+      StartupPhase phase(StartupProfile::MODULE_STARTUP_GROUP, "startup_modules");
+      php_ini_register_extensions();
+      zend_startup_modules();
+   }
+   {
+      StartupPhase phase(StartupProfile::MODULE_STARTUP_GROUP, "startup_extensions");
+      /* start Zend extensions */
+      zend_startup_extensions();
+      zend_collect_module_handlers();
+      /* disable certain classes and functions as requested by php.ini */
+      php_disable_functions();
+      php_disable_classes();
+   }
+   {
+      StartupPhase phase(StartupProfile::MODULE_STARTUP_GROUP, "post_startup");
+      if (zend_post_startup() != SUCCESS) {
+         return false;
+      }
    }
    sg_moduleInitialized = true;
    /* Check for deprecated directives */
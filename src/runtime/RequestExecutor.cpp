@@ -0,0 +1,172 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/01/22.
+
+#include "polarphp/runtime/RequestExecutor.h"
+#include "polarphp/runtime/LifeCycle.h"
+#include "polarphp/runtime/Ticks.h"
+
+#ifdef ZTS
+
+namespace polar {
+namespace runtime {
+
+RequestExecutor::RequestExecutor()
+   : RequestExecutor(std::thread::hardware_concurrency())
+{}
+
+RequestExecutor::RequestExecutor(unsigned threadCount)
+   : m_activeThreads(0),
+     m_enableFlag(true)
+{
+   ExecEnv &execEnv = retrieve_global_execenv();
+   m_runtimeInfo = execEnv.getRuntimeInfo();
+   m_compileOptions = execEnv.getCompileOptions();
+   for (StringRef arg : execEnv.getContainerArgv()) {
+      m_argv.push_back(arg.getStr());
+   }
+   if (threadCount == 0) {
+      threadCount = 1;
+   }
+   m_threads.reserve(threadCount);
+   for (unsigned threadId = 0; threadId < threadCount; ++threadId) {
+      m_threads.emplace_back([this] {
+         workerLoop();
+      });
+   }
+}
+
+RequestExecutor::~RequestExecutor()
+{
+   {
+      std::unique_lock<std::mutex> lockGuard(m_queueLock);
+      m_enableFlag = false;
+   }
+   m_queueCondition.notify_all();
+   for (std::thread &worker : m_threads) {
+      worker.join();
+   }
+}
+
+std::future<int> RequestExecutor::submitScript(StringRef filename)
+{
+   Job job;
+   job.filename = filename.getStr();
+   return enqueue(std::move(job));
+}
+
+std::future<int> RequestExecutor::submit(EntryFuncType entry)
+{
+   Job job;
+   job.entry = std::move(entry);
+   return enqueue(std::move(job));
+}
+
+void RequestExecutor::wait()
+{
+   std::unique_lock<std::mutex> lockGuard(m_queueLock);
+   m_completionCondition.wait(lockGuard,
+                              [&] { return !m_activeThreads && m_jobs.empty(); });
+}
+
+unsigned RequestExecutor::getThreadCount() const
+{
+   return m_threads.size();
+}
+
+std::future<int> RequestExecutor::enqueue(Job job)
+{
+   std::future<int> future = job.exitStatus.get_future();
+   {
+      std::unique_lock<std::mutex> lockGuard(m_queueLock);
+      assert(m_enableFlag && "Queuing a request during executor destruction");
+      m_jobs.push(std::move(job));
+   }
+   m_queueCondition.notify_one();
+   return future;
+}
+
+void RequestExecutor::workerLoop()
+{
+   /// allocate this thread's resources, the new thread handlers copy the
+   /// ini directives and the globals ctors set up the executor
+   (void)ts_resource(0);
+   ZEND_TSRMLS_CACHE_UPDATE();
+   ExecEnv &execEnv = retrieve_global_execenv();
+   std::vector<StringRef> argv(m_argv.begin(), m_argv.end());
+   execEnv.getRuntimeInfo() = m_runtimeInfo;
+   execEnv.setContainerArgv(argv);
+   execEnv.setContainerArgc(argv.size());
+   execEnv.setCompileOptions(m_compileOptions);
+   startup_ticks();
+   while (true) {
+      Job job;
+      {
+         std::unique_lock<std::mutex> lockGuard(m_queueLock);
+         m_queueCondition.wait(lockGuard,
+                               [&] { return !m_enableFlag || !m_jobs.empty(); });
+         if (!m_enableFlag && m_jobs.empty()) {
+            break;
+         }
+         ++m_activeThreads;
+         job = std::move(m_jobs.front());
+         m_jobs.pop();
+      }
+      /// a C++ exception of the job must not terminate the worker
+      try {
+         job.exitStatus.set_value(runJob(job));
+      } catch (...) {
+         job.exitStatus.set_exception(std::current_exception());
+      }
+      {
+         std::unique_lock<std::mutex> lockGuard(m_queueLock);
+         --m_activeThreads;
+      }
+      m_completionCondition.notify_all();
+   }
+   shutdown_ticks();
+   ts_free_thread();
+}
+
+int RequestExecutor::runJob(Job &job)
+{
+   ExecEnv &execEnv = retrieve_global_execenv();
+   int exitStatus = 255;
+   std::exception_ptr error;
+   if (!php_exec_env_startup()) {
+      php_exec_env_shutdown();
+      return exitStatus;
+   }
+   if (job.entry) {
+      EntryFuncType &entry = job.entry;
+      polar_try {
+         /// an exception must not unwind past the bailout address
+         try {
+            exitStatus = entry();
+         } catch (...) {
+            error = std::current_exception();
+         }
+      } polar_catch {
+         exitStatus = EG(exit_status);
+      } polar_end_try;
+   } else {
+      execEnv.execScript(job.filename, exitStatus);
+   }
+   php_exec_env_shutdown();
+   if (error) {
+      std::rethrow_exception(error);
+   }
+   return exitStatus;
+}
+
+} // runtime
+} // polar
+
+#endif // ZTS
@@ -0,0 +1,107 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/01/23.
+
+#include "polarphp/runtime/RequestSnapshot.h"
+#include "polarphp/runtime/LifeCycle.h"
+#include "polarphp/runtime/Output.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if HAVE_FORK
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace polar {
+namespace runtime {
+
+RequestSnapshot::RequestSnapshot()
+   : m_captured(false)
+{}
+
+bool RequestSnapshot::capture(StringRef bootstrapFilename)
+{
+   ExecEnv &execEnv = retrieve_global_execenv();
+   if (!execEnv.isEnvReady()) {
+      return false;
+   }
+   int exitStatus = 0;
+   if (!execEnv.execScript(bootstrapFilename, exitStatus) || exitStatus != 0) {
+      return false;
+   }
+   m_captured = true;
+   return true;
+}
+
+bool RequestSnapshot::isCaptured() const
+{
+   return m_captured;
+}
+
+#if HAVE_FORK
+
+bool RequestSnapshot::exec(StringRef filename, int &exitStatus)
+{
+   ExecEnv &execEnv = retrieve_global_execenv();
+   if (!m_captured) {
+      return execEnv.execScript(filename, exitStatus);
+   }
+   fflush(stdout);
+   fflush(stderr);
+   pid_t pid = ::fork();
+   if (pid < 0) {
+      std::cerr << "fork error: " << strerror(errno) << std::endl;
+      return false;
+   }
+   if (pid == 0) {
+      /// child, the warmed state is shared with the template copy-on-write
+      /// and thrown away with the process, only the request is torn down.
+      /// The output buffered by the bootstrap belongs to the template, the
+      /// child would print it again at its shutdown
+      php_output_discard_all();
+      int status = 0;
+      if (!execEnv.execScript(filename, status)) {
+         status = 255;
+      }
+      php_exec_env_shutdown();
+      fflush(stdout);
+      fflush(stderr);
+      ::_exit(status);
+   }
+   int waitStatus = 0;
+   while (::waitpid(pid, &waitStatus, 0) < 0) {
+      if (errno != EINTR) {
+         return false;
+      }
+   }
+   if (WIFEXITED(waitStatus)) {
+      exitStatus = WEXITSTATUS(waitStatus);
+   } else {
+      exitStatus = 255;
+   }
+   return true;
+}
+
+#else
+
+bool RequestSnapshot::exec(StringRef filename, int &exitStatus)
+{
+   /// no copy-on-write process template on this platform, requests share
+   /// the captured state directly
+   return retrieve_global_execenv().execScript(filename, exitStatus);
+}
+
+#endif
+
+} // runtime
+} // polar
@@ -0,0 +1,373 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/02/26.
+
+#include "polarphp/runtime/ScriptBundle.h"
+#include "polarphp/runtime/ScanDir.h"
+#include "polarphp/runtime/internal/DepsZendVmHeaders.h"
+#include "polarphp/basic/adt/SmallString.h"
+#include "polarphp/basic/adt/SmallVector.h"
+#include "polarphp/utils/Compression.h"
+#include "polarphp/utils/Error.h"
+#include "polarphp/utils/FileSystem.h"
+#include "polarphp/utils/MathExtras.h"
+#include "polarphp/utils/Path.h"
+#include "polarphp/utils/TarWriter.h"
+
+#include <cstring>
+#include <sys/stat.h>
+
+namespace polar {
+namespace runtime {
+
+using polar::basic::SmallString;
+using polar::basic::SmallVector;
+using polar::utils::TarWriter;
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 512;
+const char BUNDLE_BASE_DIR[] = "bundle";
+const char COMPRESSED_MARKER[] = ".compressed";
+
+std::unique_ptr<ScriptBundle> sg_mountedBundle;
+
+uint64_t parse_octal(const char *field, size_t size)
+{
+   uint64_t value = 0;
+   for (size_t i = 0; i < size && field[i] >= '0' && field[i] <= '7'; ++i) {
+      value = (value << 3) | (field[i] - '0');
+   }
+   return value;
+}
+
+bool is_zero_block(const char *block)
+{
+   for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+      if (block[i]) {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool verify_checksum(const char *block)
+{
+   /// offsets of the ustar header, see TarWriter
+   const size_t checksumOffset = 148;
+   const size_t checksumSize = 8;
+   unsigned sum = 0;
+   for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+      bool inChecksum = i >= checksumOffset && i < checksumOffset + checksumSize;
+      sum += inChecksum ? ' ' : static_cast<uint8_t>(block[i]);
+   }
+   return sum == parse_octal(block + checksumOffset, checksumSize);
+}
+
+StringRef parse_pax_path(StringRef records)
+{
+   /// every record is "<length> <key>=<value>\n"
+   while (!records.empty()) {
+      size_t space = records.find(' ');
+      size_t length = 0;
+      if (space == StringRef::npos || records.substr(0, space).getAsInteger(10, length) ||
+          length <= space || length > records.size()) {
+         break;
+      }
+      StringRef record = records.substr(space + 1, length - space - 2);
+      if (record.startsWith("path=")) {
+         return record.substr(5);
+      }
+      records = records.substr(length);
+   }
+   return StringRef();
+}
+
+/// a member path is relative and stays below the mount point, "." and
+/// repeated separators are dropped
+bool normalize_member_path(StringRef path, SmallString<256> &normalized)
+{
+   if (path.empty() || path.startsWith("/") || polar::fs::path::is_absolute(path)) {
+      return false;
+   }
+   for (auto iter = polar::fs::path::begin(path), end = polar::fs::path::end(path);
+        iter != end; ++iter) {
+      if (*iter == "..") {
+         return false;
+      }
+   }
+   normalized = path;
+   polar::fs::path::remove_dots(normalized);
+   return !normalized.empty() && normalized != ".";
+}
+
+void collect_files(const std::string &dir, const std::string &relative,
+                   std::vector<std::pair<std::string, std::string>> &files)
+{
+   struct dirent **namelist = nullptr;
+   int count = php_scandir(dir.c_str(), &namelist, nullptr, php_alphasort);
+   if (count < 0) {
+      return;
+   }
+   for (int i = 0; i < count; ++i) {
+      const char *name = namelist[i]->d_name;
+      if (strcmp(name, ".") != 0 && strcmp(name, "..") != 0) {
+         std::string fullPath = dir + "/" + name;
+         std::string relativePath = relative.empty() ? name : relative + "/" + name;
+         struct stat info;
+         if (::stat(fullPath.c_str(), &info) == 0) {
+            if (S_ISDIR(info.st_mode)) {
+               collect_files(fullPath, relativePath, files);
+            } else if (S_ISREG(info.st_mode)) {
+               files.emplace_back(std::move(fullPath), std::move(relativePath));
+            }
+         }
+      }
+      free(namelist[i]);
+   }
+   free(namelist);
+}
+
+} // anonymous namespace
+
+bool ScriptBundle::build(StringRef bundlePath, StringRef rootDir, bool compress,
+                         std::string &errorMsg)
+{
+   if (compress && !polar::utils::zlib::is_available()) {
+      errorMsg = "zlib support is not available";
+      return false;
+   }
+   std::vector<std::pair<std::string, std::string>> files;
+   collect_files(rootDir.getStr(), "", files);
+   auto writerOrError = TarWriter::create(bundlePath, BUNDLE_BASE_DIR);
+   if (!writerOrError) {
+      errorMsg = polar::utils::to_string(writerOrError.takeError());
+      return false;
+   }
+   std::unique_ptr<TarWriter> writer = std::move(writerOrError.get());
+   if (compress) {
+      writer->append(COMPRESSED_MARKER, "");
+   }
+   for (auto &file : files) {
+      auto bufferOrError = MemoryBuffer::getFile(file.first, -1, false);
+      if (!bufferOrError) {
+         errorMsg = "cannot read " + file.first + ": " + bufferOrError.getError().message();
+         return false;
+      }
+      StringRef data = bufferOrError.get()->getBuffer();
+      if (!compress) {
+         writer->append(file.second, data);
+         continue;
+      }
+      SmallVector<char, 0> compressed;
+      if (polar::utils::Error error = polar::utils::zlib::compress(data, compressed)) {
+         errorMsg = polar::utils::to_string(std::move(error));
+         return false;
+      }
+      std::string member = std::to_string(data.size()) + "\n";
+      member.append(compressed.begin(), compressed.end());
+      writer->append(file.second, member);
+   }
+   return true;
+}
+
+std::unique_ptr<ScriptBundle> ScriptBundle::open(StringRef bundlePath, StringRef mountPoint,
+                                                 std::string &errorMsg)
+{
+   auto bufferOrError = MemoryBuffer::getFile(bundlePath, -1, false);
+   if (!bufferOrError) {
+      errorMsg = "cannot open " + bundlePath.getStr() + ": " + bufferOrError.getError().message();
+      return nullptr;
+   }
+   SmallString<256> absoluteMountPoint(mountPoint.empty() ? bundlePath : mountPoint);
+   if (std::error_code errorCode = polar::fs::make_absolute(absoluteMountPoint)) {
+      errorMsg = errorCode.message();
+      return nullptr;
+   }
+   polar::fs::path::remove_dots(absoluteMountPoint, true);
+   std::unique_ptr<ScriptBundle> bundle(
+            new ScriptBundle(std::move(bufferOrError.get()), absoluteMountPoint.getStr()));
+   if (!bundle->load(errorMsg)) {
+      return nullptr;
+   }
+   return bundle;
+}
+
+void ScriptBundle::mount(std::unique_ptr<ScriptBundle> bundle)
+{
+   sg_mountedBundle = std::move(bundle);
+}
+
+ScriptBundle *ScriptBundle::getMounted()
+{
+   return sg_mountedBundle.get();
+}
+
+ScriptBundle::ScriptBundle(std::unique_ptr<MemoryBuffer> buffer, StringRef mountPoint)
+   : m_buffer(std::move(buffer)),
+     m_mountPoint(mountPoint),
+     m_fileSystem(new InMemoryFileSystem),
+     m_fileCount(0)
+{
+   m_fileSystem->setCurrentWorkingDirectory(m_mountPoint);
+}
+
+bool ScriptBundle::load(std::string &errorMsg)
+{
+   const char *start = m_buffer->getBufferStart();
+   size_t size = m_buffer->getBufferSize();
+   size_t pos = 0;
+   bool compressed = false;
+   StringRef paxPath;
+   while (pos + BLOCK_SIZE <= size) {
+      const char *header = start + pos;
+      if (is_zero_block(header)) {
+         break;
+      }
+      if (!verify_checksum(header)) {
+         errorMsg = "corrupted bundle header at offset " + std::to_string(pos);
+         return false;
+      }
+      uint64_t dataSize = parse_octal(header + 124, 12);
+      time_t mtime = parse_octal(header + 136, 12);
+      char typeFlag = header[156];
+      size_t dataPos = pos + BLOCK_SIZE;
+      if (dataSize > size - dataPos) {
+         errorMsg = "truncated bundle";
+         return false;
+      }
+      StringRef data(start + dataPos, dataSize);
+      pos = dataPos + polar::utils::align_to(dataSize, BLOCK_SIZE);
+      if (typeFlag == 'x') {
+         paxPath = parse_pax_path(data);
+         continue;
+      }
+      std::string path;
+      if (!paxPath.empty()) {
+         path = paxPath.getStr();
+         paxPath = StringRef();
+      } else {
+         StringRef name(header, strnlen(header, 100));
+         StringRef prefix(header + 345, strnlen(header + 345, 155));
+         path = prefix.empty() ? name.getStr() : (prefix + "/" + name).getStr();
+      }
+      if (typeFlag != '0' && typeFlag != '\0') {
+         continue;
+      }
+      StringRef relativePath(path);
+      if (!relativePath.consumeFront(BUNDLE_BASE_DIR) || !relativePath.consumeFront("/")) {
+         errorMsg = "unexpected bundle member " + path;
+         return false;
+      }
+      if (relativePath == COMPRESSED_MARKER) {
+         compressed = true;
+         continue;
+      }
+      SmallString<256> memberPath;
+      if (!normalize_member_path(relativePath, memberPath)) {
+         errorMsg = "bundle member " + path + " escapes the bundle";
+         return false;
+      }
+      if (!addMember(memberPath, data, mtime, compressed, errorMsg)) {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool ScriptBundle::addMember(StringRef path, StringRef data, time_t mtime, bool compressed,
+                             std::string &errorMsg)
+{
+   if (compressed) {
+      size_t newline = data.find('\n');
+      size_t sourceSize = 0;
+      if (newline == StringRef::npos || data.substr(0, newline).getAsInteger(10, sourceSize)) {
+         errorMsg = "corrupted bundle member " + path.getStr();
+         return false;
+      }
+      std::unique_ptr<char[]> source(new char[sourceSize + ZEND_MMAP_AHEAD]());
+      size_t inflatedSize = sourceSize;
+      if (polar::utils::Error error = polar::utils::zlib::uncompress(
+             data.substr(newline + 1), source.get(), inflatedSize)) {
+         errorMsg = path.getStr() + ": " + polar::utils::to_string(std::move(error));
+         return false;
+      }
+      data = StringRef(source.get(), inflatedSize);
+      m_ownedSources.push_back(std::move(source));
+   } else {
+      data = keepPadded(data);
+   }
+   SmallString<256> fullPath(m_mountPoint);
+   polar::fs::path::append(fullPath, path);
+   m_fileSystem->addFile(fullPath, mtime, MemoryBuffer::getMemBuffer(data, fullPath, false));
+   ++m_fileCount;
+   return true;
+}
+
+StringRef ScriptBundle::keepPadded(StringRef data)
+{
+   /// the scanner reads up to ZEND_MMAP_AHEAD bytes past the source, the
+   /// zero padding of the tar block usually covers them, the members ending
+   /// close to a block boundary are copied
+   const char *end = data.end();
+   const char *bufferEnd = m_buffer->getBufferEnd();
+   bool padded = static_cast<size_t>(bufferEnd - end) >= ZEND_MMAP_AHEAD;
+   for (size_t i = 0; padded && i < ZEND_MMAP_AHEAD; ++i) {
+      padded = end[i] == '\0';
+   }
+   if (padded) {
+      return data;
+   }
+   std::unique_ptr<char[]> source(new char[data.size() + ZEND_MMAP_AHEAD]());
+   std::memcpy(source.get(), data.getData(), data.size());
+   data = StringRef(source.get(), data.size());
+   m_ownedSources.push_back(std::move(source));
+   return data;
+}
+
+bool ScriptBundle::getSource(StringRef path, StringRef &source) const
+{
+   auto fileOrError = m_fileSystem->openFileForRead(path);
+   if (!fileOrError) {
+      return false;
+   }
+   auto bufferOrError = fileOrError.get()->getBuffer(path, -1, false);
+   if (!bufferOrError) {
+      return false;
+   }
+   /// the buffer only refers to the bundle memory
+   source = bufferOrError.get()->getBuffer();
+   return true;
+}
+
+bool ScriptBundle::isFile(StringRef path) const
+{
+   auto statusOrError = m_fileSystem->getStatus(path);
+   return statusOrError && statusOrError->isRegularFile();
+}
+
+bool ScriptBundle::isDirectory(StringRef path) const
+{
+   auto statusOrError = m_fileSystem->getStatus(path);
+   return statusOrError && statusOrError->isDirectory();
+}
+
+StringRef ScriptBundle::getMountPoint() const
+{
+   return m_mountPoint;
+}
+
+size_t ScriptBundle::getFileCount() const
+{
+   return m_fileCount;
+}
+
+} // runtime
+} // polar
@@ -0,0 +1,137 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/02.
+
+#include "polarphp/runtime/StartupProfile.h"
+#include "polarphp/runtime/internal/DepsZendVmHeaders.h"
+#include "polarphp/utils/RawOutStream.h"
+
+#include <cctype>
+
+namespace polar {
+namespace runtime {
+
+using polar::utils::TimerGroup;
+
+namespace {
+
+/// the modules start one after the other on the main thread
+TimeRecord sg_moduleStartTime;
+
+void module_startup_observer(zend_module_entry *module, int done)
+{
+   if (!done) {
+      sg_moduleStartTime = TimeRecord::getCurrentTime(true);
+      return;
+   }
+   TimeRecord time = TimeRecord::getCurrentTime(false);
+   time -= sg_moduleStartTime;
+   /// the JSON keys are not quoted, keep the names plain
+   std::string name(module->name);
+   for (char &c : name) {
+      if (!std::isalnum(static_cast<unsigned char>(c))) {
+         c = '_';
+      }
+   }
+   StartupProfile::getInstance().addRecord(StartupProfile::MODULES_GROUP, name, time);
+}
+
+} // anonymous namespace
+
+StartupProfile::StartupProfile()
+   : m_enabled(false)
+{
+   m_groups.push_back({PROCESS_GROUP, "Startup phases", StringMap<TimeRecord>()});
+   m_groups.push_back({MODULE_STARTUP_GROUP, "Module startup phases", StringMap<TimeRecord>()});
+   m_groups.push_back({MODULES_GROUP, "Module startup functions", StringMap<TimeRecord>()});
+}
+
+StartupProfile &StartupProfile::getInstance()
+{
+   static StartupProfile profile;
+   return profile;
+}
+
+void StartupProfile::enable()
+{
+   m_enabled = true;
+   zend_module_startup_observer = module_startup_observer;
+}
+
+bool StartupProfile::isEnabled() const
+{
+   return m_enabled;
+}
+
+StartupProfile::Group &StartupProfile::getGroup(StringRef name)
+{
+   for (Group &group : m_groups) {
+      if (group.name == name) {
+         return group;
+      }
+   }
+   m_groups.push_back({name.getStr(), name.getStr(), StringMap<TimeRecord>()});
+   return m_groups.back();
+}
+
+void StartupProfile::addRecord(StringRef group, StringRef name, const TimeRecord &time)
+{
+   /// a phase run more than once is accumulated
+   getGroup(group).records[name] += time;
+}
+
+void StartupProfile::print(RawOutStream &outStream)
+{
+   for (Group &group : m_groups) {
+      if (group.records.empty()) {
+         continue;
+      }
+      TimerGroup timerGroup(group.name, group.description, group.records);
+      timerGroup.print(outStream);
+   }
+}
+
+void StartupProfile::printJSON(RawOutStream &outStream)
+{
+   const char *delim = "";
+   outStream << "{\n";
+   for (Group &group : m_groups) {
+      if (group.records.empty()) {
+         continue;
+      }
+      TimerGroup timerGroup(group.name, group.description, group.records);
+      delim = timerGroup.printJSONValues(outStream, delim);
+   }
+   outStream << "\n}\n";
+   outStream.flush();
+}
+
+StartupPhase::StartupPhase(StringRef group, StringRef name)
+   : m_group(group),
+     m_name(name),
+     m_active(StartupProfile::getInstance().isEnabled())
+{
+   if (m_active) {
+      m_startTime = TimeRecord::getCurrentTime(true);
+   }
+}
+
+StartupPhase::~StartupPhase()
+{
+   if (!m_active) {
+      return;
+   }
+   TimeRecord time = TimeRecord::getCurrentTime(false);
+   time -= m_startTime;
+   StartupProfile::getInstance().addRecord(m_group, m_name, time);
+}
+
+} // runtime
+} // polar
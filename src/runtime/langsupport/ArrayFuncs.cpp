@@ -11,7 +11,13 @@
 
 #include "polarphp/runtime/langsupport/LangSupportFuncs.h"
 #include "polarphp/runtime/langsupport/ArrayFuncs.h"
+#include "polarphp/runtime/langsupport/LazyRange.h"
 #include "polarphp/runtime/Utils.h"
+#include "polarphp/utils/Parallel.h"
+
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
 
 namespace polar {
 namespace runtime {
@@ -900,7 +906,8 @@ int array_user_compare(const void *a, const void *b) /* {{{ */
    rdata.userCompareFci.retval = &retval;
    rdata.userCompareFci.no_separation = 0;
 
-   if (zend_call_function(&rdata.userCompareFci, &rdata.userCompareFciCache) == SUCCESS && Z_TYPE(retval) != IS_UNDEF) {
+   if (zend_call_prepared(&rdata.userComparePrepared, &rdata.userCompareFci, &rdata.userCompareFciCache) == SUCCESS &&
+       Z_TYPE(retval) != IS_UNDEF) {
       zend_long ret = zval_get_long(&retval);
       zval_ptr_dtor(&retval);
       zval_ptr_dtor(&args[1]);
@@ -920,6 +927,7 @@ int array_user_compare(const void *a, const void *b) /* {{{ */
    RuntimeModuleData &rdata = retrieve_runtime_module_data();\
    rdata.userCompareFci = old_user_compare_fci;\
    rdata.userCompareFciCache = old_user_compare_fci_cache;\
+   rdata.userComparePrepared = old_user_compare_prepared;\
    RETURN_FALSE;	\
 }	\
 
@@ -932,17 +940,21 @@ int array_user_compare(const void *a, const void *b) /* {{{ */
 
 #define PHP_ARRAY_CMP_FUNC_VARS \
    zend_fcall_info old_user_compare_fci; \
-   zend_fcall_info_cache old_user_compare_fci_cache \
+   zend_fcall_info_cache old_user_compare_fci_cache; \
+   zend_fcall_prepared old_user_compare_prepared \
 
 #define PHP_ARRAY_CMP_FUNC_BACKUP() \
    RuntimeModuleData &rdata = retrieve_runtime_module_data();\
    old_user_compare_fci = rdata.userCompareFci; \
    old_user_compare_fci_cache = rdata.userCompareFciCache; \
+   old_user_compare_prepared = rdata.userComparePrepared; \
    rdata.userCompareFciCache = empty_fcall_info_cache; \
+   rdata.userComparePrepared.call = NULL; \
 
 #define PHP_ARRAY_CMP_FUNC_RESTORE() \
    rdata.userCompareFci = old_user_compare_fci; \
    rdata.userCompareFciCache = old_user_compare_fci_cache; \
+   rdata.userComparePrepared = old_user_compare_prepared; \
 
 void array_usort(INTERNAL_FUNCTION_PARAMETERS, compare_func_t compare_func, zend_bool renumber) /* {{{ */
 {
@@ -967,7 +979,10 @@ void array_usort(INTERNAL_FUNCTION_PARAMETERS, compare_func_t compare_func, zend
    /* Copy array, so the in-place modifications will not be visible to the callback function */
    arr = zend_array_dup(arr);
 
+   /* the comparator runs O(n log n) times, its frame is pushed once */
+   zend_fcall_prepare(&rdata.userComparePrepared, &rdata.userCompareFciCache, 2);
    retval = zend_hash_sort(arr, compare_func, renumber) != FAILURE;
+   zend_fcall_prepared_release(&rdata.userComparePrepared);
 
    zval_ptr_dtor(array);
    ZVAL_ARR(array, arr);
@@ -1016,7 +1031,8 @@ int array_user_key_compare(const void *a, const void *b) /* {{{ */
    rdata.userCompareFci.retval = &retval;
    rdata.userCompareFci.no_separation = 0;
 
-   if (zend_call_function(&rdata.userCompareFci, &rdata.userCompareFciCache) == SUCCESS && Z_TYPE(retval) != IS_UNDEF) {
+   if (zend_call_prepared(&rdata.userComparePrepared, &rdata.userCompareFci, &rdata.userCompareFciCache) == SUCCESS &&
+       Z_TYPE(retval) != IS_UNDEF) {
       result = zval_get_long(&retval);
       zval_ptr_dtor(&retval);
    } else {
@@ -1265,7 +1281,7 @@ int array_walk(zval *array, zval *userdata, int recursive) /* {{{ */
 
    RuntimeModuleData &rdata = retrieve_runtime_module_data();
 
-   rdata.arrayWalkFci.param_count = 2;
+   rdata.arrayWalkFci.param_count = userdata ? 3 : 2;
    rdata.arrayWalkFci.params = args;
    rdata.arrayWalkFci.retval = &retval;
    rdata.arrayWalkFci.no_separation = 0;
@@ -1340,7 +1356,7 @@ int array_walk(zval *array, zval *userdata, int recursive) /* {{{ */
          ZVAL_COPY(&args[0], zv);
 
          /* Call the userland function */
-         result = zend_call_function(&rdata.arrayWalkFci, &rdata.arrayWalkFciCache);
+         result = zend_call_prepared(&rdata.arrayWalkPrepared, &rdata.arrayWalkFci, &rdata.arrayWalkFciCache);
          if (result == SUCCESS) {
             zval_ptr_dtor(&retval);
          }
@@ -1385,9 +1401,11 @@ PHP_FUNCTION(array_walk)
    zval *userdata = NULL;
    zend_fcall_info orig_array_walk_fci;
    zend_fcall_info_cache orig_array_walk_fci_cache;
+   zend_fcall_prepared orig_array_walk_prepared;
    RuntimeModuleData &rdata = retrieve_runtime_module_data();
    orig_array_walk_fci = rdata.arrayWalkFci;
    orig_array_walk_fci_cache = rdata.arrayWalkFciCache;
+   orig_array_walk_prepared = rdata.arrayWalkPrepared;
 
    ZEND_PARSE_PARAMETERS_START(2, 3)
          Z_PARAM_ARRAY_OR_OBJECT_EX(array, 0, 1)
@@ -1400,9 +1418,12 @@ PHP_FUNCTION(array_walk)
    return
          );
 
+   zend_fcall_prepare(&rdata.arrayWalkPrepared, &rdata.arrayWalkFciCache, userdata ? 3 : 2);
    array_walk(array, userdata, 0);
+   zend_fcall_prepared_release(&rdata.arrayWalkPrepared);
    rdata.arrayWalkFci = orig_array_walk_fci;
    rdata.arrayWalkFciCache = orig_array_walk_fci_cache;
+   rdata.arrayWalkPrepared = orig_array_walk_prepared;
    RETURN_TRUE;
 }
 
@@ -1412,10 +1433,12 @@ PHP_FUNCTION(array_walk_recursive)
    zval *userdata = NULL;
    zend_fcall_info orig_array_walk_fci;
    zend_fcall_info_cache orig_array_walk_fci_cache;
+   zend_fcall_prepared orig_array_walk_prepared;
 
    RuntimeModuleData &rdata = retrieve_runtime_module_data();
    orig_array_walk_fci = rdata.arrayWalkFci;
    orig_array_walk_fci_cache = rdata.arrayWalkFciCache;
+   orig_array_walk_prepared = rdata.arrayWalkPrepared;
 
    ZEND_PARSE_PARAMETERS_START(2, 3)
          Z_PARAM_ARRAY_OR_OBJECT_EX(array, 0, 1)
@@ -1428,14 +1451,133 @@ PHP_FUNCTION(array_walk_recursive)
    return
          );
 
+   zend_fcall_prepare(&rdata.arrayWalkPrepared, &rdata.arrayWalkFciCache, userdata ? 3 : 2);
    array_walk(array, userdata, 1);
+   zend_fcall_prepared_release(&rdata.arrayWalkPrepared);
    rdata.arrayWalkFci = orig_array_walk_fci;
    rdata.arrayWalkFciCache = orig_array_walk_fci_cache;
+   rdata.arrayWalkPrepared = orig_array_walk_prepared;
    RETURN_TRUE;
 }
 
 namespace {
 
+/// Scan the buckets of a packed array without holes for \p needle while
+/// every element has the type of the needle, the compares of such a run
+/// decide the search alone. Returns the position of the needle, or of the
+/// first element of another type, or \p count, \p found tells the first
+/// case apart.
+uint32_t packed_search_long(const Bucket *bucket, uint32_t count, zend_long needle, bool &found)
+{
+   found = false;
+   uint32_t idx = 0;
+#if defined(__SSE2__) && SIZEOF_ZEND_LONG == 8
+   /// one unaligned load covers the value and the type info of a bucket
+   const __m128i pattern = _mm_set_epi32(0, IS_LONG, static_cast<int>(static_cast<zend_ulong>(needle) >> 32),
+                                         static_cast<int>(needle));
+   for (; idx + 1 < count; idx += 2) {
+      int mask0 = _mm_movemask_epi8(_mm_cmpeq_epi32(
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i *>(&bucket[idx].val)), pattern));
+      int mask1 = _mm_movemask_epi8(_mm_cmpeq_epi32(
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i *>(&bucket[idx + 1].val)), pattern));
+      if (EXPECTED(((mask0 & mask1) & 0x0f00) == 0x0f00)) {
+         if (UNEXPECTED((mask0 & 0x00ff) == 0x00ff)) {
+            found = true;
+            return idx;
+         }
+         if (UNEXPECTED((mask1 & 0x00ff) == 0x00ff)) {
+            found = true;
+            return idx + 1;
+         }
+         continue;
+      }
+      break;
+   }
+#endif
+   for (; idx < count; ++idx) {
+      const zval *entry = &bucket[idx].val;
+      if (Z_TYPE_INFO_P(entry) != IS_LONG) {
+         return idx;
+      }
+      if (Z_LVAL_P(entry) == needle) {
+         found = true;
+         return idx;
+      }
+   }
+   return idx;
+}
+
+uint32_t packed_search_double(const Bucket *bucket, uint32_t count, double needle, bool &found)
+{
+   found = false;
+   uint32_t idx = 0;
+#ifdef __SSE2__
+   /// the values are compared as doubles, 0.0 matches -0.0 and NAN
+   /// matches nothing like with ==
+   const __m128i typePattern = _mm_set_epi32(0, IS_DOUBLE, 0, 0);
+   const __m128d value = _mm_set1_pd(needle);
+   for (; idx + 1 < count; idx += 2) {
+      __m128i entry0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&bucket[idx].val));
+      __m128i entry1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&bucket[idx + 1].val));
+      int typeMask = _mm_movemask_epi8(_mm_cmpeq_epi32(entry0, typePattern)) &
+            _mm_movemask_epi8(_mm_cmpeq_epi32(entry1, typePattern));
+      if (EXPECTED((typeMask & 0x0f00) == 0x0f00)) {
+         if (UNEXPECTED(_mm_movemask_pd(_mm_cmpeq_pd(_mm_castsi128_pd(entry0), value)) & 1)) {
+            found = true;
+            return idx;
+         }
+         if (UNEXPECTED(_mm_movemask_pd(_mm_cmpeq_pd(_mm_castsi128_pd(entry1), value)) & 1)) {
+            found = true;
+            return idx + 1;
+         }
+         continue;
+      }
+      break;
+   }
+#endif
+   for (; idx < count; ++idx) {
+      const zval *entry = &bucket[idx].val;
+      if (Z_TYPE_INFO_P(entry) != IS_DOUBLE) {
+         return idx;
+      }
+      if (Z_DVAL_P(entry) == needle) {
+         found = true;
+         return idx;
+      }
+   }
+   return idx;
+}
+
+inline void search_found(const Bucket *bucket, int behavior, zval *return_value)
+{
+   if (behavior == 0) {
+      RETURN_TRUE;
+   }
+   if (bucket->key) {
+      RETVAL_STR_COPY(bucket->key);
+   } else {
+      RETVAL_LONG(bucket->h);
+   }
+}
+
+/// Generic search from the bucket \p start on, \p equal compares the
+/// needle with an element.
+template <typename EqualType>
+bool search_buckets(HashTable *ht, uint32_t start, EqualType equal, int behavior, zval *return_value)
+{
+   for (uint32_t idx = start; idx < ht->nNumUsed; ++idx) {
+      Bucket *bucket = ht->arData + idx;
+      if (UNEXPECTED(Z_TYPE(bucket->val) == IS_UNDEF)) {
+         continue;
+      }
+      if (equal(&bucket->val)) {
+         search_found(bucket, behavior, return_value);
+         return true;
+      }
+   }
+   return false;
+}
+
 /* void php_search_array(INTERNAL_FUNCTION_PARAMETERS, int behavior)
  * 0 = return boolean
  * 1 = return key
@@ -1443,10 +1585,9 @@ namespace {
 inline void search_array(INTERNAL_FUNCTION_PARAMETERS, int behavior)
 {
    zval *value,				/* value to check for */
-         *array,				/* array to check in */
-         *entry;				/* pointer to array entry */
-   zend_ulong num_idx;
-   zend_string *str_idx;
+         *array;				/* array to check in */
+   HashTable *ht;
+   uint32_t start = 0;
    zend_bool strict = 0;		/* strict comparison or not */
 
    ZEND_PARSE_PARAMETERS_START(2, 3)
@@ -1456,72 +1597,45 @@ inline void search_array(INTERNAL_FUNCTION_PARAMETERS, int behavior)
          Z_PARAM_BOOL(strict)
          ZEND_PARSE_PARAMETERS_END();
 
-   if (strict) {
-      ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(array), num_idx, str_idx, entry) {
-         ZVAL_DEREF(entry);
-         if (fast_is_identical_function(value, entry)) {
-            if (behavior == 0) {
-               RETURN_TRUE;
-            } else {
-               if (str_idx) {
-                  RETVAL_STR_COPY(str_idx);
-               } else {
-                  RETVAL_LONG(num_idx);
-               }
-               return;
-            }
-         }
-      } ZEND_HASH_FOREACH_END();
-   } else {
+   ht = Z_ARRVAL_P(array);
+   /* Packed arrays of longs or doubles are scanned by the kernels until the
+    * first element of another type, the generic loop goes on from there */
+   if (HT_IS_PACKED(ht) && HT_IS_WITHOUT_HOLES(ht) &&
+       (Z_TYPE_P(value) == IS_LONG || Z_TYPE_P(value) == IS_DOUBLE)) {
+      bool found;
       if (Z_TYPE_P(value) == IS_LONG) {
-         ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(array), num_idx, str_idx, entry) {
-            if (fast_equal_check_long(value, entry)) {
-               if (behavior == 0) {
-                  RETURN_TRUE;
-               } else {
-                  if (str_idx) {
-                     RETVAL_STR_COPY(str_idx);
-                  } else {
-                     RETVAL_LONG(num_idx);
-                  }
-                  return;
-               }
-            }
-         } ZEND_HASH_FOREACH_END();
-      } else if (Z_TYPE_P(value) == IS_STRING) {
-         ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(array), num_idx, str_idx, entry) {
-            if (fast_equal_check_string(value, entry)) {
-               if (behavior == 0) {
-                  RETURN_TRUE;
-               } else {
-                  if (str_idx) {
-                     RETVAL_STR_COPY(str_idx);
-                  } else {
-                     RETVAL_LONG(num_idx);
-                  }
-                  return;
-               }
-            }
-         } ZEND_HASH_FOREACH_END();
+         start = packed_search_long(ht->arData, ht->nNumUsed, Z_LVAL_P(value), found);
       } else {
-         ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(array), num_idx, str_idx, entry) {
-            if (fast_equal_check_function(value, entry)) {
-               if (behavior == 0) {
-                  RETURN_TRUE;
-               } else {
-                  if (str_idx) {
-                     RETVAL_STR_COPY(str_idx);
-                  } else {
-                     RETVAL_LONG(num_idx);
-                  }
-                  return;
-               }
-            }
-         } ZEND_HASH_FOREACH_END();
+         start = packed_search_double(ht->arData, ht->nNumUsed, Z_DVAL_P(value), found);
+      }
+      if (found) {
+         search_found(ht->arData + start, behavior, return_value);
+         return;
       }
    }
 
-   RETURN_FALSE;
+   bool found;
+   if (strict) {
+      found = search_buckets(ht, start, [value](zval *entry) {
+         ZVAL_DEREF(entry);
+         return fast_is_identical_function(value, entry);
+      }, behavior, return_value);
+   } else if (Z_TYPE_P(value) == IS_LONG) {
+      found = search_buckets(ht, start, [value](zval *entry) {
+         return fast_equal_check_long(value, entry);
+      }, behavior, return_value);
+   } else if (Z_TYPE_P(value) == IS_STRING) {
+      found = search_buckets(ht, start, [value](zval *entry) {
+         return fast_equal_check_string(value, entry);
+      }, behavior, return_value);
+   } else {
+      found = search_buckets(ht, start, [value](zval *entry) {
+         return fast_equal_check_function(value, entry);
+      }, behavior, return_value);
+   }
+   if (!found) {
+      RETURN_FALSE;
+   }
 }
 } // anonymous namespace
 
@@ -2461,6 +2575,8 @@ PHP_FUNCTION(compact)
    } else {
       array_init_size(return_value, num_args);
    }
+   /* the result is mostly a small option bag */
+   zend_hash_real_init_small(Z_ARRVAL_P(return_value));
 
    for (i = 0; i < num_args; i++) {
       array_compact_var(symbol_table, return_value, &args[i]);
@@ -2485,6 +2601,9 @@ PHP_FUNCTION(array_fill)
       } else if (UNEXPECTED(start_key > ZEND_LONG_MAX - num + 1)) {
          php_error_docref(NULL, E_WARNING, "Cannot add element to the array as the next element is already occupied");
          RETURN_FALSE;
+      } else if (lazy_range_consumed_by_foreach(execute_data)) {
+         /* foreach (array_fill(...) as ...) never sees the array */
+         lazy_fill_init(return_value, start_key, (uint32_t)num, val);
       } else if (EXPECTED(start_key >= 0) && EXPECTED(start_key < num)) {
          /* create packed array */
          Bucket *p;
@@ -2589,15 +2708,13 @@ PHP_FUNCTION(array_fill_keys)
    zend_hash_real_init_packed(Z_ARRVAL_P(return_value)); \
 } while (0)
 
-#define RANGE_CHECK_LONG_INIT_ARRAY(start, end) do { \
+#define RANGE_CHECK_LONG_SIZE(start, end) do { \
    zend_ulong __calc_size = (start - end) / lstep; \
    if (__calc_size >= HT_MAX_SIZE - 1) { \
    php_error_docref(NULL, E_WARNING, "The supplied range exceeds the maximum array size: start=" ZEND_LONG_FMT " end=" ZEND_LONG_FMT, end, start); \
    RETURN_FALSE; \
 } \
    size = (uint32_t)(__calc_size + 1); \
-   array_init_size(return_value, size); \
-   zend_hash_real_init_packed(Z_ARRVAL_P(return_value)); \
 } while (0)
 
 namespace {
@@ -2934,7 +3051,14 @@ long_str:
             goto err;
          }
 
-         RANGE_CHECK_LONG_INIT_ARRAY(low, high);
+         RANGE_CHECK_LONG_SIZE(low, high);
+         /* foreach (range(...) as ...) never sees the array */
+         if (lazy_range_consumed_by_foreach(execute_data)) {
+            lazy_range_init(return_value, low, (zend_ulong)0 - lstep, size);
+            return;
+         }
+         array_init_size(return_value, size);
+         zend_hash_real_init_packed(Z_ARRVAL_P(return_value));
 
          ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(return_value)) {
             for (i = 0; i < size; ++i) {
@@ -2948,7 +3072,13 @@ long_str:
             goto err;
          }
 
-         RANGE_CHECK_LONG_INIT_ARRAY(high, low);
+         RANGE_CHECK_LONG_SIZE(high, low);
+         if (lazy_range_consumed_by_foreach(execute_data)) {
+            lazy_range_init(return_value, low, lstep, size);
+            return;
+         }
+         array_init_size(return_value, size);
+         zend_hash_real_init_packed(Z_ARRVAL_P(return_value));
 
          ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(return_value)) {
             for (i = 0; i < size; ++i) {
@@ -2970,7 +3100,7 @@ err:
 }
 
 #undef RANGE_CHECK_DOUBLE_INIT_ARRAY
-#undef RANGE_CHECK_LONG_INIT_ARRAY
+#undef RANGE_CHECK_LONG_SIZE
 
 namespace {
 
@@ -3541,6 +3671,38 @@ PHP_FUNCTION(array_slice)
       return;
    }
 
+   /* A packed array without holes is addressed by position, the whole
+    * array slices to itself and a window is copied without walking the
+    * elements before it */
+   if (HT_IS_PACKED(Z_ARRVAL_P(input)) && HT_IS_WITHOUT_HOLES(Z_ARRVAL_P(input))) {
+      HashTable *ht = Z_ARRVAL_P(input);
+      Bucket *p, *end;
+
+      if (offset == 0 && length == num_in &&
+          ht->nNextFreeElement == num_in && ht->nInternalPointer == 0) {
+         ZVAL_COPY(return_value, input);
+         return;
+      }
+      if (!preserve_keys || offset == 0) {
+         array_init_size(return_value, (uint32_t)length);
+         zend_hash_real_init_packed(Z_ARRVAL_P(return_value));
+         p = ht->arData + offset;
+         end = p + length;
+         ZEND_HASH_FILL_PACKED(Z_ARRVAL_P(return_value)) {
+            for (; p != end; p++) {
+               entry = &p->val;
+               if (UNEXPECTED(Z_ISREF_P(entry)) &&
+                   UNEXPECTED(Z_REFCOUNT_P(entry) == 1)) {
+                  entry = Z_REFVAL_P(entry);
+               }
+               Z_TRY_ADDREF_P(entry);
+               ZEND_HASH_FILL_ADD(entry);
+            }
+         } ZEND_HASH_FILL_END();
+         return;
+      }
+   }
+
    /* Initialize returned array */
    array_init_size(return_value, (uint32_t)length);
 
@@ -4941,7 +5103,89 @@ PHP_FUNCTION(array_intersect_ukey)
 
 PHP_FUNCTION(array_intersect)
 {
-   array_intersect(INTERNAL_FUNCTION_PARAM_PASSTHRU, INTERSECT_NORMAL, INTERSECT_COMP_DATA_INTERNAL, INTERSECT_COMP_KEY_INTERNAL);
+   zval *args;
+   int argc, i;
+   HashTable *first;
+   HashTable candidates;
+   zval *value, *count;
+   zend_string *str, *tmp_str, *key;
+   zend_ulong idx;
+   zval zero;
+
+   if (ZEND_NUM_ARGS() < 2) {
+      php_error_docref(NULL, E_WARNING, "at least %d parameters are required, %d given", 2, ZEND_NUM_ARGS());
+      return;
+   }
+
+   ZEND_PARSE_PARAMETERS_START(1, -1)
+         Z_PARAM_VARIADIC('+', args, argc)
+         ZEND_PARSE_PARAMETERS_END();
+
+   for (i = 0; i < argc; i++) {
+      if (Z_TYPE(args[i]) != IS_ARRAY) {
+         php_error_docref(NULL, E_WARNING, "Expected parameter %d to be an array, %s given", i + 1, zend_zval_type_name(&args[i]));
+         RETURN_NULL();
+      }
+   }
+
+   first = Z_ARRVAL(args[0]);
+   if (zend_hash_num_elements(first) == 0) {
+      POLAR_ZVAL_EMPTY_ARRAY(return_value);
+      return;
+   }
+
+   /* the string values of the first array are the candidates, the count of
+    * a candidate tells how many of the following arrays in a row hold it */
+   ZVAL_LONG(&zero, 0);
+   zend_hash_init(&candidates, zend_hash_num_elements(first), NULL, NULL, 0);
+   ZEND_HASH_FOREACH_VAL_IND(first, value) {
+      str = zval_get_tmp_string(value, &tmp_str);
+      zend_hash_add(&candidates, str, &zero);
+      zend_tmp_string_release(tmp_str);
+      if (UNEXPECTED(EG(exception))) {
+         /* an error handler threw on a value without string form */
+         zend_hash_destroy(&candidates);
+         return;
+      }
+   } ZEND_HASH_FOREACH_END();
+
+   for (i = 1; i < argc; i++) {
+      ZEND_HASH_FOREACH_VAL_IND(Z_ARRVAL(args[i]), value) {
+         str = zval_get_tmp_string(value, &tmp_str);
+         count = zend_hash_find(&candidates, str);
+         if (count && Z_LVAL_P(count) == i - 1) {
+            Z_LVAL_P(count) = i;
+         }
+         zend_tmp_string_release(tmp_str);
+         if (UNEXPECTED(EG(exception))) {
+            zend_hash_destroy(&candidates);
+            return;
+         }
+      } ZEND_HASH_FOREACH_END();
+   }
+
+   /* copy the elements of the first array held by all the others, in order */
+   array_init_size(return_value, zend_hash_num_elements(first));
+   ZEND_HASH_FOREACH_KEY_VAL_IND(first, idx, key, value) {
+      str = zval_get_tmp_string(value, &tmp_str);
+      count = zend_hash_find(&candidates, str);
+      if (count && Z_LVAL_P(count) == argc - 1) {
+         if (key) {
+            value = zend_hash_add_new(Z_ARRVAL_P(return_value), key, value);
+         } else {
+            value = zend_hash_index_add_new(Z_ARRVAL_P(return_value), idx, value);
+         }
+         zval_add_ref(value);
+      }
+      zend_tmp_string_release(tmp_str);
+      if (UNEXPECTED(EG(exception))) {
+         zend_hash_destroy(&candidates);
+         zval_ptr_dtor(return_value);
+         RETURN_NULL();
+      }
+   } ZEND_HASH_FOREACH_END();
+
+   zend_hash_destroy(&candidates);
 }
 
 PHP_FUNCTION(array_uintersect)
@@ -5870,6 +6114,7 @@ PHP_FUNCTION(array_reduce)
    zval retval;
    zend_fcall_info fci;
    zend_fcall_info_cache fci_cache = empty_fcall_info_cache;
+   zend_fcall_prepared prepared;
    zval *initial = NULL;
    HashTable *htbl;
 
@@ -5900,22 +6145,25 @@ PHP_FUNCTION(array_reduce)
    fci.retval = &retval;
    fci.param_count = 2;
    fci.no_separation = 0;
+   zend_fcall_prepare(&prepared, &fci_cache, 2);
 
    ZEND_HASH_FOREACH_VAL(htbl, operand) {
       ZVAL_COPY_VALUE(&args[0], &result);
       ZVAL_COPY(&args[1], operand);
       fci.params = args;
 
-      if (zend_call_function(&fci, &fci_cache) == SUCCESS && Z_TYPE(retval) != IS_UNDEF) {
+      if (zend_call_prepared(&prepared, &fci, &fci_cache) == SUCCESS && Z_TYPE(retval) != IS_UNDEF) {
          zval_ptr_dtor(&args[1]);
          zval_ptr_dtor(&args[0]);
          ZVAL_COPY_VALUE(&result, &retval);
       } else {
          zval_ptr_dtor(&args[1]);
          zval_ptr_dtor(&args[0]);
+         zend_fcall_prepared_release(&prepared);
          return;
       }
    } ZEND_HASH_FOREACH_END();
+   zend_fcall_prepared_release(&prepared);
 
    RETVAL_ZVAL(&result, 1, 1);
 }
@@ -5932,6 +6180,7 @@ PHP_FUNCTION(array_filter)
    zend_string *string_key;
    zend_fcall_info fci = empty_fcall_info;
    zend_fcall_info_cache fci_cache = empty_fcall_info_cache;
+   zend_fcall_prepared prepared;
    zend_ulong num_key;
 
    ZEND_PARSE_PARAMETERS_START(1, 3)
@@ -5958,6 +6207,7 @@ PHP_FUNCTION(array_filter)
          key = &args[0];
       }
    }
+   zend_fcall_prepare(&prepared, &fci_cache, fci.param_count);
 
    ZEND_HASH_FOREACH_KEY_VAL_IND(Z_ARRVAL_P(array), num_key, string_key, operand) {
       if (have_callback) {
@@ -5974,7 +6224,7 @@ PHP_FUNCTION(array_filter)
          }
          fci.params = args;
 
-         if (zend_call_function(&fci, &fci_cache) == SUCCESS) {
+         if (zend_call_prepared(&prepared, &fci, &fci_cache) == SUCCESS) {
             int retval_true;
 
             zval_ptr_dtor(&args[0]);
@@ -5991,6 +6241,7 @@ PHP_FUNCTION(array_filter)
             if (use_type == ARRAY_FILTER_USE_BOTH) {
                zval_ptr_dtor(&args[1]);
             }
+            zend_fcall_prepared_release(&prepared);
             return;
          }
       } else if (!zend_is_true(operand)) {
@@ -6004,6 +6255,7 @@ PHP_FUNCTION(array_filter)
       }
       zval_add_ref(operand);
    } ZEND_HASH_FOREACH_END();
+   zend_fcall_prepared_release(&prepared);
 }
 
 
@@ -6014,6 +6266,7 @@ PHP_FUNCTION(array_map)
    zval result;
    zend_fcall_info fci = empty_fcall_info;
    zend_fcall_info_cache fci_cache = empty_fcall_info_cache;
+   zend_fcall_prepared prepared;
    int i;
    uint32_t k, maxlen = 0;
 
@@ -6044,6 +6297,7 @@ PHP_FUNCTION(array_map)
 
       array_init_size(return_value, maxlen);
       zend_hash_real_init(Z_ARRVAL_P(return_value), HT_FLAGS(Z_ARRVAL(arrays[0])) & HASH_FLAG_PACKED);
+      zend_fcall_prepare(&prepared, &fci_cache, 1);
 
       ZEND_HASH_FOREACH_KEY_VAL_IND(Z_ARRVAL(arrays[0]), num_key, str_key, zv) {
          fci.retval = &result;
@@ -6052,9 +6306,10 @@ PHP_FUNCTION(array_map)
          fci.no_separation = 0;
 
          ZVAL_COPY(&arg, zv);
-         ret = zend_call_function(&fci, &fci_cache);
+         ret = zend_call_prepared(&prepared, &fci, &fci_cache);
          i_zval_ptr_dtor(&arg ZEND_FILE_LINE_CC);
          if (ret != SUCCESS || Z_TYPE(result) == IS_UNDEF) {
+            zend_fcall_prepared_release(&prepared);
             zend_array_destroy(Z_ARR_P(return_value));
             RETURN_NULL();
          }
@@ -6064,6 +6319,7 @@ PHP_FUNCTION(array_map)
             zend_hash_index_add_new(Z_ARRVAL_P(return_value), num_key, &result);
          }
       } ZEND_HASH_FOREACH_END();
+      zend_fcall_prepared_release(&prepared);
    } else {
       uint32_t *array_pos = (HashPosition *)ecalloc(n_arrays, sizeof(HashPosition));
 
@@ -6114,6 +6370,7 @@ PHP_FUNCTION(array_map)
       } else {
          zval *params = (zval *)safe_emalloc(n_arrays, sizeof(zval), 0);
 
+         zend_fcall_prepare(&prepared, &fci_cache, n_arrays);
          /* We iterate through all the arrays at once. */
          for (k = 0; k < maxlen; k++) {
             for (i = 0; i < n_arrays; i++) {
@@ -6138,7 +6395,8 @@ PHP_FUNCTION(array_map)
             fci.params = params;
             fci.no_separation = 0;
 
-            if (zend_call_function(&fci, &fci_cache) != SUCCESS || Z_TYPE(result) == IS_UNDEF) {
+            if (zend_call_prepared(&prepared, &fci, &fci_cache) != SUCCESS || Z_TYPE(result) == IS_UNDEF) {
+               zend_fcall_prepared_release(&prepared);
                efree(array_pos);
                zend_array_destroy(Z_ARR_P(return_value));
                for (i = 0; i < n_arrays; i++) {
@@ -6155,12 +6413,152 @@ PHP_FUNCTION(array_map)
             zend_hash_next_index_insert_new(Z_ARRVAL_P(return_value), &result);
          }
 
+         zend_fcall_prepared_release(&prepared);
          efree(params);
       }
       efree(array_pos);
    }
 }
 
+namespace {
+
+/// below this size the workers cost more than they save
+constexpr uint32_t sg_parallelMapMinSize = 65536;
+constexpr uint32_t sg_parallelMapBlockSize = 4096;
+
+/// the internal function \p callback names when it is marked thread safe
+zend_function *parallel_map_function(zval *callback)
+{
+   if (Z_TYPE_P(callback) != IS_STRING) {
+      return nullptr;
+   }
+   zend_string *name = Z_STR_P(callback);
+   zend_string *lcname;
+   if (ZSTR_LEN(name) > 0 && ZSTR_VAL(name)[0] == '\\') {
+      lcname = zend_string_alloc(ZSTR_LEN(name) - 1, 0);
+      zend_str_tolower_copy(ZSTR_VAL(lcname), ZSTR_VAL(name) + 1, ZSTR_LEN(name) - 1);
+   } else {
+      lcname = zend_string_tolower(name);
+   }
+   zend_function *func = reinterpret_cast<zend_function *>(
+            zend_hash_find_ptr(EG(function_table), lcname));
+   zend_string_release_ex(lcname, 0);
+   if (func && func->type == ZEND_INTERNAL_FUNCTION &&
+       (func->common.fn_flags & ZEND_ACC_THREAD_SAFE)) {
+      return func;
+   }
+   return nullptr;
+}
+
+/// runs \p func on the scalar values of the block on the calling thread,
+/// the other slots are left undef for the executor thread
+void parallel_map_block(zend_function *func, Bucket *input, Bucket *output, uint32_t begin, uint32_t end)
+{
+   /// a call frame off the VM stack, the handler only reads its arguments
+   zval frame[ZEND_CALL_FRAME_SLOT + 1];
+   zend_execute_data *call = reinterpret_cast<zend_execute_data *>(frame);
+   zval *arg = ZEND_CALL_ARG(call, 1);
+
+   memset(call, 0, sizeof(zend_execute_data));
+   call->func = func;
+   ZEND_CALL_NUM_ARGS(call) = 1;
+   for (uint32_t i = begin; i < end; ++i) {
+      zval *entry = &input[i].val;
+      Bucket *p = output + i;
+      p->h = i;
+      p->key = NULL;
+      if (Z_TYPE_P(entry) >= IS_NULL && Z_TYPE_P(entry) <= IS_DOUBLE) {
+         ZVAL_COPY_VALUE(arg, entry);
+         ZVAL_NULL(&p->val);
+         func->internal_function.handler(call, &p->val);
+      } else {
+         ZVAL_UNDEF(&p->val);
+      }
+   }
+}
+
+} // anonymous namespace
+
+///
+/// array_map_parallel(callable $callback, array $input, array ...$arrays) is
+/// array_map(), a single large packed array is split across the worker
+/// threads when the callback names an internal function flagged
+/// ZEND_ACC_THREAD_SAFE.
+///
+PHP_FUNCTION(array_map_parallel)
+{
+   zval *callback;
+   zval *arrays = nullptr;
+   zend_function *func;
+   HashTable *in;
+   HashTable *out;
+   uint32_t size;
+   int nArrays = 0;
+
+   ZEND_PARSE_PARAMETERS_START(2, -1)
+         Z_PARAM_ZVAL(callback)
+         Z_PARAM_VARIADIC('+', arrays, nArrays)
+         ZEND_PARSE_PARAMETERS_END();
+
+   if (nArrays != 1 || Z_TYPE(arrays[0]) != IS_ARRAY) {
+      ZEND_FN(array_map)(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+      return;
+   }
+   in = Z_ARRVAL(arrays[0]);
+   size = zend_hash_num_elements(in);
+   func = parallel_map_function(callback);
+   if (!func || size < sg_parallelMapMinSize ||
+       !HT_IS_PACKED(in) || !HT_IS_WITHOUT_HOLES(in)) {
+      ZEND_FN(array_map)(INTERNAL_FUNCTION_PARAM_PASSTHRU);
+      return;
+   }
+
+   /* every slot is written by exactly one block */
+   array_init_size(return_value, size);
+   out = Z_ARRVAL_P(return_value);
+   zend_hash_real_init_packed(out);
+   out->nNumUsed = size;
+   out->nNumOfElements = size;
+   out->nNextFreeElement = size;
+   uint32_t blocks = (size + sg_parallelMapBlockSize - 1) / sg_parallelMapBlockSize;
+   polar::utils::parallel::for_each_n(polar::utils::parallel::par, 0u, blocks, [&](uint32_t block) {
+      uint32_t begin = block * sg_parallelMapBlockSize;
+      uint32_t end = std::min(begin + sg_parallelMapBlockSize, size);
+      parallel_map_block(func, in->arData, out->arData, begin, end);
+   });
+
+   /* strings, arrays, objects and references go through a regular call */
+   zend_fcall_info fci;
+   zend_fcall_info_cache fci_cache;
+   zend_fcall_prepared prepared;
+   zval arg;
+
+   if (zend_fcall_info_init(callback, 0, &fci, &fci_cache, NULL, NULL) != SUCCESS) {
+      zend_array_destroy(out);
+      RETURN_NULL();
+   }
+   zend_fcall_prepare(&prepared, &fci_cache, 1);
+   for (uint32_t i = 0; i < size; ++i) {
+      zval *result = &out->arData[i].val;
+      if (Z_TYPE_P(result) != IS_UNDEF) {
+         continue;
+      }
+      fci.retval = result;
+      fci.param_count = 1;
+      fci.params = &arg;
+      fci.no_separation = 0;
+      ZVAL_COPY(&arg, &in->arData[i].val);
+      int ret = zend_call_prepared(&prepared, &fci, &fci_cache);
+      i_zval_ptr_dtor(&arg ZEND_FILE_LINE_CC);
+      if (ret != SUCCESS || Z_TYPE_P(result) == IS_UNDEF) {
+         zend_fcall_prepared_release(&prepared);
+         zend_array_destroy(out);
+         RETURN_NULL();
+      }
+   }
+   zend_fcall_prepared_release(&prepared);
+}
+
 PHP_FUNCTION(array_key_exists)
 {
    zval *key;					/* key to check for */
@@ -6226,6 +6624,34 @@ PHP_FUNCTION(array_chunk)
 
    array_init_size(return_value, (uint32_t)(((num_in - 1) / size) + 1));
 
+   /* The chunks of a packed array without holes are contiguous bucket
+    * ranges, they are filled without hashing and at their final size */
+   if (!preserve_keys && HT_IS_PACKED(Z_ARRVAL_P(input)) &&
+       HT_IS_WITHOUT_HOLES(Z_ARRVAL_P(input))) {
+      Bucket *p = Z_ARRVAL_P(input)->arData;
+      Bucket *end = p + num_in;
+
+      while (p != end) {
+         Bucket *chunk_end = (end - p) > size ? p + size : end;
+
+         array_init_size(&chunk, (uint32_t)(chunk_end - p));
+         zend_hash_real_init_packed(Z_ARRVAL(chunk));
+         ZEND_HASH_FILL_PACKED(Z_ARRVAL(chunk)) {
+            for (; p != chunk_end; p++) {
+               entry = &p->val;
+               if (UNEXPECTED(Z_ISREF_P(entry)) &&
+                   UNEXPECTED(Z_REFCOUNT_P(entry) == 1)) {
+                  entry = Z_REFVAL_P(entry);
+               }
+               Z_TRY_ADDREF_P(entry);
+               ZEND_HASH_FILL_ADD(entry);
+            }
+         } ZEND_HASH_FILL_END();
+         add_next_index_zval(return_value, &chunk);
+      }
+      return;
+   }
+
    ZVAL_UNDEF(&chunk);
 
    ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(input), num_key, str_key, entry) {
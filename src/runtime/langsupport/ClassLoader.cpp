@@ -10,7 +10,9 @@
 // Created by polarboy on 2019/02/14.
 
 #include "polarphp/runtime/langsupport/ClassLoader.h"
+#include "polarphp/runtime/langsupport/ClassMap.h"
 #include "polarphp/runtime/langsupport/StdExceptions.h"
+#include "polarphp/runtime/ExecEnv.h"
 #include "polarphp/runtime/Spprintf.h"
 #include "polarphp/runtime/Utils.h"
 
@@ -30,7 +32,8 @@ ClassLoaderModuleData &retrieve_classloader_module_data()
       0,
       0,
       nullptr,
-            nullptr
+      nullptr,
+      nullptr
    };
    return classLoaderModuleData;
 }
@@ -304,28 +307,14 @@ PHP_FUNCTION(set_autoload_file_extensions)
 }
 
 namespace {
-int default_autoload_handler(zend_string *className, zend_string *lc_name, const char *ext, int ext_len)
+int load_class_file(zend_string *lc_name, const char *classFile, int classFileLen)
 {
-   char *classFile;
-   int classFileLen;
    zval dummy;
    zend_file_handle file_handle;
    zend_op_array *new_op_array;
    zval result;
    int ret;
 
-   classFileLen = (int)polar_spprintf(&classFile, 0, "%s%.*s", ZSTR_VAL(lc_name), ext_len, ext);
-
-#if DEFAULT_SLASH != '\\'
-   {
-      char *ptr = classFile;
-      char *end = ptr + classFileLen;
-
-      while ((ptr = reinterpret_cast<char *>(memchr(ptr, '\\', (end - ptr)))) != nullptr) {
-         *ptr = DEFAULT_SLASH;
-      }
-   }
-#endif
    /// review here, we use zend_stream_open instead of php_stream_open_for_zend_ex
    /// because polarphp does not use php stream
    ret = zend_stream_open(classFile, &file_handle);
@@ -355,14 +344,77 @@ int default_autoload_handler(zend_string *className, zend_string *lc_name, const
          if (!EG(exception)) {
             zval_ptr_dtor(&result);
          }
-
-         efree(classFile);
          return zend_hash_exists(EG(class_table), lc_name);
       }
    }
-   efree(classFile);
    return 0;
 }
+
+int default_autoload_handler(zend_string *className, zend_string *lc_name, const char *ext, int ext_len)
+{
+   char *classFile;
+   int classFileLen;
+   int ret;
+
+   classFileLen = (int)polar_spprintf(&classFile, 0, "%s%.*s", ZSTR_VAL(lc_name), ext_len, ext);
+
+#if DEFAULT_SLASH != '\\'
+   {
+      char *ptr = classFile;
+      char *end = ptr + classFileLen;
+
+      while ((ptr = reinterpret_cast<char *>(memchr(ptr, '\\', (end - ptr)))) != nullptr) {
+         *ptr = DEFAULT_SLASH;
+      }
+   }
+#endif
+   ret = load_class_file(lc_name, classFile, classFileLen);
+   efree(classFile);
+   return ret;
+}
+
+void split_file_extensions(zend_string *fileExts, std::vector<std::string> &extensions)
+{
+   StringRef exts = fileExts ? StringRef(ZSTR_VAL(fileExts), ZSTR_LEN(fileExts))
+                             : StringRef(CLASS_LOADER_DEFAULT_FILE_EXTENSIONS);
+   while (!exts.empty()) {
+      std::pair<StringRef, StringRef> parts = exts.split(',');
+      if (!parts.first.empty()) {
+         extensions.push_back(parts.first.getStr());
+      }
+      exts = parts.second;
+   }
+}
+
+bool collect_class_map_roots(zval *roots, std::vector<std::string> &rootPaths)
+{
+   char realPath[MAXPATHLEN];
+   zval *root;
+   if (Z_TYPE_P(roots) == IS_STRING) {
+      if (!VCWD_REALPATH(Z_STRVAL_P(roots), realPath)) {
+         php_error_docref(nullptr, E_WARNING, "Class map root %s does not exist", Z_STRVAL_P(roots));
+         return false;
+      }
+      rootPaths.push_back(realPath);
+      return true;
+   }
+   if (Z_TYPE_P(roots) != IS_ARRAY) {
+      php_error_docref(nullptr, E_WARNING, "array or string expected");
+      return false;
+   }
+   ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(roots), root) {
+      zend_string *path = zval_get_string(root);
+      if (!VCWD_REALPATH(ZSTR_VAL(path), realPath)) {
+         php_error_docref(nullptr, E_WARNING, "Class map root %s does not exist", ZSTR_VAL(path));
+         zend_string_release_ex(path, 0);
+         return false;
+      }
+      rootPaths.push_back(realPath);
+      zend_string_release_ex(path, 0);
+   } ZEND_HASH_FOREACH_END();
+   return true;
+}
+
 } // anonymous namespace
 
 PHP_FUNCTION(default_class_loader)
@@ -384,6 +436,15 @@ PHP_FUNCTION(default_class_loader)
    }
 
    lc_name = zend_string_tolower(className);
+   if (CLASS_LOADER_G(classMap)) {
+      /// the class map is authoritative, a miss does not probe the filesystem
+      StringRef classFile;
+      if (CLASS_LOADER_G(classMap)->lookup(StringRef(ZSTR_VAL(lc_name), ZSTR_LEN(lc_name)), classFile)) {
+         load_class_file(lc_name, classFile.getData(), (int)classFile.getSize());
+      }
+      zend_string_free(lc_name);
+      return;
+   }
    while (pos && *pos && !EG(exception)) {
       pos1 = strchr(pos, ',');
       if (pos1) {
@@ -400,6 +461,75 @@ PHP_FUNCTION(default_class_loader)
    zend_string_free(lc_name);
 }
 
+///
+/// proto int build_class_map(string index_file, mixed roots [, string file_extensions])
+/// Scan the roots and write the class name index, returns the number of classes
+///
+PHP_FUNCTION(build_class_map)
+{
+   zend_string *indexFile;
+   zval *roots;
+   zend_string *fileExts = CLASS_LOADER_G(autoloadExtensions);
+   std::vector<std::string> rootPaths;
+   std::vector<std::string> extensions;
+
+   if (zend_parse_parameters(ZEND_NUM_ARGS(), "Pz|S", &indexFile, &roots, &fileExts) == FAILURE) {
+      RETURN_FALSE;
+   }
+   if (!collect_class_map_roots(roots, rootPaths)) {
+      RETURN_FALSE;
+   }
+   split_file_extensions(fileExts, extensions);
+   long count = ClassMap::build(StringRef(ZSTR_VAL(indexFile), ZSTR_LEN(indexFile)), rootPaths, extensions);
+   if (count < 0) {
+      php_error_docref(nullptr, E_WARNING, "Unable to write class map %s", ZSTR_VAL(indexFile));
+      RETURN_FALSE;
+   }
+   RETURN_LONG(count);
+}
+
+///
+/// proto bool register_class_map(string index_file [, mixed roots])
+/// Make default_class_loader() resolve classes from the index, when roots are
+/// given the index is brought up to date first
+///
+PHP_FUNCTION(register_class_map)
+{
+   zend_string *indexFile;
+   zval *roots = nullptr;
+   StringRef indexPath;
+
+   if (zend_parse_parameters(ZEND_NUM_ARGS(), "P|z", &indexFile, &roots) == FAILURE) {
+      RETURN_FALSE;
+   }
+   indexPath = StringRef(ZSTR_VAL(indexFile), ZSTR_LEN(indexFile));
+   ClassMap *current = CLASS_LOADER_G(classMap).get();
+   if (current && current->getIndexPath() == indexPath && !roots) {
+      RETURN_TRUE;
+   }
+   std::unique_ptr<ClassMap> classMap = ClassMap::open(indexPath);
+   if (roots && (!classMap || classMap->isStale())) {
+      std::vector<std::string> rootPaths;
+      std::vector<std::string> extensions;
+      if (!collect_class_map_roots(roots, rootPaths)) {
+         RETURN_FALSE;
+      }
+      split_file_extensions(CLASS_LOADER_G(autoloadExtensions), extensions);
+      classMap.reset();
+      if (ClassMap::build(indexPath, rootPaths, extensions) < 0) {
+         php_error_docref(nullptr, E_WARNING, "Unable to write class map %s", ZSTR_VAL(indexFile));
+         RETURN_FALSE;
+      }
+      classMap = ClassMap::open(indexPath);
+   }
+   if (!classMap) {
+      php_error_docref(nullptr, E_WARNING, "%s is not a valid class map", ZSTR_VAL(indexFile));
+      RETURN_FALSE;
+   }
+   CLASS_LOADER_G(classMap) = std::move(classMap);
+   RETURN_TRUE;
+}
+
 PHP_FUNCTION(retrieve_registered_class_loaders)
 {
 
@@ -772,6 +902,13 @@ PHP_MINIT_FUNCTION(classloader)
    return SUCCESS;
 }
 
+PHP_MSHUTDOWN_FUNCTION(classloader)
+{
+   /// the maps of the other threads go with their thread local data
+   CLASS_LOADER_G(classMap).reset();
+   return SUCCESS;
+}
+
 PHP_RINIT_FUNCTION(classloader)
 {
    CLASS_LOADER_G(autoloadExtensions) = nullptr;
@@ -0,0 +1,699 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/02/20.
+
+#include "polarphp/runtime/langsupport/ClassMap.h"
+#include "polarphp/runtime/ScanDir.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <sys/stat.h>
+
+namespace polar {
+namespace runtime {
+
+namespace {
+
+const char CLASS_MAP_MAGIC[4] = {'P', 'C', 'M', 'I'};
+const uint32_t CLASS_MAP_VERSION = 2;
+
+uint32_t class_map_hash(const char *str, size_t length)
+{
+   /// FNV-1a, the index must hash the same in every build
+   uint32_t hash = 2166136261u;
+   for (size_t i = 0; i < length; ++i) {
+      hash ^= static_cast<unsigned char>(str[i]);
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+std::string to_lower_ascii(StringRef str)
+{
+   std::string result(str.getData(), str.getSize());
+   for (char &c : result) {
+      if (c >= 'A' && c <= 'Z') {
+         c = c - 'A' + 'a';
+      }
+   }
+   return result;
+}
+
+bool string_in_pool(uint32_t offset, uint32_t length, uint32_t poolSize)
+{
+   /// the string and its terminating nul must lie in the pool
+   return uint64_t(offset) + length < poolSize;
+}
+
+bool stat_dir(const std::string &path, int64_t &mtime)
+{
+   struct stat info;
+   if (::stat(path.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+      return false;
+   }
+   mtime = static_cast<int64_t>(info.st_mtime);
+   return true;
+}
+
+bool is_ident_start(char c)
+{
+   return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+         static_cast<unsigned char>(c) >= 0x80;
+}
+
+bool is_ident_char(char c)
+{
+   return is_ident_start(c) || (c >= '0' && c <= '9');
+}
+
+bool keyword_equals(const std::string &token, const char *keyword)
+{
+   size_t length = strlen(keyword);
+   if (token.size() != length) {
+      return false;
+   }
+   for (size_t i = 0; i < length; ++i) {
+      char c = token[i];
+      if (c >= 'A' && c <= 'Z') {
+         c = c - 'A' + 'a';
+      }
+      if (c != keyword[i]) {
+         return false;
+      }
+   }
+   return true;
+}
+
+struct ScannedFile
+{
+   std::string path;
+   int64_t mtime;
+   int64_t size;
+   std::vector<std::string> lcNames;
+};
+
+struct ScannedDir
+{
+   std::string path;
+   int64_t mtime;
+   std::vector<ScannedFile> files;
+};
+
+class ClassMapBuilder
+{
+public:
+   ClassMapBuilder(const ClassMap *previous, const std::vector<std::string> &extensions)
+      : m_previous(previous),
+        m_extensions(extensions)
+   {
+      if (!previous) {
+         return;
+      }
+      /// index the previous map by directory and file once, reusing a
+      /// directory then only walks its own files and sub directories
+      m_previousFiles.resize(previous->getDirCount());
+      m_previousChildren.resize(previous->getDirCount());
+      m_previousEntries.resize(previous->getFileCount());
+      for (uint32_t i = 0; i < previous->getDirCount(); ++i) {
+         m_previousDirs[previous->getDirPath(i).getStr()] = i;
+      }
+      for (auto &item : m_previousDirs) {
+         const std::string &path = item.first;
+         size_t slash = path.rfind('/');
+         if (slash == std::string::npos || slash == 0) {
+            continue;
+         }
+         auto parent = m_previousDirs.find(path.substr(0, slash));
+         if (parent != m_previousDirs.end()) {
+            m_previousChildren[parent->second].push_back(path);
+         }
+      }
+      for (uint32_t i = 0; i < previous->getFileCount(); ++i) {
+         m_previousFiles[previous->getFile(i).dirIndex].push_back(i);
+      }
+      for (uint32_t i = 0; i < previous->getEntryCount(); ++i) {
+         m_previousEntries[previous->getEntry(i).fileIndex].push_back(i);
+      }
+   }
+
+   void scanRoot(const std::string &root)
+   {
+      std::string path = root;
+      while (path.size() > 1 && path.back() == '/') {
+         path.pop_back();
+      }
+      scanDir(path);
+   }
+
+   bool write(StringRef indexPath);
+
+   /// number of classes written by write(), duplicated names count once
+   size_t getClassCount() const
+   {
+      return m_classCount;
+   }
+
+private:
+   void scanDir(const std::string &path);
+   void reuseDir(uint32_t previousIndex, ScannedDir &dir);
+   void parseDir(const std::string &path, ScannedDir &dir);
+   void parseFile(const std::string &path, const struct stat &info, ScannedDir &dir);
+   bool hasIndexedExtension(const char *name) const;
+
+   const ClassMap *m_previous;
+   const std::vector<std::string> &m_extensions;
+   std::map<std::string, uint32_t> m_previousDirs;
+   std::vector<std::vector<uint32_t>> m_previousFiles;
+   std::vector<std::vector<uint32_t>> m_previousEntries;
+   std::vector<std::vector<std::string>> m_previousChildren;
+   std::map<std::string, bool> m_visited;
+   std::vector<ScannedDir> m_dirs;
+   size_t m_scannedCount = 0;
+   size_t m_classCount = 0;
+};
+
+void ClassMapBuilder::scanDir(const std::string &path)
+{
+   if (m_visited.count(path)) {
+      return;
+   }
+   m_visited[path] = true;
+   ScannedDir dir;
+   dir.path = path;
+   if (!stat_dir(path, dir.mtime)) {
+      return;
+   }
+   auto iter = m_previousDirs.find(path);
+   if (iter != m_previousDirs.end() && m_previous->getDirMtime(iter->second) == dir.mtime) {
+      reuseDir(iter->second, dir);
+   } else {
+      parseDir(path, dir);
+   }
+}
+
+void ClassMapBuilder::reuseDir(uint32_t previousIndex, ScannedDir &dir)
+{
+   /// an unchanged mtime means no entry was added or removed, the files
+   /// and sub directories are the ones recorded last time, only the files
+   /// edited in place are parsed again
+   for (uint32_t fileIndex : m_previousFiles[previousIndex]) {
+      const ClassMap::ClassMapFile &previousFile = m_previous->getFile(fileIndex);
+      std::string path = m_previous->getFilePath(fileIndex).getStr();
+      struct stat info;
+      if (::stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+         continue;
+      }
+      if (static_cast<int64_t>(info.st_mtime) != previousFile.mtime ||
+          static_cast<int64_t>(info.st_size) != previousFile.size) {
+         parseFile(path, info, dir);
+         continue;
+      }
+      ScannedFile file{path, previousFile.mtime, previousFile.size, {}};
+      for (uint32_t i : m_previousEntries[fileIndex]) {
+         const ClassMap::ClassMapEntry &entry = m_previous->getEntry(i);
+         file.lcNames.push_back(m_previous->getString(entry.nameOffset, entry.nameLength).getStr());
+      }
+      m_scannedCount += file.lcNames.size();
+      dir.files.push_back(std::move(file));
+   }
+   m_dirs.push_back(std::move(dir));
+   for (const std::string &child : m_previousChildren[previousIndex]) {
+      scanDir(child);
+   }
+}
+
+void ClassMapBuilder::parseDir(const std::string &path, ScannedDir &dir)
+{
+   struct dirent **namelist = nullptr;
+   int count = php_scandir(path.c_str(), &namelist, nullptr, php_alphasort);
+   if (count < 0) {
+      return;
+   }
+   std::vector<std::string> subDirs;
+   for (int i = 0; i < count; ++i) {
+      const char *name = namelist[i]->d_name;
+      if (name[0] == '.') {
+         /// skip ".", ".." and hidden entries such as .git
+         free(namelist[i]);
+         continue;
+      }
+      std::string fullPath = path + "/" + name;
+      struct stat info;
+      if (::stat(fullPath.c_str(), &info) == 0) {
+         if (S_ISDIR(info.st_mode)) {
+            subDirs.push_back(fullPath);
+         } else if (S_ISREG(info.st_mode) && hasIndexedExtension(name)) {
+            parseFile(fullPath, info, dir);
+         }
+      }
+      free(namelist[i]);
+   }
+   free(namelist);
+   m_dirs.push_back(std::move(dir));
+   for (const std::string &subDir : subDirs) {
+      scanDir(subDir);
+   }
+}
+
+void ClassMapBuilder::parseFile(const std::string &path, const struct stat &info, ScannedDir &dir)
+{
+   /// a file without classes is recorded too, a class added to it later
+   /// must make the index stale
+   ScannedFile file{path, static_cast<int64_t>(info.st_mtime), static_cast<int64_t>(info.st_size), {}};
+   if (auto bufferOrError = MemoryBuffer::getFile(path, -1, false)) {
+      std::vector<std::string> names;
+      ClassMap::extractClassNames(bufferOrError.get()->getBuffer(), names);
+      for (std::string &className : names) {
+         file.lcNames.push_back(to_lower_ascii(className));
+      }
+   }
+   m_scannedCount += file.lcNames.size();
+   dir.files.push_back(std::move(file));
+}
+
+bool ClassMapBuilder::hasIndexedExtension(const char *name) const
+{
+   size_t length = strlen(name);
+   for (const std::string &ext : m_extensions) {
+      if (length > ext.size() && memcmp(name + length - ext.size(), ext.data(), ext.size()) == 0) {
+         return true;
+      }
+   }
+   return false;
+}
+
+bool ClassMapBuilder::write(StringRef indexPath)
+{
+   std::vector<ClassMap::ClassMapDir> dirs;
+   std::vector<ClassMap::ClassMapFile> files;
+   std::vector<ClassMap::ClassMapEntry> entries;
+   std::string strings;
+   std::map<std::string, uint32_t> stringOffsets;
+   auto intern = [&](const std::string &str) -> uint32_t {
+      auto iter = stringOffsets.find(str);
+      if (iter != stringOffsets.end()) {
+         return iter->second;
+      }
+      uint32_t offset = static_cast<uint32_t>(strings.size());
+      strings.append(str);
+      strings.push_back('\0');
+      stringOffsets[str] = offset;
+      return offset;
+   };
+   uint32_t bucketCount = 8;
+   while (bucketCount < m_scannedCount * 2) {
+      bucketCount <<= 1;
+   }
+   std::vector<uint32_t> buckets(bucketCount, 0);
+   m_classCount = 0;
+   for (const ScannedDir &dir : m_dirs) {
+      uint32_t dirIndex = static_cast<uint32_t>(dirs.size());
+      dirs.push_back({dir.mtime, intern(dir.path), static_cast<uint32_t>(dir.path.size())});
+      for (const ScannedFile &scannedFile : dir.files) {
+         uint32_t fileIndex = static_cast<uint32_t>(files.size());
+         files.push_back({scannedFile.mtime, scannedFile.size, dirIndex, intern(scannedFile.path),
+                          static_cast<uint32_t>(scannedFile.path.size()), 0});
+         for (const std::string &lcName : scannedFile.lcNames) {
+            uint32_t hash = class_map_hash(lcName.data(), lcName.size());
+            uint32_t slot = hash & (bucketCount - 1);
+            bool duplicated = false;
+            while (buckets[slot]) {
+               const ClassMap::ClassMapEntry &other = entries[buckets[slot] - 1];
+               if (other.hash == hash && other.nameLength == lcName.size() &&
+                   memcmp(strings.data() + other.nameOffset, lcName.data(), other.nameLength) == 0) {
+                  duplicated = true;
+                  break;
+               }
+               slot = (slot + 1) & (bucketCount - 1);
+            }
+            /// every declaration keeps its entry so an unchanged file can be
+            /// reused as a whole, only the first one is reachable by lookups
+            /// like with the probing loader
+            ClassMap::ClassMapEntry entry;
+            entry.hash = hash;
+            entry.fileIndex = fileIndex;
+            entry.nameOffset = intern(lcName);
+            entry.nameLength = static_cast<uint32_t>(lcName.size());
+            entries.push_back(entry);
+            if (!duplicated) {
+               buckets[slot] = static_cast<uint32_t>(entries.size());
+               ++m_classCount;
+            }
+         }
+      }
+   }
+   ClassMap::ClassMapHeader header;
+   memcpy(header.magic, CLASS_MAP_MAGIC, sizeof(header.magic));
+   header.version = CLASS_MAP_VERSION;
+   header.classCount = static_cast<uint32_t>(m_classCount);
+   header.entryCount = static_cast<uint32_t>(entries.size());
+   header.bucketCount = bucketCount;
+   header.dirCount = static_cast<uint32_t>(dirs.size());
+   header.fileCount = static_cast<uint32_t>(files.size());
+   header.stringsSize = static_cast<uint32_t>(strings.size());
+
+   /// write to a temporary file and rename it over the index, processes
+   /// that mapped the old index keep reading a consistent file
+   std::string tempPath = indexPath.getStr() + ".tmp";
+   FILE *file = fopen(tempPath.c_str(), "wb");
+   if (!file) {
+      return false;
+   }
+   bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+         (dirs.empty() || fwrite(dirs.data(), sizeof(ClassMap::ClassMapDir), dirs.size(), file) == dirs.size()) &&
+         (files.empty() || fwrite(files.data(), sizeof(ClassMap::ClassMapFile), files.size(), file) == files.size()) &&
+         (entries.empty() || fwrite(entries.data(), sizeof(ClassMap::ClassMapEntry), entries.size(), file) == entries.size()) &&
+         fwrite(buckets.data(), sizeof(uint32_t), buckets.size(), file) == buckets.size() &&
+         (strings.empty() || fwrite(strings.data(), 1, strings.size(), file) == strings.size());
+   ok = (fclose(file) == 0) && ok;
+   if (!ok || std::rename(tempPath.c_str(), indexPath.getStr().c_str()) != 0) {
+      std::remove(tempPath.c_str());
+      return false;
+   }
+   return true;
+}
+
+} // anonymous namespace
+
+ClassMap::ClassMap(std::unique_ptr<MemoryBuffer> buffer, StringRef indexPath)
+   : m_buffer(std::move(buffer)),
+     m_indexPath(indexPath.getStr())
+{
+   const char *start = m_buffer->getBufferStart();
+   m_header = reinterpret_cast<const ClassMapHeader *>(start);
+   m_dirs = reinterpret_cast<const ClassMapDir *>(start + sizeof(ClassMapHeader));
+   m_files = reinterpret_cast<const ClassMapFile *>(m_dirs + m_header->dirCount);
+   m_entries = reinterpret_cast<const ClassMapEntry *>(m_files + m_header->fileCount);
+   m_buckets = reinterpret_cast<const uint32_t *>(m_entries + m_header->entryCount);
+   m_strings = reinterpret_cast<const char *>(m_buckets + m_header->bucketCount);
+}
+
+std::unique_ptr<ClassMap> ClassMap::open(StringRef indexPath)
+{
+   auto bufferOrError = MemoryBuffer::getFile(indexPath, -1, false);
+   if (!bufferOrError) {
+      return nullptr;
+   }
+   std::unique_ptr<MemoryBuffer> buffer = std::move(bufferOrError.get());
+   size_t size = buffer->getBufferSize();
+   if (size < sizeof(ClassMapHeader)) {
+      return nullptr;
+   }
+   const ClassMapHeader *header = reinterpret_cast<const ClassMapHeader *>(buffer->getBufferStart());
+   if (memcmp(header->magic, CLASS_MAP_MAGIC, sizeof(header->magic)) != 0 ||
+       header->version != CLASS_MAP_VERSION ||
+       header->bucketCount == 0 || (header->bucketCount & (header->bucketCount - 1)) != 0) {
+      return nullptr;
+   }
+   uint64_t expected = sizeof(ClassMapHeader) +
+         uint64_t(header->dirCount) * sizeof(ClassMapDir) +
+         uint64_t(header->fileCount) * sizeof(ClassMapFile) +
+         uint64_t(header->entryCount) * sizeof(ClassMapEntry) +
+         uint64_t(header->bucketCount) * sizeof(uint32_t) +
+         header->stringsSize;
+   if (expected != size) {
+      return nullptr;
+   }
+   std::unique_ptr<ClassMap> classMap(new ClassMap(std::move(buffer), indexPath));
+   if (!classMap->isValid()) {
+      return nullptr;
+   }
+   return classMap;
+}
+
+bool ClassMap::isValid() const
+{
+   /// a corrupt file must not make a lookup read out of the mapping
+   uint32_t stringsSize = m_header->stringsSize;
+   if (m_header->classCount > m_header->entryCount ||
+       m_header->classCount >= m_header->bucketCount) {
+      return false;
+   }
+   for (uint32_t i = 0; i < m_header->dirCount; ++i) {
+      if (!string_in_pool(m_dirs[i].pathOffset, m_dirs[i].pathLength, stringsSize)) {
+         return false;
+      }
+   }
+   for (uint32_t i = 0; i < m_header->fileCount; ++i) {
+      const ClassMapFile &file = m_files[i];
+      if (file.dirIndex >= m_header->dirCount ||
+          !string_in_pool(file.pathOffset, file.pathLength, stringsSize)) {
+         return false;
+      }
+   }
+   for (uint32_t i = 0; i < m_header->entryCount; ++i) {
+      const ClassMapEntry &entry = m_entries[i];
+      if (entry.fileIndex >= m_header->fileCount ||
+          !string_in_pool(entry.nameOffset, entry.nameLength, stringsSize)) {
+         return false;
+      }
+   }
+   /// at least one empty bucket must end every probe
+   uint32_t usedBuckets = 0;
+   for (uint32_t i = 0; i < m_header->bucketCount; ++i) {
+      if (m_buckets[i] > m_header->entryCount) {
+         return false;
+      }
+      usedBuckets += m_buckets[i] != 0;
+   }
+   return usedBuckets == m_header->classCount;
+}
+
+long ClassMap::build(StringRef indexPath, const std::vector<std::string> &roots,
+                     const std::vector<std::string> &extensions)
+{
+   std::unique_ptr<ClassMap> previous = open(indexPath);
+   ClassMapBuilder builder(previous.get(), extensions);
+   for (const std::string &root : roots) {
+      builder.scanRoot(root);
+   }
+   if (!builder.write(indexPath)) {
+      return -1;
+   }
+   return static_cast<long>(builder.getClassCount());
+}
+
+void ClassMap::extractClassNames(StringRef source, std::vector<std::string> &names)
+{
+   const char *ptr = source.begin();
+   const char *end = source.end();
+   std::string currentNamespace;
+   std::string previousToken;
+   bool inPhp = false;
+   auto read_name = [&](std::string &name) {
+      while (ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\r' || *ptr == '\n')) {
+         ++ptr;
+      }
+      const char *start = ptr;
+      while (ptr < end && (is_ident_char(*ptr) || *ptr == '\\')) {
+         ++ptr;
+      }
+      name.assign(start, ptr - start);
+   };
+   while (ptr < end) {
+      if (!inPhp) {
+         const char *open = static_cast<const char *>(memmem(ptr, end - ptr, "<?", 2));
+         if (!open) {
+            return;
+         }
+         ptr = open + 2;
+         if (end - ptr >= 3 && (ptr[0] == 'p' || ptr[0] == 'P') &&
+             (ptr[1] == 'h' || ptr[1] == 'H') && (ptr[2] == 'p' || ptr[2] == 'P')) {
+            ptr += 3;
+         }
+         inPhp = true;
+         continue;
+      }
+      char c = *ptr;
+      if (c == '?' && ptr + 1 < end && ptr[1] == '>') {
+         ptr += 2;
+         inPhp = false;
+      } else if (c == '#' || (c == '/' && ptr + 1 < end && ptr[1] == '/')) {
+         while (ptr < end && *ptr != '\n' && !(*ptr == '?' && ptr + 1 < end && ptr[1] == '>')) {
+            ++ptr;
+         }
+      } else if (c == '/' && ptr + 1 < end && ptr[1] == '*') {
+         const char *close = static_cast<const char *>(memmem(ptr + 2, end - ptr - 2, "*/", 2));
+         ptr = close ? close + 2 : end;
+      } else if (c == '\'' || c == '"' || c == '`') {
+         ++ptr;
+         while (ptr < end && *ptr != c) {
+            ptr += (*ptr == '\\' && ptr + 1 < end) ? 2 : 1;
+         }
+         ++ptr;
+         previousToken = "string";
+      } else if (c == '<' && end - ptr > 3 && ptr[1] == '<' && ptr[2] == '<') {
+         /// heredoc / nowdoc, skip up to the line starting with the label
+         ptr += 3;
+         while (ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\'' || *ptr == '"')) {
+            ++ptr;
+         }
+         const char *labelStart = ptr;
+         while (ptr < end && is_ident_char(*ptr)) {
+            ++ptr;
+         }
+         std::string label(labelStart, ptr - labelStart);
+         while (ptr < end && !label.empty()) {
+            const char *lineEnd = static_cast<const char *>(memchr(ptr, '\n', end - ptr));
+            ptr = lineEnd ? lineEnd + 1 : end;
+            const char *line = ptr;
+            while (line < end && (*line == ' ' || *line == '\t')) {
+               ++line;
+            }
+            if (static_cast<size_t>(end - line) >= label.size() &&
+                memcmp(line, label.data(), label.size()) == 0 &&
+                (line + label.size() == end || !is_ident_char(line[label.size()]))) {
+               ptr = line + label.size();
+               break;
+            }
+         }
+         previousToken = "string";
+      } else if (c == ':' && ptr + 1 < end && ptr[1] == ':') {
+         ptr += 2;
+         previousToken = "::";
+      } else if (c == '$') {
+         ++ptr;
+         while (ptr < end && is_ident_char(*ptr)) {
+            ++ptr;
+         }
+         previousToken = "$";
+      } else if (is_ident_start(c)) {
+         const char *start = ptr;
+         while (ptr < end && (is_ident_char(*ptr) || *ptr == '\\')) {
+            ++ptr;
+         }
+         std::string token(start, ptr - start);
+         if (keyword_equals(token, "namespace") && previousToken != "::" && previousToken != "->") {
+            std::string name;
+            read_name(name);
+            while (ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\r' || *ptr == '\n')) {
+               ++ptr;
+            }
+            if (ptr < end && (*ptr == ';' || *ptr == '{')) {
+               currentNamespace = name;
+            }
+            token = "namespace";
+         } else if ((keyword_equals(token, "class") || keyword_equals(token, "interface") ||
+                     keyword_equals(token, "trait")) &&
+                    previousToken != "::" && previousToken != "->" && !keyword_equals(previousToken, "new")) {
+            std::string name;
+            read_name(name);
+            if (!name.empty() && name.find('\\') == std::string::npos &&
+                !keyword_equals(name, "extends") && !keyword_equals(name, "implements")) {
+               names.push_back(currentNamespace.empty() ? name : currentNamespace + "\\" + name);
+            }
+         }
+         previousToken = token;
+      } else if (c == '-' && ptr + 1 < end && ptr[1] == '>') {
+         ptr += 2;
+         previousToken = "->";
+      } else {
+         if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            previousToken.assign(1, c);
+         }
+         ++ptr;
+      }
+   }
+}
+
+bool ClassMap::lookup(StringRef lcClassName, StringRef &filename) const
+{
+   uint32_t hash = class_map_hash(lcClassName.getData(), lcClassName.getSize());
+   uint32_t mask = m_header->bucketCount - 1;
+   uint32_t slot = hash & mask;
+   while (uint32_t index = m_buckets[slot]) {
+      const ClassMapEntry &entry = m_entries[index - 1];
+      if (entry.hash == hash && entry.nameLength == lcClassName.getSize() &&
+          memcmp(m_strings + entry.nameOffset, lcClassName.getData(), entry.nameLength) == 0) {
+         filename = getFilePath(entry.fileIndex);
+         return true;
+      }
+      slot = (slot + 1) & mask;
+   }
+   return false;
+}
+
+bool ClassMap::isStale() const
+{
+   for (uint32_t i = 0; i < m_header->dirCount; ++i) {
+      int64_t mtime;
+      if (!stat_dir(getDirPath(i).getStr(), mtime) || mtime != m_dirs[i].mtime) {
+         return true;
+      }
+   }
+   for (uint32_t i = 0; i < m_header->fileCount; ++i) {
+      struct stat info;
+      if (::stat(getFilePath(i).getStr().c_str(), &info) != 0 || !S_ISREG(info.st_mode) ||
+          static_cast<int64_t>(info.st_mtime) != m_files[i].mtime ||
+          static_cast<int64_t>(info.st_size) != m_files[i].size) {
+         return true;
+      }
+   }
+   return false;
+}
+
+uint32_t ClassMap::getClassCount() const
+{
+   return m_header->classCount;
+}
+
+uint32_t ClassMap::getEntryCount() const
+{
+   return m_header->entryCount;
+}
+
+uint32_t ClassMap::getDirCount() const
+{
+   return m_header->dirCount;
+}
+
+uint32_t ClassMap::getFileCount() const
+{
+   return m_header->fileCount;
+}
+
+StringRef ClassMap::getDirPath(uint32_t index) const
+{
+   return getString(m_dirs[index].pathOffset, m_dirs[index].pathLength);
+}
+
+int64_t ClassMap::getDirMtime(uint32_t index) const
+{
+   return m_dirs[index].mtime;
+}
+
+const ClassMap::ClassMapFile &ClassMap::getFile(uint32_t index) const
+{
+   return m_files[index];
+}
+
+StringRef ClassMap::getFilePath(uint32_t index) const
+{
+   return getString(m_files[index].pathOffset, m_files[index].pathLength);
+}
+
+const ClassMap::ClassMapEntry &ClassMap::getEntry(uint32_t index) const
+{
+   return m_entries[index];
+}
+
+StringRef ClassMap::getString(uint32_t offset, uint32_t length) const
+{
+   return StringRef(m_strings + offset, length);
+}
+
+StringRef ClassMap::getIndexPath() const
+{
+   return m_indexPath;
+}
+
+} // runtime
+} // polar
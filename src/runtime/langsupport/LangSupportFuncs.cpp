@@ -10,6 +10,7 @@
 // Created by polarboy on 2019/01/09.
 
 #include "polarphp/runtime/langsupport/LangSupportFuncs.h"
+#include "polarphp/runtime/ExecEnv.h"
 #include "polarphp/runtime/langsupport/TypeFuncs.h"
 #include "polarphp/runtime/langsupport/VariableFuncs.h"
 #include "polarphp/runtime/langsupport/ArrayFuncs.h"
@@ -17,6 +18,8 @@
 #include "polarphp/runtime/langsupport/Reflection.h"
 #include "polarphp/runtime/langsupport/StdExceptions.h"
 #include "polarphp/runtime/langsupport/ClassLoader.h"
+#include "polarphp/runtime/langsupport/LazySequence.h"
+#include "polarphp/runtime/langsupport/LazyRange.h"
 #include "polarphp/runtime/langsupport/SerializeFuncs.h"
 
 namespace polar {
@@ -36,27 +39,27 @@ static const zend_function_entry sg_langSupportFunctions[] = {
    ///
    /// functions for types
    ///
-   PHP_FE(intval,          arginfo_intval)
-   PHP_FE(floatval,        arginfo_floatval)
-   PHP_FALIAS(doubleval,   floatval,            arginfo_floatval)
+   PHP_TS_FE(intval,       arginfo_intval)
+   PHP_TS_FE(floatval,     arginfo_floatval)
+   PHP_TS_FALIAS(doubleval, floatval,          arginfo_floatval)
    PHP_FE(strval,          arginfo_strval)
-   PHP_FE(boolval,         arginfo_boolval)
+   PHP_TS_FE(boolval,      arginfo_boolval)
    PHP_FE(gettype,         arginfo_gettype)
    PHP_FE(settype,         arginfo_settype)
-   PHP_FE(is_null,         arginfo_is_null)
+   PHP_TS_FE(is_null,      arginfo_is_null)
    PHP_FE(is_resource,     arginfo_is_resource)
-   PHP_FE(is_bool,         arginfo_is_bool)
-   PHP_FE(is_int,          arginfo_is_int)
-   PHP_FE(is_float,        arginfo_is_float)
-   PHP_FALIAS(is_integer,  is_int,	             arginfo_is_int)
-   PHP_FALIAS(is_long,     is_int,               arginfo_is_int)
-   PHP_FALIAS(is_double,   is_float,             arginfo_is_float)
-   PHP_FALIAS(is_real,     is_float,             arginfo_is_float)
-   PHP_FE(is_numeric,      arginfo_is_numeric)
+   PHP_TS_FE(is_bool,      arginfo_is_bool)
+   PHP_TS_FE(is_int,       arginfo_is_int)
+   PHP_TS_FE(is_float,     arginfo_is_float)
+   PHP_TS_FALIAS(is_integer, is_int,           arginfo_is_int)
+   PHP_TS_FALIAS(is_long,  is_int,             arginfo_is_int)
+   PHP_TS_FALIAS(is_double, is_float,          arginfo_is_float)
+   PHP_TS_FALIAS(is_real,  is_float,           arginfo_is_float)
+   PHP_TS_FE(is_numeric,   arginfo_is_numeric)
    PHP_FE(is_string,       arginfo_is_string)
    PHP_FE(is_array,        arginfo_is_array)
    PHP_FE(is_object,       arginfo_is_object)
-   PHP_FE(is_scalar,       arginfo_is_scalar)
+   PHP_TS_FE(is_scalar,    arginfo_is_scalar)
    PHP_FE(is_callable,     arginfo_is_callable)
    PHP_FE(is_iterable,     arginfo_is_iterable)
    PHP_FE(is_countable,    arginfo_is_countable)
@@ -150,6 +153,7 @@ static const zend_function_entry sg_langSupportFunctions[] = {
    PHP_FE(array_product,												arginfo_array_product)
    PHP_FE(array_filter,													arginfo_array_filter)
    PHP_FE(array_map,													   arginfo_array_map)
+   PHP_FE(array_map_parallel,											arginfo_array_map_parallel)
    PHP_FE(array_chunk,													arginfo_array_chunk)
    PHP_FE(array_combine,												arginfo_array_combine)
    PHP_FE(array_key_exists,											arginfo_array_key_exists)
@@ -161,6 +165,9 @@ static const zend_function_entry sg_langSupportFunctions[] = {
    /// class loader
    PHP_FE(default_class_loader,                             arginfo_default_class_loader)
    PHP_FE(set_autoload_file_extensions,                     arginfo_set_autoload_file_extensions)
+   PHP_FE(build_class_map,                                  arginfo_build_class_map)
+   PHP_FE(register_class_map,                               arginfo_register_class_map)
+   PHP_FE(resolve_path_cache_status,                        arginfo_resolve_path_cache_status)
    PHP_FE(register_class_loader,                            arginfo_register_class_loader)
    PHP_FE(unregister_class_loader,                          arginfo_unregister_class_loader)
    PHP_FE(retrieve_registered_class_loaders,                arginfo_retrieve_registered_class_loaders)
@@ -238,6 +245,8 @@ PHP_MINIT_FUNCTION(Runtime)
    RUNTIME_MINIT_SUBMODULE(assert);
    RUNTIME_MINIT_SUBMODULE(stdexceptions);
    RUNTIME_MINIT_SUBMODULE(classloader);
+   RUNTIME_MINIT_SUBMODULE(lazysequence);
+   RUNTIME_MINIT_SUBMODULE(lazyrange);
    return SUCCESS;
 }
 
@@ -245,6 +254,7 @@ PHP_MSHUTDOWN_FUNCTION(Runtime)
 {
    RUNTIME_MSHUTDOWN_SUBMODULE(array);
    RUNTIME_MSHUTDOWN_SUBMODULE(assert);
+   RUNTIME_MSHUTDOWN_SUBMODULE(classloader);
    zend_hash_destroy(&sg_RuntimeSubmodules);
    return SUCCESS;
 }
@@ -0,0 +1,224 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "polarphp/runtime/langsupport/LazyRange.h"
+
+namespace polar {
+namespace runtime {
+
+zend_class_entry *g_LazyRange = nullptr;
+
+static zend_object_handlers sg_lazyRangeHandlers;
+
+namespace {
+
+struct LazyRangeObject
+{
+   /// the value of range() or the key of array_fill() at position 0
+   zend_long first;
+   zend_ulong step;
+   uint32_t size;
+   /// the array_fill() value, undef for a range
+   zval fill;
+   zend_object std;
+};
+
+inline LazyRangeObject *lazy_range_from_obj(zend_object *object)
+{
+   return reinterpret_cast<LazyRangeObject *>(
+            reinterpret_cast<char *>(object) - XtOffsetOf(LazyRangeObject, std));
+}
+
+#define Z_LAZY_RANGE_P(zv) lazy_range_from_obj(Z_OBJ_P((zv)))
+
+zend_object *lazy_range_create(zend_class_entry *ce)
+{
+   LazyRangeObject *intern = reinterpret_cast<LazyRangeObject *>(
+            ecalloc(1, sizeof(LazyRangeObject) + zend_object_properties_size(ce)));
+   ZVAL_UNDEF(&intern->fill);
+   zend_object_std_init(&intern->std, ce);
+   object_properties_init(&intern->std, ce);
+   intern->std.handlers = &sg_lazyRangeHandlers;
+   return &intern->std;
+}
+
+void lazy_range_free(zend_object *object)
+{
+   zval_ptr_dtor(&lazy_range_from_obj(object)->fill);
+   zend_object_std_dtor(object);
+}
+
+HashTable *lazy_range_get_gc(zval *object, zval **table, int *n)
+{
+   LazyRangeObject *intern = Z_LAZY_RANGE_P(object);
+   *table = &intern->fill;
+   *n = Z_ISUNDEF(intern->fill) ? 0 : 1;
+   return zend_std_get_properties(object);
+}
+
+struct LazyRangeIterator
+{
+   zend_object_iterator intern;
+   uint32_t position;
+   zval value;
+};
+
+void lazy_range_iterator_dtor(zend_object_iterator *iter)
+{
+   zval_ptr_dtor(&iter->data);
+}
+
+int lazy_range_iterator_valid(zend_object_iterator *iter)
+{
+   LazyRangeIterator *iterator = reinterpret_cast<LazyRangeIterator *>(iter);
+   return iterator->position < Z_LAZY_RANGE_P(&iter->data)->size ? SUCCESS : FAILURE;
+}
+
+zval *lazy_range_iterator_current_data(zend_object_iterator *iter)
+{
+   LazyRangeIterator *iterator = reinterpret_cast<LazyRangeIterator *>(iter);
+   LazyRangeObject *range = Z_LAZY_RANGE_P(&iter->data);
+   if (!Z_ISUNDEF(range->fill)) {
+      /// foreach copies the value out, the shared one is returned as is
+      return &range->fill;
+   }
+   ZVAL_LONG(&iterator->value, static_cast<zend_long>(
+                static_cast<zend_ulong>(range->first) + iterator->position * range->step));
+   return &iterator->value;
+}
+
+void lazy_range_iterator_current_key(zend_object_iterator *iter, zval *key)
+{
+   LazyRangeIterator *iterator = reinterpret_cast<LazyRangeIterator *>(iter);
+   LazyRangeObject *range = Z_LAZY_RANGE_P(&iter->data);
+   if (!Z_ISUNDEF(range->fill)) {
+      /// like the eager array_fill(), the keys after a negative first key
+      /// start at 0
+      if (iterator->position == 0 || range->first >= 0) {
+         ZVAL_LONG(key, range->first + iterator->position);
+      } else {
+         ZVAL_LONG(key, iterator->position - 1);
+      }
+   } else {
+      ZVAL_LONG(key, iterator->position);
+   }
+}
+
+void lazy_range_iterator_move_forward(zend_object_iterator *iter)
+{
+   ++reinterpret_cast<LazyRangeIterator *>(iter)->position;
+}
+
+void lazy_range_iterator_rewind(zend_object_iterator *iter)
+{
+   reinterpret_cast<LazyRangeIterator *>(iter)->position = 0;
+}
+
+const zend_object_iterator_funcs sg_lazyRangeIteratorFuncs = {
+   lazy_range_iterator_dtor,
+   lazy_range_iterator_valid,
+   lazy_range_iterator_current_data,
+   lazy_range_iterator_current_key,
+   lazy_range_iterator_move_forward,
+   lazy_range_iterator_rewind,
+   nullptr
+};
+
+zend_object_iterator *lazy_range_get_iterator(zend_class_entry *ce, zval *object, int by_ref)
+{
+   if (by_ref) {
+      zend_throw_error(nullptr, "An iterator cannot be used with foreach by reference");
+      return nullptr;
+   }
+   LazyRangeIterator *iterator = reinterpret_cast<LazyRangeIterator *>(
+            emalloc(sizeof(LazyRangeIterator)));
+   zend_iterator_init(&iterator->intern);
+   ZVAL_COPY(&iterator->intern.data, object);
+   iterator->intern.funcs = &sg_lazyRangeIteratorFuncs;
+   iterator->position = 0;
+   ZVAL_UNDEF(&iterator->value);
+   return &iterator->intern;
+}
+
+ZEND_COLD zend_function *lazy_range_get_constructor(zend_object *object)
+{
+   zend_throw_error(nullptr, "Instantiation of 'LazyRange' is not allowed");
+   return nullptr;
+}
+
+} // anonymous namespace
+
+bool lazy_range_consumed_by_foreach(zend_execute_data *execute_data)
+{
+   zend_execute_data *caller = EX(prev_execute_data);
+   if (!caller || !caller->func || !ZEND_USER_CODE(caller->func->common.type)) {
+      return false;
+   }
+   /// the call opcodes save the opline before running the handler, the
+   /// result is consumed by the very next opcode or it escapes
+   const zend_op *opline = caller->opline;
+   if (opline->opcode != ZEND_DO_ICALL &&
+       opline->opcode != ZEND_DO_FCALL &&
+       opline->opcode != ZEND_DO_FCALL_BY_NAME) {
+      return false;
+   }
+   if (opline->result_type == IS_UNUSED) {
+      return false;
+   }
+   const zend_op *next = opline + 1;
+   return next->opcode == ZEND_FE_RESET_R &&
+         next->op1_type == opline->result_type &&
+         next->op1.var == opline->result.var;
+}
+
+void lazy_range_init(zval *object, zend_long first, zend_ulong step, uint32_t size)
+{
+   object_init_ex(object, g_LazyRange);
+   LazyRangeObject *intern = Z_LAZY_RANGE_P(object);
+   intern->first = first;
+   intern->step = step;
+   intern->size = size;
+}
+
+void lazy_fill_init(zval *object, zend_long firstKey, uint32_t size, zval *value)
+{
+   object_init_ex(object, g_LazyRange);
+   LazyRangeObject *intern = Z_LAZY_RANGE_P(object);
+   intern->first = firstKey;
+   intern->step = 0;
+   intern->size = size;
+   ZVAL_COPY(&intern->fill, value);
+}
+
+PHP_MINIT_FUNCTION(lazyrange)
+{
+   zend_class_entry ce;
+   memcpy(&sg_lazyRangeHandlers, &std_object_handlers, sizeof(zend_object_handlers));
+   sg_lazyRangeHandlers.offset = XtOffsetOf(LazyRangeObject, std);
+   sg_lazyRangeHandlers.free_obj = lazy_range_free;
+   sg_lazyRangeHandlers.clone_obj = nullptr;
+   sg_lazyRangeHandlers.get_gc = lazy_range_get_gc;
+   /// only range() and array_fill() create the object
+   sg_lazyRangeHandlers.get_constructor = lazy_range_get_constructor;
+
+   INIT_CLASS_ENTRY(ce, "LazyRange", nullptr);
+   ce.create_object = lazy_range_create;
+   g_LazyRange = zend_register_internal_class(&ce);
+   g_LazyRange->ce_flags |= ZEND_ACC_FINAL;
+   g_LazyRange->get_iterator = lazy_range_get_iterator;
+   g_LazyRange->serialize = zend_class_serialize_deny;
+   g_LazyRange->unserialize = zend_class_unserialize_deny;
+   zend_class_implements(g_LazyRange, 1, zend_ce_traversable);
+   return SUCCESS;
+}
+
+} // runtime
+} // polar
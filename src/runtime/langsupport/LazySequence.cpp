@@ -0,0 +1,741 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "polarphp/runtime/langsupport/LazySequence.h"
+#include "polarphp/runtime/langsupport/ArrayFuncs.h"
+#include "polarphp/runtime/langsupport/StdExceptions.h"
+
+#include <memory>
+#include <vector>
+
+namespace polar {
+namespace runtime {
+
+zend_class_entry *g_LazySequence = nullptr;
+
+static zend_object_handlers sg_lazySequenceHandlers;
+
+namespace {
+
+enum class StageKind
+{
+   Map,
+   Filter,
+   Take,
+   Chunk
+};
+
+///
+/// One stage of the pipeline, the callable is resolved once when the stage
+/// is added and its cache is reused for every element.
+///
+struct SequenceStage
+{
+   StageKind kind;
+   zval callable;
+   zend_fcall_info_cache fcc;
+   zend_long count;
+   zend_long mode;
+
+   SequenceStage(StageKind kind)
+      : kind(kind),
+        fcc(empty_fcall_info_cache),
+        count(0),
+        mode(0)
+   {
+      ZVAL_UNDEF(&callable);
+   }
+
+   SequenceStage(const SequenceStage &other)
+      : kind(other.kind),
+        fcc(other.fcc),
+        count(other.count),
+        mode(other.mode)
+   {
+      ZVAL_COPY(&callable, &other.callable);
+   }
+
+   SequenceStage &operator=(const SequenceStage &) = delete;
+
+   ~SequenceStage()
+   {
+      zval_ptr_dtor(&callable);
+   }
+
+   bool hasCallable() const
+   {
+      return Z_TYPE(callable) != IS_UNDEF;
+   }
+
+   /// call the callable with \p argc arguments, \p retval is undefined when
+   /// the call failed or threw
+   bool call(zval *retval, uint32_t argc, zval *argv)
+   {
+      zend_fcall_info fci;
+      fci.size = sizeof(fci);
+      ZVAL_COPY_VALUE(&fci.function_name, &callable);
+      fci.object = nullptr;
+      fci.retval = retval;
+      fci.params = argv;
+      fci.param_count = argc;
+      fci.no_separation = 0;
+      if (zend_call_function(&fci, &fcc) != SUCCESS || Z_TYPE_P(retval) == IS_UNDEF) {
+         return false;
+      }
+      if (UNEXPECTED(EG(exception))) {
+         zval_ptr_dtor(retval);
+         ZVAL_UNDEF(retval);
+         return false;
+      }
+      return true;
+   }
+};
+
+struct SequencePipeline
+{
+   zval source;
+   std::vector<SequenceStage> stages;
+   /// the zvals handed to the garbage collector
+   std::vector<zval> gcTable;
+
+   SequencePipeline()
+   {
+      ZVAL_UNDEF(&source);
+   }
+
+   SequencePipeline(const SequencePipeline &other)
+      : stages(other.stages)
+   {
+      ZVAL_COPY(&source, &other.source);
+   }
+
+   ~SequencePipeline()
+   {
+      zval_ptr_dtor(&source);
+   }
+};
+
+struct LazySequenceObject
+{
+   SequencePipeline *pipeline;
+   zend_object std;
+};
+
+inline LazySequenceObject *lazy_sequence_from_obj(zend_object *object)
+{
+   return reinterpret_cast<LazySequenceObject *>(
+            reinterpret_cast<char *>(object) - XtOffsetOf(LazySequenceObject, std));
+}
+
+#define Z_LAZY_SEQUENCE_P(zv) lazy_sequence_from_obj(Z_OBJ_P((zv)))
+
+///
+/// Pulls the elements through the stages, every call of next() runs the
+/// callbacks for one element of the result and nothing more.
+///
+class SequenceCursor
+{
+public:
+   SequenceCursor(SequencePipeline *pipeline)
+      : m_pipeline(pipeline),
+        m_iterator(nullptr),
+        m_position(0),
+        m_index(0),
+        m_started(false),
+        m_finished(false),
+        m_taken(pipeline->stages.size(), 0),
+        m_sourceDone(pipeline->stages.size(), false)
+   {}
+
+   ~SequenceCursor()
+   {
+      if (m_iterator) {
+         zend_iterator_dtor(m_iterator);
+      }
+   }
+
+   /// the next key and value of the sequence, both must be released by the
+   /// caller, false once the sequence or an exception ended it
+   bool next(zval *key, zval *value)
+   {
+      if (m_finished) {
+         return false;
+      }
+      if (!pull(m_pipeline->stages.size(), key, value)) {
+         m_finished = true;
+         return false;
+      }
+      return true;
+   }
+
+private:
+   bool pullSource(zval *key, zval *value);
+   bool pull(size_t level, zval *key, zval *value);
+
+   SequencePipeline *m_pipeline;
+   zend_object_iterator *m_iterator;
+   HashPosition m_position;
+   zend_ulong m_index;
+   bool m_started;
+   bool m_finished;
+   std::vector<zend_long> m_taken;
+   std::vector<bool> m_sourceDone;
+};
+
+bool SequenceCursor::pullSource(zval *key, zval *value)
+{
+   zval *source = &m_pipeline->source;
+   if (UNEXPECTED(Z_ISUNDEF_P(source))) {
+      /// unserialize() creates the object without calling the constructor
+      zend_throw_error(nullptr, "LazySequence has no source, its constructor was not called");
+      return false;
+   }
+   if (Z_TYPE_P(source) == IS_ARRAY) {
+      HashTable *ht = Z_ARRVAL_P(source);
+      if (!m_started) {
+         zend_hash_internal_pointer_reset_ex(ht, &m_position);
+         m_started = true;
+      } else {
+         zend_hash_move_forward_ex(ht, &m_position);
+      }
+      zval *entry = zend_hash_get_current_data_ex(ht, &m_position);
+      if (!entry) {
+         return false;
+      }
+      ZVAL_COPY_DEREF(value, entry);
+      zend_hash_get_current_key_zval_ex(ht, key, &m_position);
+      return true;
+   }
+   if (!m_started) {
+      zend_class_entry *ce = Z_OBJCE_P(source);
+      m_iterator = ce->get_iterator(ce, source, 0);
+      m_started = true;
+      if (!m_iterator || EG(exception)) {
+         return false;
+      }
+      if (m_iterator->funcs->rewind) {
+         m_iterator->funcs->rewind(m_iterator);
+      }
+   } else {
+      m_iterator->funcs->move_forward(m_iterator);
+   }
+   if (EG(exception) || m_iterator->funcs->valid(m_iterator) != SUCCESS || EG(exception)) {
+      return false;
+   }
+   zval *entry = m_iterator->funcs->get_current_data(m_iterator);
+   if (!entry || EG(exception)) {
+      return false;
+   }
+   ZVAL_COPY_DEREF(value, entry);
+   if (m_iterator->funcs->get_current_key) {
+      m_iterator->funcs->get_current_key(m_iterator, key);
+      if (EG(exception)) {
+         zval_ptr_dtor(value);
+         zval_ptr_dtor(key);
+         return false;
+      }
+   } else {
+      ZVAL_LONG(key, m_index);
+   }
+   ++m_index;
+   return true;
+}
+
+bool SequenceCursor::pull(size_t level, zval *key, zval *value)
+{
+   if (level == 0) {
+      return pullSource(key, value);
+   }
+   size_t stageIndex = level - 1;
+   SequenceStage &stage = m_pipeline->stages[stageIndex];
+   switch (stage.kind) {
+   case StageKind::Map: {
+      if (!pull(level - 1, key, value)) {
+         return false;
+      }
+      zval retval;
+      bool called = stage.call(&retval, 1, value);
+      zval_ptr_dtor(value);
+      if (!called) {
+         zval_ptr_dtor(key);
+         return false;
+      }
+      ZVAL_COPY_VALUE(value, &retval);
+      return true;
+   }
+   case StageKind::Filter:
+      while (pull(level - 1, key, value)) {
+         bool keep;
+         if (!stage.hasCallable()) {
+            keep = zend_is_true(value);
+         } else {
+            zval args[2];
+            zval retval;
+            uint32_t argc = 1;
+            if (stage.mode == ARRAY_FILTER_USE_KEY) {
+               ZVAL_COPY_VALUE(&args[0], key);
+            } else if (stage.mode == ARRAY_FILTER_USE_BOTH) {
+               ZVAL_COPY_VALUE(&args[0], value);
+               ZVAL_COPY_VALUE(&args[1], key);
+               argc = 2;
+            } else {
+               ZVAL_COPY_VALUE(&args[0], value);
+            }
+            if (!stage.call(&retval, argc, args)) {
+               zval_ptr_dtor(key);
+               zval_ptr_dtor(value);
+               return false;
+            }
+            keep = zend_is_true(&retval);
+            zval_ptr_dtor(&retval);
+         }
+         if (keep) {
+            return true;
+         }
+         zval_ptr_dtor(key);
+         zval_ptr_dtor(value);
+      }
+      return false;
+   case StageKind::Take:
+      /// the upstream is not pulled once the count is reached, a take
+      /// ends an endless source
+      if (m_taken[stageIndex] >= stage.count) {
+         return false;
+      }
+      if (!pull(level - 1, key, value)) {
+         return false;
+      }
+      ++m_taken[stageIndex];
+      return true;
+   case StageKind::Chunk: {
+      if (m_sourceDone[stageIndex]) {
+         return false;
+      }
+      zval chunk;
+      zval itemKey;
+      zval itemValue;
+      array_init_size(&chunk, static_cast<uint32_t>(stage.count));
+      while (zend_hash_num_elements(Z_ARRVAL(chunk)) < static_cast<zend_ulong>(stage.count)) {
+         if (!pull(level - 1, &itemKey, &itemValue)) {
+            m_sourceDone[stageIndex] = true;
+            break;
+         }
+         if (stage.mode) {
+            array_set_zval_key(Z_ARRVAL(chunk), &itemKey, &itemValue);
+            zval_ptr_dtor(&itemValue);
+         } else {
+            zend_hash_next_index_insert_new(Z_ARRVAL(chunk), &itemValue);
+         }
+         zval_ptr_dtor(&itemKey);
+      }
+      if (zend_hash_num_elements(Z_ARRVAL(chunk)) == 0 || EG(exception)) {
+         zval_ptr_dtor(&chunk);
+         return false;
+      }
+      ZVAL_LONG(key, m_taken[stageIndex]++);
+      ZVAL_COPY_VALUE(value, &chunk);
+      return true;
+   }
+   }
+   return false;
+}
+
+zend_object *lazy_sequence_create(zend_class_entry *ce)
+{
+   LazySequenceObject *intern = reinterpret_cast<LazySequenceObject *>(
+            ecalloc(1, sizeof(LazySequenceObject) + zend_object_properties_size(ce)));
+   intern->pipeline = new SequencePipeline;
+   zend_object_std_init(&intern->std, ce);
+   object_properties_init(&intern->std, ce);
+   intern->std.handlers = &sg_lazySequenceHandlers;
+   return &intern->std;
+}
+
+void lazy_sequence_free(zend_object *object)
+{
+   LazySequenceObject *intern = lazy_sequence_from_obj(object);
+   delete intern->pipeline;
+   intern->pipeline = nullptr;
+   zend_object_std_dtor(object);
+}
+
+HashTable *lazy_sequence_get_gc(zval *object, zval **table, int *n)
+{
+   SequencePipeline *pipeline = Z_LAZY_SEQUENCE_P(object)->pipeline;
+   pipeline->gcTable.clear();
+   pipeline->gcTable.push_back(pipeline->source);
+   for (SequenceStage &stage : pipeline->stages) {
+      if (stage.hasCallable()) {
+         pipeline->gcTable.push_back(stage.callable);
+      }
+   }
+   *table = pipeline->gcTable.data();
+   *n = static_cast<int>(pipeline->gcTable.size());
+   return zend_std_get_properties(object);
+}
+
+/// a new sequence running the stages of \p object followed by \p stage
+void lazy_sequence_append(zval *object, SequenceStage &&stage, zval *return_value)
+{
+   object_init_ex(return_value, Z_OBJCE_P(object));
+   LazySequenceObject *result = Z_LAZY_SEQUENCE_P(return_value);
+   delete result->pipeline;
+   result->pipeline = new SequencePipeline(*Z_LAZY_SEQUENCE_P(object)->pipeline);
+   result->pipeline->stages.push_back(stage);
+}
+
+struct LazySequenceIterator
+{
+   zend_object_iterator intern;
+   std::unique_ptr<SequenceCursor> cursor;
+   zval key;
+   zval value;
+   bool valid;
+};
+
+void lazy_sequence_iterator_fetch(LazySequenceIterator *iterator)
+{
+   zval_ptr_dtor(&iterator->key);
+   zval_ptr_dtor(&iterator->value);
+   ZVAL_UNDEF(&iterator->key);
+   ZVAL_UNDEF(&iterator->value);
+   iterator->valid = iterator->cursor->next(&iterator->key, &iterator->value);
+}
+
+void lazy_sequence_iterator_dtor(zend_object_iterator *iter)
+{
+   LazySequenceIterator *iterator = reinterpret_cast<LazySequenceIterator *>(iter);
+   zval_ptr_dtor(&iterator->key);
+   zval_ptr_dtor(&iterator->value);
+   iterator->~LazySequenceIterator();
+   zval_ptr_dtor(&iter->data);
+}
+
+int lazy_sequence_iterator_valid(zend_object_iterator *iter)
+{
+   return reinterpret_cast<LazySequenceIterator *>(iter)->valid ? SUCCESS : FAILURE;
+}
+
+zval *lazy_sequence_iterator_current_data(zend_object_iterator *iter)
+{
+   return &reinterpret_cast<LazySequenceIterator *>(iter)->value;
+}
+
+void lazy_sequence_iterator_current_key(zend_object_iterator *iter, zval *key)
+{
+   ZVAL_COPY(key, &reinterpret_cast<LazySequenceIterator *>(iter)->key);
+}
+
+void lazy_sequence_iterator_move_forward(zend_object_iterator *iter)
+{
+   lazy_sequence_iterator_fetch(reinterpret_cast<LazySequenceIterator *>(iter));
+}
+
+void lazy_sequence_iterator_rewind(zend_object_iterator *iter)
+{
+   LazySequenceIterator *iterator = reinterpret_cast<LazySequenceIterator *>(iter);
+   iterator->cursor.reset(new SequenceCursor(Z_LAZY_SEQUENCE_P(&iter->data)->pipeline));
+   lazy_sequence_iterator_fetch(iterator);
+}
+
+const zend_object_iterator_funcs sg_lazySequenceIteratorFuncs = {
+   lazy_sequence_iterator_dtor,
+   lazy_sequence_iterator_valid,
+   lazy_sequence_iterator_current_data,
+   lazy_sequence_iterator_current_key,
+   lazy_sequence_iterator_move_forward,
+   lazy_sequence_iterator_rewind,
+   nullptr
+};
+
+zend_object_iterator *lazy_sequence_get_iterator(zend_class_entry *ce, zval *object, int by_ref)
+{
+   if (by_ref) {
+      zend_throw_error(nullptr, "An iterator cannot be used with foreach by reference");
+      return nullptr;
+   }
+   LazySequenceIterator *iterator = reinterpret_cast<LazySequenceIterator *>(
+            emalloc(sizeof(LazySequenceIterator)));
+   new (iterator) LazySequenceIterator();
+   zend_iterator_init(&iterator->intern);
+   ZVAL_COPY(&iterator->intern.data, object);
+   iterator->intern.funcs = &sg_lazySequenceIteratorFuncs;
+   ZVAL_UNDEF(&iterator->key);
+   ZVAL_UNDEF(&iterator->value);
+   iterator->valid = false;
+   return &iterator->intern;
+}
+
+} // anonymous namespace
+
+/* {{{ proto LazySequence::__construct(iterable source) */
+ZEND_METHOD(lazy_sequence, __construct)
+{
+   zval *source;
+
+   ZEND_PARSE_PARAMETERS_START_EX(ZEND_PARSE_PARAMS_THROW, 1, 1)
+         Z_PARAM_ZVAL_DEREF(source)
+         ZEND_PARSE_PARAMETERS_END();
+
+   if (!zend_is_iterable(source)) {
+      zend_throw_exception(g_InvalidArgumentException, "Source must be an array or a Traversable", 0);
+      return;
+   }
+   SequencePipeline *pipeline = Z_LAZY_SEQUENCE_P(getThis())->pipeline;
+   zval_ptr_dtor(&pipeline->source);
+   ZVAL_COPY(&pipeline->source, source);
+}
+/* }}} */
+
+/* {{{ proto LazySequence LazySequence::map(callable callback) */
+ZEND_METHOD(lazy_sequence, map)
+{
+   zend_fcall_info fci;
+   SequenceStage stage(StageKind::Map);
+
+   ZEND_PARSE_PARAMETERS_START(1, 1)
+         Z_PARAM_FUNC(fci, stage.fcc)
+         ZEND_PARSE_PARAMETERS_END();
+
+   ZVAL_COPY(&stage.callable, &fci.function_name);
+   lazy_sequence_append(getThis(), std::move(stage), return_value);
+}
+/* }}} */
+
+/* {{{ proto LazySequence LazySequence::filter([callable callback [, int mode]]) */
+ZEND_METHOD(lazy_sequence, filter)
+{
+   zend_fcall_info fci = empty_fcall_info;
+   SequenceStage stage(StageKind::Filter);
+
+   ZEND_PARSE_PARAMETERS_START(0, 2)
+         Z_PARAM_OPTIONAL
+         Z_PARAM_FUNC_EX(fci, stage.fcc, 1, 0)
+         Z_PARAM_LONG(stage.mode)
+         ZEND_PARSE_PARAMETERS_END();
+
+   if (ZEND_FCI_INITIALIZED(fci)) {
+      ZVAL_COPY(&stage.callable, &fci.function_name);
+   }
+   lazy_sequence_append(getThis(), std::move(stage), return_value);
+}
+/* }}} */
+
+/* {{{ proto LazySequence LazySequence::take(int count) */
+ZEND_METHOD(lazy_sequence, take)
+{
+   SequenceStage stage(StageKind::Take);
+
+   ZEND_PARSE_PARAMETERS_START(1, 1)
+         Z_PARAM_LONG(stage.count)
+         ZEND_PARSE_PARAMETERS_END();
+
+   if (stage.count < 0) {
+      zend_throw_exception(g_InvalidArgumentException, "Count must not be negative", 0);
+      return;
+   }
+   lazy_sequence_append(getThis(), std::move(stage), return_value);
+}
+/* }}} */
+
+/* {{{ proto LazySequence LazySequence::chunk(int size [, bool preserve_keys]) */
+ZEND_METHOD(lazy_sequence, chunk)
+{
+   SequenceStage stage(StageKind::Chunk);
+   zend_bool preserveKeys = 0;
+
+   ZEND_PARSE_PARAMETERS_START(1, 2)
+         Z_PARAM_LONG(stage.count)
+         Z_PARAM_OPTIONAL
+         Z_PARAM_BOOL(preserveKeys)
+         ZEND_PARSE_PARAMETERS_END();
+
+   if (stage.count < 1) {
+      zend_throw_exception(g_InvalidArgumentException, "Size must be greater than 0", 0);
+      return;
+   }
+   stage.mode = preserveKeys;
+   lazy_sequence_append(getThis(), std::move(stage), return_value);
+}
+/* }}} */
+
+/* {{{ proto array LazySequence::toArray([bool preserve_keys]) */
+ZEND_METHOD(lazy_sequence, toArray)
+{
+   zend_bool preserveKeys = 1;
+   zval key;
+   zval value;
+
+   ZEND_PARSE_PARAMETERS_START(0, 1)
+         Z_PARAM_OPTIONAL
+         Z_PARAM_BOOL(preserveKeys)
+         ZEND_PARSE_PARAMETERS_END();
+
+   array_init(return_value);
+   SequenceCursor cursor(Z_LAZY_SEQUENCE_P(getThis())->pipeline);
+   while (cursor.next(&key, &value)) {
+      if (preserveKeys) {
+         array_set_zval_key(Z_ARRVAL_P(return_value), &key, &value);
+         zval_ptr_dtor(&value);
+      } else {
+         zend_hash_next_index_insert(Z_ARRVAL_P(return_value), &value);
+      }
+      zval_ptr_dtor(&key);
+   }
+}
+/* }}} */
+
+/* {{{ proto number LazySequence::sum()
+   Same conversions as array_sum() */
+ZEND_METHOD(lazy_sequence, sum)
+{
+   zval key;
+   zval value;
+
+   ZEND_PARSE_PARAMETERS_NONE();
+
+   ZVAL_LONG(return_value, 0);
+   SequenceCursor cursor(Z_LAZY_SEQUENCE_P(getThis())->pipeline);
+   while (cursor.next(&key, &value)) {
+      if (Z_TYPE(value) != IS_ARRAY && Z_TYPE(value) != IS_OBJECT) {
+         convert_scalar_to_number(&value);
+         fast_add_function(return_value, return_value, &value);
+      }
+      zval_ptr_dtor(&key);
+      zval_ptr_dtor(&value);
+   }
+}
+/* }}} */
+
+/* {{{ proto mixed LazySequence::reduce(callable callback [, mixed initial]) */
+ZEND_METHOD(lazy_sequence, reduce)
+{
+   zend_fcall_info fci;
+   SequenceStage reducer(StageKind::Map);
+   zval *initial = nullptr;
+   zval key;
+   zval args[2];
+
+   ZEND_PARSE_PARAMETERS_START(1, 2)
+         Z_PARAM_FUNC(fci, reducer.fcc)
+         Z_PARAM_OPTIONAL
+         Z_PARAM_ZVAL(initial)
+         ZEND_PARSE_PARAMETERS_END();
+
+   ZVAL_COPY(&reducer.callable, &fci.function_name);
+   if (initial) {
+      ZVAL_COPY(return_value, initial);
+   } else {
+      ZVAL_NULL(return_value);
+   }
+   SequenceCursor cursor(Z_LAZY_SEQUENCE_P(getThis())->pipeline);
+   while (cursor.next(&key, &args[1])) {
+      zval retval;
+      ZVAL_COPY_VALUE(&args[0], return_value);
+      bool called = reducer.call(&retval, 2, args);
+      zval_ptr_dtor(&args[0]);
+      zval_ptr_dtor(&args[1]);
+      zval_ptr_dtor(&key);
+      if (!called) {
+         ZVAL_NULL(return_value);
+         return;
+      }
+      ZVAL_COPY_VALUE(return_value, &retval);
+   }
+}
+/* }}} */
+
+/* {{{ proto int LazySequence::count() */
+ZEND_METHOD(lazy_sequence, count)
+{
+   zval key;
+   zval value;
+   zend_long count = 0;
+
+   ZEND_PARSE_PARAMETERS_NONE();
+
+   SequenceCursor cursor(Z_LAZY_SEQUENCE_P(getThis())->pipeline);
+   while (cursor.next(&key, &value)) {
+      ++count;
+      zval_ptr_dtor(&key);
+      zval_ptr_dtor(&value);
+   }
+   RETURN_LONG(count);
+}
+/* }}} */
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_lazy_sequence___construct, 0, 0, 1)
+   ZEND_ARG_INFO(0, source)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_lazy_sequence_map, 0, 0, 1)
+   ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_lazy_sequence_filter, 0, 0, 0)
+   ZEND_ARG_INFO(0, callback)
+   ZEND_ARG_INFO(0, mode)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_lazy_sequence_take, 0, 0, 1)
+   ZEND_ARG_INFO(0, count)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_lazy_sequence_chunk, 0, 0, 1)
+   ZEND_ARG_INFO(0, size)
+   ZEND_ARG_INFO(0, preserve_keys)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_lazy_sequence_to_array, 0, 0, 0)
+   ZEND_ARG_INFO(0, preserve_keys)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_lazy_sequence_reduce, 0, 0, 1)
+   ZEND_ARG_INFO(0, callback)
+   ZEND_ARG_INFO(0, initial)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO(arginfo_lazy_sequence__void, 0)
+ZEND_END_ARG_INFO()
+
+static const zend_function_entry sg_lazySequenceFunctions[] = {
+   ZEND_ME(lazy_sequence, __construct, arginfo_lazy_sequence___construct, ZEND_ACC_PUBLIC)
+   ZEND_ME(lazy_sequence, map, arginfo_lazy_sequence_map, ZEND_ACC_PUBLIC)
+   ZEND_ME(lazy_sequence, filter, arginfo_lazy_sequence_filter, ZEND_ACC_PUBLIC)
+   ZEND_ME(lazy_sequence, take, arginfo_lazy_sequence_take, ZEND_ACC_PUBLIC)
+   ZEND_ME(lazy_sequence, chunk, arginfo_lazy_sequence_chunk, ZEND_ACC_PUBLIC)
+   ZEND_ME(lazy_sequence, toArray, arginfo_lazy_sequence_to_array, ZEND_ACC_PUBLIC)
+   ZEND_ME(lazy_sequence, sum, arginfo_lazy_sequence__void, ZEND_ACC_PUBLIC)
+   ZEND_ME(lazy_sequence, reduce, arginfo_lazy_sequence_reduce, ZEND_ACC_PUBLIC)
+   ZEND_ME(lazy_sequence, count, arginfo_lazy_sequence__void, ZEND_ACC_PUBLIC)
+   PHP_FE_END
+};
+
+PHP_MINIT_FUNCTION(lazysequence)
+{
+   zend_class_entry ce;
+   memcpy(&sg_lazySequenceHandlers, &std_object_handlers, sizeof(zend_object_handlers));
+   sg_lazySequenceHandlers.offset = XtOffsetOf(LazySequenceObject, std);
+   sg_lazySequenceHandlers.free_obj = lazy_sequence_free;
+   sg_lazySequenceHandlers.clone_obj = nullptr;
+   sg_lazySequenceHandlers.get_gc = lazy_sequence_get_gc;
+
+   INIT_CLASS_ENTRY(ce, "LazySequence", sg_lazySequenceFunctions);
+   ce.create_object = lazy_sequence_create;
+   g_LazySequence = zend_register_internal_class(&ce);
+   g_LazySequence->ce_flags |= ZEND_ACC_FINAL;
+   g_LazySequence->get_iterator = lazy_sequence_get_iterator;
+   zend_class_implements(g_LazySequence, 2, zend_ce_traversable, zend_ce_countable);
+   return SUCCESS;
+}
+
+} // runtime
+} // polar
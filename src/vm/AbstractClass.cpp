@@ -473,7 +473,7 @@ zend_object_iterator *AbstractClassPrivate::getIterator(zend_class_entry *entry,
       // the iteraters itself, we can no longer let c++ allocate the buffer + object
       // directly, so we first allocate the buffer, which is going to be cleaned up by php)
       void *buffer = emalloc(sizeof(IteratorBridge));
-      IteratorBridge *iteratorBridge = new (buffer)IteratorBridge(object, iterator);
+      IteratorBridge *iteratorBridge = new (buffer)IteratorBridge(object, iterator, traversable->createsIterator());
       return iteratorBridge->getZendIterator();
    } catch (Exception &exception) {
       process_exception(exception);
@@ -15,8 +15,9 @@
 namespace polar {
 namespace vmapi {
 
-IteratorBridge::IteratorBridge(zval *object, AbstractIterator *iterator)
-   : m_userspaceIterator(iterator)
+IteratorBridge::IteratorBridge(zval *object, AbstractIterator *iterator, bool ownsIterator)
+   : m_userspaceIterator(iterator),
+     m_ownsIterator(ownsIterator)
 {
    zend_iterator_init(&m_iterator);
    ZVAL_COPY(&m_iterator.data, object);
@@ -26,6 +27,9 @@ IteratorBridge::IteratorBridge(zval *object, AbstractIterator *iterator)
 IteratorBridge::~IteratorBridge()
 {
    invalidate();
+   if (m_ownsIterator) {
+      delete m_userspaceIterator;
+   }
    zval_ptr_dtor(&m_iterator.data);
 }
 
@@ -94,6 +94,17 @@ TSRM_API void tsrm_shutdown(void);
 /* allocates a new thread-safe-resource id */
 TSRM_API ts_rsrc_id ts_allocate_id(ts_rsrc_id *rsrc_id, size_t size, ts_allocate_ctor ctor, ts_allocate_dtor dtor);
 
+/* reserves space inside every thread's resource block for fast resources,
+ * must be called right after tsrm_startup() and before any thread is created */
+TSRM_API void tsrm_reserve(size_t size);
+
+/* allocates a new fast thread-safe-resource id, the resource lives at a fixed
+ * offset from the thread's resource block and can be reached through
+ * TSRMG_FAST() without indexing the storage array. There is no slow path to
+ * fall back to, the process aborts when the space reserved by tsrm_reserve()
+ * is missing or used up */
+TSRM_API ts_rsrc_id ts_allocate_fast_id(ts_rsrc_id *rsrc_id, size_t *offset, size_t size, ts_allocate_ctor ctor, ts_allocate_dtor dtor);
+
 /* fetches the requested resource for the current thread */
 TSRM_API void *ts_resource_ex(ts_rsrc_id id, THREAD_T *th_id);
 #define ts_resource(id)			ts_resource_ex(id, NULL)
@@ -155,6 +166,10 @@ TSRM_API const char *tsrm_api_name(void);
 # endif
 #endif
 
+#define TSRM_ALIGNED_SIZE(size) \
+	(((size) + TSRM_ALIGNMENT - 1) & ~(TSRM_ALIGNMENT - 1))
+#define TSRM_ALIGNMENT 8
+
 #define TSRM_SHUFFLE_RSRC_ID(rsrc_id)		((rsrc_id)+1)
 #define TSRM_UNSHUFFLE_RSRC_ID(rsrc_id)		((rsrc_id)-1)
 
@@ -163,8 +178,13 @@ TSRM_API const char *tsrm_api_name(void);
 #define TSRMG(id, type, element)	(TSRMG_BULK(id, type)->element)
 #define TSRMG_BULK(id, type)	((type) (*((void ***) tsrm_get_ls_cache()))[TSRM_UNSHUFFLE_RSRC_ID(id)])
 
+#define TSRMG_FAST(offset, type, element)	(TSRMG_FAST_BULK(offset, type)->element)
+#define TSRMG_FAST_BULK(offset, type)	((type) (((char*) tsrm_get_ls_cache())+(offset)))
+
 #define TSRMG_STATIC(id, type, element)	(TSRMG_BULK_STATIC(id, type)->element)
 #define TSRMG_BULK_STATIC(id, type)	((type) (*((void ***) TSRMLS_CACHE))[TSRM_UNSHUFFLE_RSRC_ID(id)])
+#define TSRMG_FAST_STATIC(offset, type, element)	(TSRMG_FAST_BULK_STATIC(offset, type)->element)
+#define TSRMG_FAST_BULK_STATIC(offset, type)	((type) (((char*) TSRMLS_CACHE)+(offset)))
 #define TSRMLS_CACHE_EXTERN() extern TSRM_TLS void *TSRMLS_CACHE;
 #define TSRMLS_CACHE_DEFINE() TSRM_TLS void *TSRMLS_CACHE = NULL;
 #if ZEND_DEBUG
@@ -194,6 +214,7 @@ TSRM_API const char *tsrm_api_name(void);
 #define TSRMLS_SET_CTX(ctx)
 
 #define TSRMG_STATIC(id, type, element)
+#define TSRMG_FAST_STATIC(offset, type, element)
 #define TSRMLS_CACHE_EXTERN()
 #define TSRMLS_CACHE_DEFINE()
 #define TSRMLS_CACHE_UPDATE()
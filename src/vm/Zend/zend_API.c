@@ -1828,6 +1828,10 @@ ZEND_API int add_property_zval_ex(zval *arg, const char *key, size_t key_len, zv
 }
 /* }}} */
 
+/* When set, called right before (done is 0) and after (done is 1) the startup
+ * function of every module, the startup profiler times the modules with it */
+ZEND_API void (*zend_module_startup_observer)(zend_module_entry *module, int done) = NULL;
+
 ZEND_API int zend_startup_module_ex(zend_module_entry *module) /* {{{ */
 {
    size_t name_len;
@@ -1875,11 +1879,17 @@ ZEND_API int zend_startup_module_ex(zend_module_entry *module) /* {{{ */
    }
    if (module->module_startup_func) {
       EG(current_module) = module;
+      if (zend_module_startup_observer) {
+         zend_module_startup_observer(module, 0);
+      }
       if (module->module_startup_func(module->type, module->module_number)==FAILURE) {
          zend_error_noreturn(E_CORE_ERROR,"Unable to start %s module", module->name);
          EG(current_module) = NULL;
          return FAILURE;
       }
+      if (zend_module_startup_observer) {
+         zend_module_startup_observer(module, 1);
+      }
       EG(current_module) = NULL;
    }
    return SUCCESS;
@@ -2782,6 +2792,104 @@ ZEND_API zend_class_entry *zend_register_internal_interface(zend_class_entry *or
 }
 /* }}} */
 
+/* {{{ Lazy registration
+ * Modules with a large number of functions and classes may leave them out of
+ * the tables at startup, the handlers register the missing name on first
+ * lookup and return SUCCESS when they did. */
+ZEND_API int (*zend_lazy_function_handler)(zend_string *lcname) = NULL;
+ZEND_API int (*zend_lazy_class_handler)(zend_string *lcname) = NULL;
+
+#ifdef ZTS
+static int lazy_static_members_next = 0;
+#endif
+
+ZEND_API zval *zend_lazy_function_find(zend_string *lcname) /* {{{ */
+{
+   if (zend_lazy_function_handler && zend_lazy_function_handler(lcname) == SUCCESS) {
+      return zend_hash_find(EG(function_table), lcname);
+   }
+   return NULL;
+}
+/* }}} */
+
+ZEND_API zval *zend_lazy_class_find(zend_string *lcname) /* {{{ */
+{
+   if (zend_lazy_class_handler && zend_lazy_class_handler(lcname) == SUCCESS) {
+      return zend_hash_find(EG(class_table), lcname);
+   }
+   return NULL;
+}
+/* }}} */
+
+/* Entries registered until zend_lazy_registration_end() belong to module and
+ * are persistent, even when the registration happens inside a request. */
+ZEND_API zend_module_entry *zend_lazy_registration_begin(zend_module_entry *module) /* {{{ */
+{
+   zend_module_entry *current_module = EG(current_module);
+
+   EG(current_module) = module;
+   zend_interned_strings_begin_late();
+   return current_module;
+}
+/* }}} */
+
+ZEND_API void zend_lazy_registration_end(zend_module_entry *current_module) /* {{{ */
+{
+   zend_interned_strings_end_late();
+   EG(current_module) = current_module;
+   if (EG(active)) {
+      /* the fast shutdown would discard the internal entries added after the
+       * persistent ones, the full one keeps them for the next requests */
+      EG(full_tables_cleanup) = 1;
+   }
+}
+/* }}} */
+
+static void zend_lazy_reserve_static_members(zend_class_entry *ce) /* {{{ */
+{
+#ifdef ZTS
+   int n = (int)(zend_intptr_t)ce->static_members_table;
+
+   if (n >= CG(last_static_member)) {
+      CG(static_members_table) = realloc(CG(static_members_table), (n + 1) * sizeof(zval*));
+      memset(CG(static_members_table) + CG(last_static_member), 0, (n + 1 - CG(last_static_member)) * sizeof(zval*));
+      CG(last_static_member) = n + 1;
+   }
+#endif
+}
+/* }}} */
+
+/* Called once after a lazily registered class entry was created, the class
+ * gets a static members slot no thread uses yet, so that the entry can be
+ * shared by every thread. The callers serialize the calls. */
+ZEND_API void zend_lazy_class_registered(zend_class_entry *ce) /* {{{ */
+{
+#ifdef ZTS
+   if (lazy_static_members_next < CG(last_static_member)) {
+      lazy_static_members_next = CG(last_static_member);
+   }
+   ce->static_members_table = (zval*)(zend_intptr_t)lazy_static_members_next++;
+   zend_lazy_reserve_static_members(ce);
+#endif
+}
+/* }}} */
+
+/* Add a class entry registered lazily by another thread to the class table
+ * of the current thread. */
+ZEND_API void zend_lazy_class_add(zend_class_entry *ce) /* {{{ */
+{
+   zend_module_entry *current_module = zend_lazy_registration_begin(ce->info.internal.module);
+   zend_string *lcname = zend_new_interned_string(zend_string_tolower_ex(ce->name, 1));
+
+   zend_lazy_reserve_static_members(ce);
+   if (zend_hash_add_ptr(CG(class_table), lcname, ce) != NULL) {
+      ce->refcount++;
+   }
+   zend_lazy_registration_end(current_module);
+}
+/* }}} */
+/* }}} */
+
 ZEND_API int zend_register_class_alias_ex(const char *name, size_t name_len, zend_class_entry *ce, int persistent) /* {{{ */
 {
    zend_string *lcname;
@@ -2843,7 +2951,8 @@ ZEND_API int zend_disable_function(char *function_name, size_t function_name_len
 {
    zend_internal_function *func;
    if ((func = zend_hash_str_find_ptr(CG(function_table), function_name, function_name_length))) {
-       func->fn_flags &= ~(ZEND_ACC_VARIADIC | ZEND_ACC_HAS_TYPE_HINTS);
+      /* the handler warns, it may not run off the executor thread */
+      func->fn_flags &= ~(ZEND_ACC_VARIADIC | ZEND_ACC_HAS_TYPE_HINTS | ZEND_ACC_THREAD_SAFE);
       func->num_args = 0;
       func->arg_info = NULL;
       func->handler = ZEND_FN(display_disabled_function);
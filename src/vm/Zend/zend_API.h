@@ -56,6 +56,17 @@ typedef struct _zend_fcall_info_cache {
    zend_object *object;
 } zend_fcall_info_cache;
 
+/* The call frame of a callable pushed once and reused by every call, see
+ * zend_fcall_prepare() */
+typedef struct _zend_fcall_prepared {
+   zend_execute_data *call;
+   zend_function *function_handler;
+   zend_class_entry *called_scope;
+   zend_object *object;
+   uint32_t call_info;
+   uint32_t param_count;
+} zend_fcall_prepared;
+
 #define ZEND_NS_NAME(ns, name)			ns "\\" name
 
 #define ZEND_FN(name) zif_##name
@@ -72,8 +83,10 @@ typedef struct _zend_fcall_info_cache {
 #define ZEND_NAMED_FE(zend_name, name, arg_info)	ZEND_FENTRY(zend_name, name, arg_info, 0)
 #define ZEND_FE(name, arg_info)						ZEND_FENTRY(name, ZEND_FN(name), arg_info, 0)
 #define ZEND_DEP_FE(name, arg_info)                 ZEND_FENTRY(name, ZEND_FN(name), arg_info, ZEND_ACC_DEPRECATED)
+#define ZEND_TS_FE(name, arg_info)                  ZEND_FENTRY(name, ZEND_FN(name), arg_info, ZEND_ACC_THREAD_SAFE)
 #define ZEND_FALIAS(name, alias, arg_info)			ZEND_FENTRY(name, ZEND_FN(alias), arg_info, 0)
 #define ZEND_DEP_FALIAS(name, alias, arg_info)		ZEND_FENTRY(name, ZEND_FN(alias), arg_info, ZEND_ACC_DEPRECATED)
+#define ZEND_TS_FALIAS(name, alias, arg_info)		ZEND_FENTRY(name, ZEND_FN(alias), arg_info, ZEND_ACC_THREAD_SAFE)
 #define ZEND_NAMED_ME(zend_name, name, arg_info, flags)	ZEND_FENTRY(zend_name, name, arg_info, flags)
 #define ZEND_ME(classname, name, arg_info, flags)	ZEND_FENTRY(name, ZEND_MN(classname##_##name), arg_info, flags)
 #define ZEND_ABSTRACT_ME(classname, name, arg_info)	ZEND_FENTRY(name, NULL, arg_info, ZEND_ACC_PUBLIC|ZEND_ACC_ABSTRACT)
@@ -276,6 +289,7 @@ ZEND_API int zend_startup_module(zend_module_entry *module_entry);
 ZEND_API zend_module_entry* zend_register_internal_module(zend_module_entry *module_entry);
 ZEND_API zend_module_entry* zend_register_module_ex(zend_module_entry *module);
 ZEND_API int zend_startup_module_ex(zend_module_entry *module);
+ZEND_API extern void (*zend_module_startup_observer)(zend_module_entry *module, int done);
 ZEND_API int zend_startup_modules(void);
 ZEND_API void zend_collect_module_handlers(void);
 ZEND_API void zend_destroy_modules(void);
@@ -288,6 +302,15 @@ ZEND_API void zend_class_implements(zend_class_entry *class_entry, int num_inter
 
 ZEND_API int zend_register_class_alias_ex(const char *name, size_t name_len, zend_class_entry *ce, int persistent);
 
+ZEND_API extern int (*zend_lazy_function_handler)(zend_string *lcname);
+ZEND_API extern int (*zend_lazy_class_handler)(zend_string *lcname);
+ZEND_API zval *zend_lazy_function_find(zend_string *lcname);
+ZEND_API zval *zend_lazy_class_find(zend_string *lcname);
+ZEND_API zend_module_entry *zend_lazy_registration_begin(zend_module_entry *module);
+ZEND_API void zend_lazy_registration_end(zend_module_entry *current_module);
+ZEND_API void zend_lazy_class_registered(zend_class_entry *ce);
+ZEND_API void zend_lazy_class_add(zend_class_entry *ce);
+
 #define zend_register_class_alias(name, ce) \
    zend_register_class_alias_ex(name, sizeof(name)-1, ce, 1)
 #define zend_register_ns_class_alias(ns, name, ce) \
@@ -532,6 +555,19 @@ ZEND_API int zend_fcall_info_call(zend_fcall_info *fci, zend_fcall_info_cache *f
 
 ZEND_API int zend_call_function(zend_fcall_info *fci, zend_fcall_info_cache *fci_cache);
 
+/** Push the call frame of a resolved callable once for param_count arguments,
+ * for an internal function calling the same callable in a loop. The frame is
+ * reinitialized in place by zend_call_prepared(), the arguments are copied
+ * into it and user functions enter zend_execute_ex() directly. Callables the
+ * fast path does not handle (magic, deprecated, generators, by-reference
+ * parameters) leave prepared->call NULL and go through zend_call_function().
+ * The frame must be released by zend_fcall_prepared_release() before the
+ * internal function returns.
+ */
+ZEND_API void zend_fcall_prepare(zend_fcall_prepared *prepared, zend_fcall_info_cache *fci_cache, uint32_t param_count);
+ZEND_API int zend_call_prepared(zend_fcall_prepared *prepared, zend_fcall_info *fci, zend_fcall_info_cache *fci_cache);
+ZEND_API void zend_fcall_prepared_release(zend_fcall_prepared *prepared);
+
 ZEND_API int zend_set_hash_symbol(zval *symbol, const char *name, int name_length, zend_bool is_ref, int num_symbol_tables, ...);
 
 ZEND_API int zend_delete_global_variable(zend_string *name);
@@ -85,6 +85,7 @@ static ZEND_FUNCTION(gc_enabled);
 static ZEND_FUNCTION(gc_enable);
 static ZEND_FUNCTION(gc_disable);
 static ZEND_FUNCTION(gc_status);
+static ZEND_FUNCTION(inline_cache_status);
 
 /* {{{ arginfo */
 ZEND_BEGIN_ARG_INFO(arginfo_zend__void, 0)
@@ -294,6 +295,7 @@ static const zend_function_entry builtin_functions[] = { /* {{{ */
 	ZEND_FE(gc_enable, 		arginfo_zend__void)
 	ZEND_FE(gc_disable, 		arginfo_zend__void)
 	ZEND_FE(gc_status, 		arginfo_zend__void)
+	ZEND_FE(inline_cache_status, 	arginfo_zend__void)
 	ZEND_FE_END
 };
 /* }}} */
@@ -435,6 +437,27 @@ ZEND_FUNCTION(gc_status)
 }
 /* }}} */
 
+/* {{{ proto array inline_cache_status(void)
+   Returns method and property inline cache statistics of the current request */
+ZEND_FUNCTION(inline_cache_status)
+{
+	zend_inline_cache_stats *stats = &EG(inline_cache_stats);
+
+	if (zend_parse_parameters_none() == FAILURE) {
+		return;
+	}
+
+	array_init_size(return_value, 6);
+
+	add_assoc_bool_ex(return_value, "enabled", sizeof("enabled")-1, ZEND_INLINE_CACHE_STATS);
+	add_assoc_long_ex(return_value, "ways", sizeof("ways")-1, ZEND_INLINE_CACHE_WAYS);
+	add_assoc_long_ex(return_value, "hits", sizeof("hits")-1, (zend_long)stats->hits);
+	add_assoc_long_ex(return_value, "polymorphic_hits", sizeof("polymorphic_hits")-1, (zend_long)stats->polymorphic_hits);
+	add_assoc_long_ex(return_value, "misses", sizeof("misses")-1, (zend_long)stats->misses);
+	add_assoc_long_ex(return_value, "evictions", sizeof("evictions")-1, (zend_long)stats->evictions);
+}
+/* }}} */
+
 /* {{{ proto int func_num_args(void)
    Get the number of arguments that were passed to the function */
 ZEND_FUNCTION(func_num_args)
@@ -1198,6 +1221,8 @@ ZEND_FUNCTION(get_object_vars)
 		RETURN_ARR(zend_proptable_to_symtable(properties, 1));
 	} else {
 		array_init_size(return_value, zend_hash_num_elements(properties));
+		/* most objects are small records */
+		zend_hash_real_init_small(Z_ARRVAL_P(return_value));
 
 		ZEND_HASH_FOREACH_KEY_VAL(properties, num_key, key, value) {
 			zend_bool unmangle = 0;
@@ -1441,6 +1466,11 @@ ZEND_FUNCTION(class_exists)
 		}
 
 		ce = zend_hash_find_ptr(EG(class_table), lc_name);
+		if (!ce) {
+			zval *zv = zend_lazy_class_find(lc_name);
+
+			ce = zv ? Z_PTR_P(zv) : NULL;
+		}
 		zend_string_release_ex(lc_name, 0);
 	} else {
 		ce = zend_lookup_class(class_name);
@@ -1477,6 +1507,11 @@ ZEND_FUNCTION(interface_exists)
 			lc_name = zend_string_tolower(iface_name);
 		}
 		ce = zend_hash_find_ptr(EG(class_table), lc_name);
+		if (!ce) {
+			zval *zv = zend_lazy_class_find(lc_name);
+
+			ce = zv ? Z_PTR_P(zv) : NULL;
+		}
 		zend_string_release_ex(lc_name, 0);
 		RETURN_BOOL(ce && ce->ce_flags & ZEND_ACC_INTERFACE);
 	}
@@ -1514,6 +1549,11 @@ ZEND_FUNCTION(trait_exists)
 		}
 
 		ce = zend_hash_find_ptr(EG(class_table), lc_name);
+		if (!ce) {
+			zval *zv = zend_lazy_class_find(lc_name);
+
+			ce = zv ? Z_PTR_P(zv) : NULL;
+		}
 		zend_string_release_ex(lc_name, 0);
 	} else {
 		ce = zend_lookup_class(trait_name);
@@ -1548,6 +1588,11 @@ ZEND_FUNCTION(function_exists)
 	}
 
 	func = zend_hash_find_ptr(EG(function_table), lcname);
+	if (!func) {
+		zval *zv = zend_lazy_function_find(lcname);
+
+		func = zv ? Z_PTR_P(zv) : NULL;
+	}
 	zend_string_release_ex(lcname, 0);
 
 	/*
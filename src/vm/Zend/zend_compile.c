@@ -78,6 +78,13 @@ static inline uint32_t zend_alloc_polymorphic_cache_slot(void) {
 	return ret;
 }
 
+static inline uint32_t zend_alloc_inline_cache_slot(void) {
+	zend_op_array *op_array = CG(active_op_array);
+	uint32_t ret = op_array->cache_size;
+	op_array->cache_size += ZEND_INLINE_CACHE_SLOT_SIZE * sizeof(void*);
+	return ret;
+}
+
 ZEND_API zend_op_array *(*zend_compile_file)(zend_file_handle *file_handle, int type);
 ZEND_API zend_op_array *(*zend_compile_string)(zval *source_string, char *filename);
 
@@ -2688,7 +2695,7 @@ static zend_op *zend_delayed_compile_prop(znode *result, zend_ast *ast, uint32_t
 	opline = zend_delayed_emit_op(result, ZEND_FETCH_OBJ_R, &obj_node, &prop_node);
 	if (opline->op2_type == IS_CONST) {
 		convert_to_string(CT_CONSTANT(opline->op2));
-		opline->extended_value = zend_alloc_polymorphic_cache_slot();
+		opline->extended_value = zend_alloc_inline_cache_slot();
 	}
 
 	zend_adjust_for_fetch_type(opline, result, type);
@@ -4064,7 +4071,7 @@ void zend_compile_method_call(znode *result, zend_ast *ast, uint32_t type) /* {{
 		opline->op2_type = IS_CONST;
 		opline->op2.constant = zend_add_func_name_literal(CG(active_op_array),
 			Z_STR(method_node.u.constant));
-		opline->result.num = zend_alloc_polymorphic_cache_slot();
+		opline->result.num = zend_alloc_inline_cache_slot();
 	} else {
 		SET_NODE(opline->op2, &method_node);
 	}
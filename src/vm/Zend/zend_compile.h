@@ -260,7 +260,7 @@ typedef struct _zend_oparray_context {
 /* __isset that use guards                                |     |     |     */
 #define ZEND_ACC_USE_GUARDS              (1 << 24) /*  X  |     |     |     */
 /*                                                        |     |     |     */
-/* Function Flags (unused: 4, 5, 17?)                     |     |     |     */
+/* Function Flags (unused: 5, 17?)                        |     |     |     */
 /* ==============                                         |     |     |     */
 /*                                                        |     |     |     */
 /* Abstarct method                                        |     |     |     */
@@ -269,6 +269,12 @@ typedef struct _zend_oparray_context {
 /* TODO: used only during inheritance ???                 |     |     |     */
 #define ZEND_ACC_IMPLEMENTED_ABSTRACT    (1 <<  3) /*     |  X  |     |     */
 /*                                                        |     |     |     */
+/* Internal function that can run on any thread, it       |     |     |     */
+/* neither reads the executor globals nor allocates       |     |     |     */
+/* when all of its arguments are scalars other than       |     |     |     */
+/* strings (used by array_map_parallel)                   |     |     |     */
+#define ZEND_ACC_THREAD_SAFE             (1 <<  4) /*     |  X  |     |     */
+/*                                                        |     |     |     */
 #define ZEND_ACC_FAKE_CLOSURE            (1 <<  6) /*     |  X  |     |     */
 /*                                                        |     |     |     */
 /* method flag used by Closure::__invoke()                |     |     |     */
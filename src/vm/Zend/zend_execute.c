@@ -2184,6 +2184,8 @@ str_offset:
 
 static zend_always_inline void zend_fetch_property_address(zval *result, zval *container, uint32_t container_op_type, zval *prop_ptr, uint32_t prop_op_type, void **cache_slot, int type OPLINE_DC)
 {
+	void **cache_entry;
+
     if (container_op_type != IS_UNUSED && UNEXPECTED(Z_TYPE_P(container) != IS_OBJECT)) {
 		do {
 			if (Z_ISREF_P(container)) {
@@ -2202,8 +2204,8 @@ static zend_always_inline void zend_fetch_property_address(zval *result, zval *c
 		} while (0);
 	}
 	if (prop_op_type == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(container) == CACHED_PTR_EX(cache_slot))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(cache_slot, Z_OBJCE_P(container))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(container);
 		zval *retval;
 
@@ -2539,7 +2541,7 @@ ZEND_API zend_function * ZEND_FASTCALL zend_fetch_function(zend_string *name) /*
 {
 	zval *zv = zend_hash_find(EG(function_table), name);
 
-	if (EXPECTED(zv != NULL)) {
+	if (EXPECTED(zv != NULL) || (zv = zend_lazy_function_find(name)) != NULL) {
 		zend_function *fbc = Z_FUNC_P(zv);
 
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
@@ -2967,7 +2969,8 @@ static zend_never_inline zend_execute_data *zend_init_dynamic_call_string(zend_s
 		} else {
 			lcname = zend_string_tolower(function);
 		}
-		if (UNEXPECTED((func = zend_hash_find(EG(function_table), lcname)) == NULL)) {
+		if (UNEXPECTED((func = zend_hash_find(EG(function_table), lcname)) == NULL)
+			&& (func = zend_lazy_function_find(lcname)) == NULL) {
 			zend_throw_error(NULL, "Call to undefined function %s()", ZSTR_VAL(function));
 			zend_string_release_ex(lcname, 0);
 			return NULL;
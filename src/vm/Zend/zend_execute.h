@@ -371,6 +371,101 @@ ZEND_API int ZEND_FASTCALL zend_do_fcall_overloaded(zend_execute_data *call, zva
 		(slot)[1] = (ptr); \
 	} while (0)
 
+/* Polymorphic inline caches.
+ * An inline cache slot keeps up to ZEND_INLINE_CACHE_WAYS (class, value)
+ * pairs, the most recently inserted one first. The first pair has the same
+ * layout as a polymorphic cache slot, so code that only checks
+ * CACHED_POLYMORPHIC_PTR() keeps working (as a monomorphic cache). */
+#define ZEND_INLINE_CACHE_WAYS 4
+#define ZEND_INLINE_CACHE_SLOT_SIZE (2 * ZEND_INLINE_CACHE_WAYS)
+
+#ifndef ZEND_INLINE_CACHE_STATS
+# define ZEND_INLINE_CACHE_STATS 0
+#endif
+
+#if ZEND_INLINE_CACHE_STATS
+# define ZEND_INLINE_CACHE_COUNT(counter) EG(inline_cache_stats).counter++
+#else
+# define ZEND_INLINE_CACHE_COUNT(counter)
+#endif
+
+/* Returns the (class, value) pair cached for "ce", or NULL on a miss */
+static zend_always_inline void **zend_inline_cache_find_ex(void **slot, const void *ce)
+{
+	void **end;
+
+	if (EXPECTED(slot[0] == ce)) {
+		return slot;
+	}
+	end = slot + ZEND_INLINE_CACHE_SLOT_SIZE;
+	/* entries are filled from the front, so the first empty one ends the scan */
+	for (slot += 2; slot < end && slot[0]; slot += 2) {
+		if (slot[0] == ce) {
+			return slot;
+		}
+	}
+	return NULL;
+}
+
+/* Same as zend_inline_cache_find_ex(), but accounted in EG(inline_cache_stats) */
+static zend_always_inline void **zend_inline_cache_find(void **slot, const void *ce)
+{
+	void **entry = zend_inline_cache_find_ex(slot, ce);
+
+#if ZEND_INLINE_CACHE_STATS
+	if (EXPECTED(entry == slot)) {
+		ZEND_INLINE_CACHE_COUNT(hits);
+	} else if (entry) {
+		ZEND_INLINE_CACHE_COUNT(polymorphic_hits);
+	} else {
+		ZEND_INLINE_CACHE_COUNT(misses);
+	}
+#endif
+	return entry;
+}
+
+/* Same as zend_inline_cache_find(), but a miss isn't accounted. The property
+ * fast paths fall back to the object handlers on a miss, where
+ * zend_get_property_offset() looks the same slot up again and accounts it */
+static zend_always_inline void **zend_inline_cache_find_hit(void **slot, const void *ce)
+{
+	void **entry = zend_inline_cache_find_ex(slot, ce);
+
+#if ZEND_INLINE_CACHE_STATS
+	if (EXPECTED(entry == slot)) {
+		ZEND_INLINE_CACHE_COUNT(hits);
+	} else if (entry) {
+		ZEND_INLINE_CACHE_COUNT(polymorphic_hits);
+	}
+#endif
+	return entry;
+}
+
+/* Inserts a new pair in front, evicting the oldest one when the slot is full */
+static zend_always_inline void zend_inline_cache_insert(void **slot, void *ce, void *ptr)
+{
+	if (slot[ZEND_INLINE_CACHE_SLOT_SIZE - 2]) {
+		ZEND_INLINE_CACHE_COUNT(evictions);
+	}
+	memmove(slot + 2, slot, (ZEND_INLINE_CACHE_SLOT_SIZE - 2) * sizeof(void*));
+	slot[0] = ce;
+	slot[1] = ptr;
+}
+
+/* Moves a found pair in front, so that code updating the cached value through
+ * "slot + 1" (e.g. dynamic property offsets) touches the right entry */
+static zend_always_inline void zend_inline_cache_promote(void **slot, void **entry)
+{
+	if (entry != slot) {
+		void *ce = entry[0];
+		void *ptr = entry[1];
+
+		memmove(slot + 2, slot, (char*)entry - (char*)slot);
+		slot[0] = ce;
+		slot[1] = ptr;
+	}
+}
+
 #define CACHE_SPECIAL (1<<0)
 
 #define IS_SPECIAL_CACHE_VAL(ptr) \
@@ -179,6 +179,8 @@ void init_executor(void) /* {{{ */
 
 	EG(each_deprecation_thrown) = 0;
 
+	memset(&EG(inline_cache_stats), 0, sizeof(zend_inline_cache_stats));
+
 	EG(persistent_constants_count) = EG(zend_constants)->nNumUsed;
 	EG(persistent_functions_count) = EG(function_table)->nNumUsed;
 	EG(persistent_classes_count)   = EG(class_table)->nNumUsed;
@@ -828,6 +830,122 @@ int zend_call_function(zend_fcall_info *fci, zend_fcall_info_cache *fci_cache) /
 }
 /* }}} */
 
+ZEND_API void zend_fcall_prepare(zend_fcall_prepared *prepared, zend_fcall_info_cache *fci_cache, uint32_t param_count) /* {{{ */
+{
+	zend_function *func = fci_cache->function_handler;
+	uint32_t i;
+
+	prepared->call = NULL;
+	prepared->param_count = param_count;
+
+	/* Only internal callers, zend_call_function() inserts a fake frame
+	 * for the others */
+	if (!func || !EG(active) || EG(exception) || !EG(current_execute_data) ||
+	    (EG(current_execute_data)->func &&
+	     ZEND_USER_CODE(EG(current_execute_data)->func->common.type))) {
+		return;
+	}
+	if (func->type == ZEND_USER_FUNCTION) {
+		if (func->op_array.fn_flags & ZEND_ACC_GENERATOR) {
+			return;
+		}
+	} else if (func->type != ZEND_INTERNAL_FUNCTION) {
+		return;
+	}
+	if (func->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_DEPRECATED)) {
+		return;
+	}
+	for (i = 0; i < param_count; i++) {
+		if (ARG_SHOULD_BE_SENT_BY_REF(func, i + 1)) {
+			return;
+		}
+	}
+
+	prepared->function_handler = func;
+	prepared->called_scope = fci_cache->called_scope;
+	prepared->object = (func->common.fn_flags & ZEND_ACC_STATIC) ?
+		NULL : fci_cache->object;
+	prepared->call = zend_vm_stack_push_call_frame(ZEND_CALL_TOP_FUNCTION | ZEND_CALL_DYNAMIC,
+		func, param_count, prepared->called_scope, prepared->object);
+	/* keeps ZEND_CALL_ALLOCATED of a frame on its own stack page */
+	prepared->call_info = ZEND_CALL_INFO(prepared->call);
+	if (UNEXPECTED(func->common.fn_flags & ZEND_ACC_CLOSURE)) {
+		prepared->call_info |= ZEND_CALL_CLOSURE;
+		if (func->common.fn_flags & ZEND_ACC_FAKE_CLOSURE) {
+			prepared->call_info |= ZEND_CALL_FAKE_CLOSURE;
+		}
+	}
+}
+/* }}} */
+
+ZEND_API int zend_call_prepared(zend_fcall_prepared *prepared, zend_fcall_info *fci, zend_fcall_info_cache *fci_cache) /* {{{ */
+{
+	zend_execute_data *call = prepared->call;
+	zend_function *func;
+	uint32_t i;
+
+	if (!call || UNEXPECTED(fci->param_count != prepared->param_count)) {
+		return zend_call_function(fci, fci_cache);
+	}
+
+	ZVAL_UNDEF(fci->retval);
+
+	if (UNEXPECTED(EG(exception))) {
+		return FAILURE;
+	}
+
+	/* The previous call may have left FREE_EXTRA_ARGS or HAS_SYMBOL_TABLE */
+	func = prepared->function_handler;
+	zend_vm_init_call_frame(call, prepared->call_info, func, prepared->param_count,
+		prepared->called_scope, prepared->object);
+
+	for (i = 0; i < prepared->param_count; i++) {
+		ZVAL_COPY_DEREF(ZEND_CALL_ARG(call, i + 1), &fci->params[i]);
+	}
+
+	if (UNEXPECTED(prepared->call_info & ZEND_CALL_CLOSURE)) {
+		/* released when the closure returns */
+		GC_ADDREF(ZEND_CLOSURE_OBJECT(func));
+	}
+
+	if (func->type == ZEND_USER_FUNCTION) {
+		const zend_op *current_opline_before_exception = EG(opline_before_exception);
+
+		zend_init_func_execute_data(call, &func->op_array, fci->retval);
+		zend_execute_ex(call);
+		EG(opline_before_exception) = current_opline_before_exception;
+	} else {
+		ZVAL_NULL(fci->retval);
+		call->prev_execute_data = EG(current_execute_data);
+		call->return_value = NULL;
+		EG(current_execute_data) = call;
+		if (EXPECTED(zend_execute_internal == NULL)) {
+			func->internal_function.handler(call, fci->retval);
+		} else {
+			zend_execute_internal(call, fci->retval);
+		}
+		EG(current_execute_data) = call->prev_execute_data;
+		zend_vm_stack_free_args(call);
+
+		if (EG(exception)) {
+			zval_ptr_dtor(fci->retval);
+			ZVAL_UNDEF(fci->retval);
+		}
+	}
+
+	return SUCCESS;
+}
+/* }}} */
+
+ZEND_API void zend_fcall_prepared_release(zend_fcall_prepared *prepared) /* {{{ */
+{
+	if (prepared->call) {
+		zend_vm_stack_free_call_frame(prepared->call);
+		prepared->call = NULL;
+	}
+}
+/* }}} */
+
 ZEND_API zend_class_entry *zend_lookup_class_ex(zend_string *name, const zval *key, int use_autoload) /* {{{ */
 {
 	zend_class_entry *ce = NULL;
@@ -853,7 +971,7 @@ ZEND_API zend_class_entry *zend_lookup_class_ex(zend_string *name, const zval *k
 	}
 
 	zv = zend_hash_find(EG(class_table), lc_name);
-	if (zv) {
+	if (zv || (zv = zend_lazy_class_find(lc_name)) != NULL) {
 		if (!key) {
 			zend_string_release_ex(lc_name, 0);
 		}
@@ -45,6 +45,8 @@
 BEGIN_EXTERN_C()
 ZEND_API extern int compiler_globals_id;
 ZEND_API extern int executor_globals_id;
+ZEND_API extern size_t compiler_globals_offset;
+ZEND_API extern size_t executor_globals_offset;
 END_EXTERN_C()
 
 #endif
@@ -128,6 +130,13 @@ struct _zend_compiler_globals {
 };
 
 
+typedef struct _zend_inline_cache_stats {
+	zend_ulong hits;             /* found in the first entry */
+	zend_ulong polymorphic_hits; /* found in one of the following entries */
+	zend_ulong misses;
+	zend_ulong evictions;
+} zend_inline_cache_stats;
+
 struct _zend_executor_globals {
 	zval uninitialized_zval;
 	zval error_zval;
@@ -230,6 +239,8 @@ struct _zend_executor_globals {
 
 	zend_bool each_deprecation_thrown;
 
+	zend_inline_cache_stats inline_cache_stats;
+
 	void *reserved[ZEND_MAX_RESERVED_RESOURCES];
 };
 
@@ -117,6 +117,62 @@ static zend_always_inline uint32_t zend_hash_check_size(uint32_t nSize)
 #endif
 }
 
+/* Small layout (HASH_FLAG_SMALL)
+ * ===============================
+ *
+ * A small table of HT_MIN_SIZE has the two slot hash part of the packed
+ * and the uninitialized tables, HT_MIN_MASK, and the slots stay
+ * HT_INVALID_IDX. A lookup takes the chained path, misses at once and only
+ * then checks for the flag, so the chained tables pay nothing on their hits.
+ * The small lookup walks the at most HT_MIN_SIZE used Buckets, 4 cache
+ * lines, compares the hash of the key with their p->h and only looks at
+ * the keys of the matching ones. A deleted Bucket keeps its hash, so a
+ * match must not be UNDEF. A table that outgrows HT_MIN_SIZE drops the flag
+ * and gets the hash part of the bigger size.
+ */
+#define ZEND_HASH_SMALL_SCAN(ht, h, p, match_expr) do { \
+		Bucket *_end = (ht)->arData + (ht)->nNumUsed; \
+		for (p = (ht)->arData; p != _end; p++) { \
+			if (p->h == (h) && EXPECTED(Z_TYPE(p->val) != IS_UNDEF) && (match_expr)) { \
+				return p; \
+			} \
+		} \
+		return NULL; \
+	} while (0)
+
+/* HT_HASH_RESET() needs the 16 slots of the chained layout at least */
+static zend_always_inline void zend_hash_reset(HashTable *ht)
+{
+	if (UNEXPECTED(HT_IS_SMALL(ht))) {
+		HT_HASH_RESET_PACKED(ht);
+	} else {
+		HT_HASH_RESET(ht);
+	}
+}
+
+static zend_never_inline Bucket *zend_hash_small_find_bucket(const HashTable *ht, zend_string *key, zend_ulong h)
+{
+	Bucket *p;
+
+	ZEND_HASH_SMALL_SCAN(ht, h, p,
+		p->key == key || (p->key && zend_string_equal_content(p->key, key)));
+}
+
+static zend_never_inline Bucket *zend_hash_small_str_find_bucket(const HashTable *ht, const char *str, size_t len, zend_ulong h)
+{
+	Bucket *p;
+
+	ZEND_HASH_SMALL_SCAN(ht, h, p,
+		p->key && ZSTR_LEN(p->key) == len && !memcmp(ZSTR_VAL(p->key), str, len));
+}
+
+static zend_never_inline Bucket *zend_hash_small_index_find_bucket(const HashTable *ht, zend_ulong h)
+{
+	Bucket *p;
+
+	ZEND_HASH_SMALL_SCAN(ht, h, p, !p->key);
+}
+
 static zend_always_inline void zend_hash_real_init_packed_ex(HashTable *ht)
 {
 	HT_SET_DATA_ADDR(ht, pemalloc(HT_SIZE_EX(ht->nTableSize, HT_MIN_MASK), GC_FLAGS(ht) & IS_ARRAY_PERSISTENT));
@@ -260,6 +316,21 @@ ZEND_API void ZEND_FASTCALL zend_hash_real_init_mixed(HashTable *ht)
 	zend_hash_real_init_mixed_ex(ht);
 }
 
+ZEND_API void ZEND_FASTCALL zend_hash_real_init_small(HashTable *ht)
+{
+	IS_CONSISTENT(ht);
+
+	HT_ASSERT_RC1(ht);
+	ZEND_ASSERT(!(HT_FLAGS(ht) & HASH_FLAG_INITIALIZED));
+	if (ht->nTableSize != HT_MIN_SIZE) {
+		zend_hash_real_init_mixed_ex(ht);
+		return;
+	}
+	HT_SET_DATA_ADDR(ht, pemalloc(HT_SIZE_EX(HT_MIN_SIZE, HT_MIN_MASK), GC_FLAGS(ht) & IS_ARRAY_PERSISTENT));
+	HT_FLAGS(ht) |= HASH_FLAG_INITIALIZED | HASH_FLAG_SMALL;
+	HT_HASH_RESET_PACKED(ht);
+}
+
 ZEND_API void ZEND_FASTCALL zend_hash_packed_to_hash(HashTable *ht)
 {
 	void *new_data, *old_data = HT_GET_DATA_ADDR(ht);
@@ -283,6 +354,7 @@ ZEND_API void ZEND_FASTCALL zend_hash_to_packed(HashTable *ht)
 
 	HT_ASSERT_RC1(ht);
 	new_data = pemalloc(HT_SIZE_EX(ht->nTableSize, HT_MIN_MASK), GC_FLAGS(ht) & IS_ARRAY_PERSISTENT);
+	HT_FLAGS(ht) &= ~HASH_FLAG_SMALL;
 	HT_FLAGS(ht) |= HASH_FLAG_PACKED | HASH_FLAG_STATIC_KEYS;
 	ht->nTableMask = HT_MIN_MASK;
 	HT_SET_DATA_ADDR(ht, new_data);
@@ -316,6 +388,7 @@ ZEND_API void ZEND_FASTCALL zend_hash_extend(HashTable *ht, uint32_t nSize, zend
 				ht->nTableSize = nSize;
 				new_data = pemalloc(HT_SIZE_EX(nSize, HT_SIZE_TO_MASK(nSize)), GC_FLAGS(ht) & IS_ARRAY_PERSISTENT);
 				ht->nTableMask = HT_SIZE_TO_MASK(ht->nTableSize);
+				HT_FLAGS(ht) &= ~HASH_FLAG_SMALL;
 				HT_SET_DATA_ADDR(ht, new_data);
 				memcpy(ht->arData, old_buckets, sizeof(Bucket) * ht->nNumUsed);
 				pefree(old_data, GC_FLAGS(ht) & IS_ARRAY_PERSISTENT);
@@ -334,6 +407,15 @@ ZEND_API void ZEND_FASTCALL zend_hash_discard(HashTable *ht, uint32_t nNumUsed)
 	p = arData + ht->nNumUsed;
 	end = arData + nNumUsed;
 	ht->nNumUsed = nNumUsed;
+	if (UNEXPECTED(HT_IS_SMALL(ht))) {
+		while (p != end) {
+			p--;
+			if (EXPECTED(Z_TYPE(p->val) != IS_UNDEF)) {
+				ht->nNumOfElements--;
+			}
+		}
+		return;
+	}
 	while (p != end) {
 		p--;
 		if (UNEXPECTED(Z_TYPE(p->val) == IS_UNDEF)) continue;
@@ -580,6 +662,9 @@ static zend_always_inline Bucket *zend_hash_find_bucket(const HashTable *ht, zen
 	idx = HT_HASH_EX(arData, nIndex);
 
 	if (UNEXPECTED(idx == HT_INVALID_IDX)) {
+		if (UNEXPECTED(HT_IS_SMALL(ht))) {
+			return zend_hash_small_find_bucket(ht, key, h);
+		}
 		return NULL;
 	}
 	p = HT_HASH_TO_BUCKET_EX(arData, idx);
@@ -624,6 +709,9 @@ static zend_always_inline Bucket *zend_hash_str_find_bucket(const HashTable *ht,
 		}
 		idx = Z_NEXT(p->val);
 	}
+	if (UNEXPECTED(HT_IS_SMALL(ht))) {
+		return zend_hash_small_str_find_bucket(ht, str, len, h);
+	}
 	return NULL;
 }
 
@@ -644,13 +732,15 @@ static zend_always_inline Bucket *zend_hash_index_find_bucket(const HashTable *h
 		}
 		idx = Z_NEXT(p->val);
 	}
+	if (UNEXPECTED(HT_IS_SMALL(ht))) {
+		return zend_hash_small_index_find_bucket(ht, h);
+	}
 	return NULL;
 }
 
 static zend_always_inline zval *_zend_hash_add_or_update_i(HashTable *ht, zend_string *key, zval *pData, uint32_t flag)
 {
 	zend_ulong h;
-	uint32_t nIndex;
 	uint32_t idx;
 	Bucket *p, *arData;
 
@@ -724,9 +814,7 @@ add_to_hash:
 	p = arData + idx;
 	p->key = key;
 	p->h = h = ZSTR_H(key);
-	nIndex = h | ht->nTableMask;
-	Z_NEXT(p->val) = HT_HASH_EX(arData, nIndex);
-	HT_HASH_EX(arData, nIndex) = HT_IDX_TO_HASH(idx);
+	_zend_hash_link(ht, p, HT_IDX_TO_HASH(idx));
 	ZVAL_COPY_VALUE(&p->val, pData);
 
 	return &p->val;
@@ -735,7 +823,6 @@ add_to_hash:
 static zend_always_inline zval *_zend_hash_str_add_or_update_i(HashTable *ht, const char *str, size_t len, zend_ulong h, zval *pData, uint32_t flag)
 {
 	zend_string *key;
-	uint32_t nIndex;
 	uint32_t idx;
 	Bucket *p;
 
@@ -792,9 +879,7 @@ add_to_hash:
 	p->h = ZSTR_H(key) = h;
 	HT_FLAGS(ht) &= ~HASH_FLAG_STATIC_KEYS;
 	ZVAL_COPY_VALUE(&p->val, pData);
-	nIndex = h | ht->nTableMask;
-	Z_NEXT(p->val) = HT_HASH(ht, nIndex);
-	HT_HASH(ht, nIndex) = HT_IDX_TO_HASH(idx);
+	_zend_hash_link(ht, p, HT_IDX_TO_HASH(idx));
 
 	return &p->val;
 }
@@ -901,7 +986,6 @@ ZEND_API zval* ZEND_FASTCALL zend_hash_str_add_empty_element(HashTable *ht, cons
 
 static zend_always_inline zval *_zend_hash_index_add_or_update_i(HashTable *ht, zend_ulong h, zval *pData, uint32_t flag)
 {
-	uint32_t nIndex;
 	uint32_t idx;
 	Bucket *p;
 
@@ -967,10 +1051,9 @@ convert_to_hash:
 	}
 
 	idx = ht->nNumUsed++;
-	nIndex = h | ht->nTableMask;
 	p = ht->arData + idx;
-	Z_NEXT(p->val) = HT_HASH(ht, nIndex);
-	HT_HASH(ht, nIndex) = HT_IDX_TO_HASH(idx);
+	p->h = h;
+	_zend_hash_link(ht, p, HT_IDX_TO_HASH(idx));
 	if ((zend_long)h >= (zend_long)ht->nNextFreeElement) {
 		ht->nNextFreeElement = h < ZEND_LONG_MAX ? h + 1 : ZEND_LONG_MAX;
 	}
@@ -1042,6 +1125,7 @@ static void ZEND_FASTCALL zend_hash_do_resize(HashTable *ht)
 		ht->nTableSize = nSize;
 		new_data = pemalloc(HT_SIZE_EX(nSize, HT_SIZE_TO_MASK(nSize)), GC_FLAGS(ht) & IS_ARRAY_PERSISTENT);
 		ht->nTableMask = HT_SIZE_TO_MASK(ht->nTableSize);
+		HT_FLAGS(ht) &= ~HASH_FLAG_SMALL;
 		HT_SET_DATA_ADDR(ht, new_data);
 		memcpy(ht->arData, old_buckets, sizeof(Bucket) * ht->nNumUsed);
 		pefree(old_data, GC_FLAGS(ht) & IS_ARRAY_PERSISTENT);
@@ -1054,26 +1138,24 @@ static void ZEND_FASTCALL zend_hash_do_resize(HashTable *ht)
 ZEND_API int ZEND_FASTCALL zend_hash_rehash(HashTable *ht)
 {
 	Bucket *p;
-	uint32_t nIndex, i;
+	uint32_t i;
 
 	IS_CONSISTENT(ht);
 
 	if (UNEXPECTED(ht->nNumOfElements == 0)) {
 		if (HT_FLAGS(ht) & HASH_FLAG_INITIALIZED) {
 			ht->nNumUsed = 0;
-			HT_HASH_RESET(ht);
+			zend_hash_reset(ht);
 		}
 		return SUCCESS;
 	}
 
-	HT_HASH_RESET(ht);
+	zend_hash_reset(ht);
 	i = 0;
 	p = ht->arData;
 	if (HT_IS_WITHOUT_HOLES(ht)) {
 		do {
-			nIndex = p->h | ht->nTableMask;
-			Z_NEXT(p->val) = HT_HASH(ht, nIndex);
-			HT_HASH(ht, nIndex) = HT_IDX_TO_HASH(i);
+			_zend_hash_link(ht, p, HT_IDX_TO_HASH(i));
 			p++;
 		} while (++i < ht->nNumUsed);
 	} else {
@@ -1088,10 +1170,8 @@ ZEND_API int ZEND_FASTCALL zend_hash_rehash(HashTable *ht)
 						if (EXPECTED(Z_TYPE_INFO(p->val) != IS_UNDEF)) {
 							ZVAL_COPY_VALUE(&q->val, &p->val);
 							q->h = p->h;
-							nIndex = q->h | ht->nTableMask;
 							q->key = p->key;
-							Z_NEXT(q->val) = HT_HASH(ht, nIndex);
-							HT_HASH(ht, nIndex) = HT_IDX_TO_HASH(j);
+							_zend_hash_link(ht, q, HT_IDX_TO_HASH(j));
 							if (UNEXPECTED(ht->nInternalPointer == i)) {
 								ht->nInternalPointer = j;
 							}
@@ -1107,10 +1187,8 @@ ZEND_API int ZEND_FASTCALL zend_hash_rehash(HashTable *ht)
 						if (EXPECTED(Z_TYPE_INFO(p->val) != IS_UNDEF)) {
 							ZVAL_COPY_VALUE(&q->val, &p->val);
 							q->h = p->h;
-							nIndex = q->h | ht->nTableMask;
 							q->key = p->key;
-							Z_NEXT(q->val) = HT_HASH(ht, nIndex);
-							HT_HASH(ht, nIndex) = HT_IDX_TO_HASH(j);
+							_zend_hash_link(ht, q, HT_IDX_TO_HASH(j));
 							if (UNEXPECTED(ht->nInternalPointer == i)) {
 								ht->nInternalPointer = j;
 							}
@@ -1128,9 +1206,7 @@ ZEND_API int ZEND_FASTCALL zend_hash_rehash(HashTable *ht)
 				ht->nNumUsed = j;
 				break;
 			}
-			nIndex = p->h | ht->nTableMask;
-			Z_NEXT(p->val) = HT_HASH(ht, nIndex);
-			HT_HASH(ht, nIndex) = HT_IDX_TO_HASH(i);
+			_zend_hash_link(ht, p, HT_IDX_TO_HASH(i));
 			p++;
 		} while (++i < ht->nNumUsed);
 	}
@@ -1139,7 +1215,8 @@ ZEND_API int ZEND_FASTCALL zend_hash_rehash(HashTable *ht)
 
 static zend_always_inline void _zend_hash_del_el_ex(HashTable *ht, uint32_t idx, Bucket *p, Bucket *prev)
 {
-	if (!(HT_FLAGS(ht) & HASH_FLAG_PACKED)) {
+	/* Only the chains need fixing, the slots of a small table stay empty */
+	if (!(HT_FLAGS(ht) & (HASH_FLAG_PACKED|HASH_FLAG_SMALL))) {
 		if (prev) {
 			Z_NEXT(prev->val) = Z_NEXT(p->val);
 		} else {
@@ -1188,7 +1265,7 @@ static zend_always_inline void _zend_hash_del_el(HashTable *ht, uint32_t idx, Bu
 {
 	Bucket *prev = NULL;
 
-	if (!(HT_FLAGS(ht) & HASH_FLAG_PACKED)) {
+	if (!(HT_FLAGS(ht) & (HASH_FLAG_PACKED|HASH_FLAG_SMALL))) {
 		uint32_t nIndex = p->h | ht->nTableMask;
 		uint32_t i = HT_HASH(ht, nIndex);
 
@@ -1232,12 +1309,20 @@ ZEND_API int ZEND_FASTCALL zend_hash_del(HashTable *ht, zend_string *key)
 			(p->h == h &&
 		     p->key &&
 		     zend_string_equal_content(p->key, key))) {
+found:
 			_zend_hash_del_el_ex(ht, idx, p, prev);
 			return SUCCESS;
 		}
 		prev = p;
 		idx = Z_NEXT(p->val);
 	}
+	if (UNEXPECTED(HT_IS_SMALL(ht))) {
+		p = zend_hash_small_find_bucket(ht, key, h);
+		if (p) {
+			idx = HT_IDX_TO_HASH(p - ht->arData);
+			goto found;
+		}
+	}
 	return FAILURE;
 }
 
@@ -1262,6 +1347,7 @@ ZEND_API int ZEND_FASTCALL zend_hash_del_ind(HashTable *ht, zend_string *key)
 			(p->h == h &&
 		     p->key &&
 		     zend_string_equal_content(p->key, key))) {
+found:
 			if (Z_TYPE(p->val) == IS_INDIRECT) {
 				zval *data = Z_INDIRECT(p->val);
 
@@ -1286,6 +1372,13 @@ ZEND_API int ZEND_FASTCALL zend_hash_del_ind(HashTable *ht, zend_string *key)
 		prev = p;
 		idx = Z_NEXT(p->val);
 	}
+	if (UNEXPECTED(HT_IS_SMALL(ht))) {
+		p = zend_hash_small_find_bucket(ht, key, h);
+		if (p) {
+			idx = HT_IDX_TO_HASH(p - ht->arData);
+			goto found;
+		}
+	}
 	return FAILURE;
 }
 
@@ -1310,6 +1403,7 @@ ZEND_API int ZEND_FASTCALL zend_hash_str_del_ind(HashTable *ht, const char *str,
 			 && p->key
 			 && (ZSTR_LEN(p->key) == len)
 			 && !memcmp(ZSTR_VAL(p->key), str, len)) {
+found:
 			if (Z_TYPE(p->val) == IS_INDIRECT) {
 				zval *data = Z_INDIRECT(p->val);
 
@@ -1330,6 +1424,13 @@ ZEND_API int ZEND_FASTCALL zend_hash_str_del_ind(HashTable *ht, const char *str,
 		prev = p;
 		idx = Z_NEXT(p->val);
 	}
+	if (UNEXPECTED(HT_IS_SMALL(ht))) {
+		p = zend_hash_small_str_find_bucket(ht, str, len, h);
+		if (p) {
+			idx = HT_IDX_TO_HASH(p - ht->arData);
+			goto found;
+		}
+	}
 	return FAILURE;
 }
 
@@ -1354,12 +1455,20 @@ ZEND_API int ZEND_FASTCALL zend_hash_str_del(HashTable *ht, const char *str, siz
 			 && p->key
 			 && (ZSTR_LEN(p->key) == len)
 			 && !memcmp(ZSTR_VAL(p->key), str, len)) {
+found:
 			_zend_hash_del_el_ex(ht, idx, p, prev);
 			return SUCCESS;
 		}
 		prev = p;
 		idx = Z_NEXT(p->val);
 	}
+	if (UNEXPECTED(HT_IS_SMALL(ht))) {
+		p = zend_hash_small_str_find_bucket(ht, str, len, h);
+		if (p) {
+			idx = HT_IDX_TO_HASH(p - ht->arData);
+			goto found;
+		}
+	}
 	return FAILURE;
 }
 
@@ -1389,12 +1498,20 @@ ZEND_API int ZEND_FASTCALL zend_hash_index_del(HashTable *ht, zend_ulong h)
 	while (idx != HT_INVALID_IDX) {
 		p = HT_HASH_TO_BUCKET(ht, idx);
 		if ((p->h == h) && (p->key == NULL)) {
+found:
 			_zend_hash_del_el_ex(ht, idx, p, prev);
 			return SUCCESS;
 		}
 		prev = p;
 		idx = Z_NEXT(p->val);
 	}
+	if (UNEXPECTED(HT_IS_SMALL(ht))) {
+		p = zend_hash_small_index_find_bucket(ht, h);
+		if (p) {
+			idx = HT_IDX_TO_HASH(p - ht->arData);
+			goto found;
+		}
+	}
 	return FAILURE;
 }
 
@@ -1573,7 +1690,7 @@ ZEND_API void ZEND_FASTCALL zend_hash_clean(HashTable *ht)
 			}
 		}
 		if (!(HT_FLAGS(ht) & HASH_FLAG_PACKED)) {
-			HT_HASH_RESET(ht);
+			zend_hash_reset(ht);
 		}
 	}
 	ht->nNumUsed = 0;
@@ -1613,7 +1730,7 @@ ZEND_API void ZEND_FASTCALL zend_symtable_clean(HashTable *ht)
 				}
 			} while (++p != end);
 		}
-		HT_HASH_RESET(ht);
+		zend_hash_reset(ht);
 	}
 	ht->nNumUsed = 0;
 	ht->nNumOfElements = 0;
@@ -1855,16 +1972,12 @@ static zend_always_inline int zend_array_dup_element(HashTable *source, HashTabl
 	if (packed) {
 		q->key = NULL;
 	} else {
-		uint32_t nIndex;
-
 		q->key = p->key;
 		if (!static_keys && q->key) {
 			zend_string_addref(q->key);
 		}
 
-		nIndex = q->h | target->nTableMask;
-		Z_NEXT(q->val) = HT_HASH(target, nIndex);
-		HT_HASH(target, nIndex) = HT_IDX_TO_HASH(idx);
+		_zend_hash_link(target, q, HT_IDX_TO_HASH(idx));
 	}
 	return 1;
 }
@@ -1928,7 +2041,7 @@ ZEND_API HashTable* ZEND_FASTCALL zend_array_dup(HashTable *source)
 	target->pDestructor = ZVAL_PTR_DTOR;
 
 	if (source->nNumOfElements == 0) {
-		HT_FLAGS(target) = (HT_FLAGS(source) & ~(HASH_FLAG_INITIALIZED|HASH_FLAG_PACKED)) | HASH_FLAG_STATIC_KEYS;
+		HT_FLAGS(target) = (HT_FLAGS(source) & ~(HASH_FLAG_INITIALIZED|HASH_FLAG_PACKED|HASH_FLAG_SMALL)) | HASH_FLAG_STATIC_KEYS;
 		target->nTableMask = HT_MIN_MASK;
 		target->nNumUsed = 0;
 		target->nNumOfElements = 0;
@@ -1971,7 +2084,7 @@ ZEND_API HashTable* ZEND_FASTCALL zend_array_dup(HashTable *source)
 				source->nInternalPointer : 0;
 
 		HT_SET_DATA_ADDR(target, emalloc(HT_SIZE(target)));
-		HT_HASH_RESET(target);
+		zend_hash_reset(target);
 
 		if (HT_HAS_STATIC_KEYS_ONLY(target)) {
 			if (HT_IS_WITHOUT_HOLES(source)) {
@@ -2461,6 +2574,7 @@ ZEND_API int ZEND_FASTCALL zend_hash_sort_ex(HashTable *ht, sort_func_t sort, co
 			Bucket *old_buckets = ht->arData;
 
 			new_data = pemalloc(HT_SIZE_EX(ht->nTableSize, HT_MIN_MASK), (GC_FLAGS(ht) & IS_ARRAY_PERSISTENT));
+			HT_FLAGS(ht) &= ~HASH_FLAG_SMALL;
 			HT_FLAGS(ht) |= HASH_FLAG_PACKED | HASH_FLAG_STATIC_KEYS;
 			ht->nTableMask = HT_MIN_MASK;
 			HT_SET_DATA_ADDR(ht, new_data);
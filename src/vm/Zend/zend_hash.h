@@ -39,12 +39,18 @@
 #define HASH_FLAG_STATIC_KEYS      (1<<4) /* long and interned strings */
 #define HASH_FLAG_HAS_EMPTY_IND    (1<<5)
 #define HASH_FLAG_ALLOW_COW_VIOLATION (1<<6)
+/* mixed table of HT_MIN_SIZE scanned instead of hashed, see
+ * zend_hash_real_init_small() */
+#define HASH_FLAG_SMALL            (1<<8)
 
 #define HT_FLAGS(ht) (ht)->u.flags
 
 #define HT_IS_PACKED(ht) \
 	((HT_FLAGS(ht) & HASH_FLAG_PACKED) != 0)
 
+#define HT_IS_SMALL(ht) \
+	((HT_FLAGS(ht) & HASH_FLAG_SMALL) != 0)
+
 #define HT_IS_WITHOUT_HOLES(ht) \
 	((ht)->nNumUsed == (ht)->nNumOfElements)
 
@@ -99,6 +105,13 @@ ZEND_API void ZEND_FASTCALL zend_hash_clean(HashTable *ht);
 ZEND_API void ZEND_FASTCALL zend_hash_real_init(HashTable *ht, zend_bool packed);
 ZEND_API void ZEND_FASTCALL zend_hash_real_init_packed(HashTable *ht);
 ZEND_API void ZEND_FASTCALL zend_hash_real_init_mixed(HashTable *ht);
+/* Initializes a mixed table of HT_MIN_SIZE with the two empty hash slots of
+ * a packed one instead of the 16 chained ones, that saves memory and the
+ * reset of the slots of the many tiny record like arrays. Its lookups scan
+ * the Buckets once the empty slot missed, which costs more than in a
+ * chained table. Growing past HT_MIN_SIZE switches it to the chained
+ * layout, a table of another size is initialized chained. */
+ZEND_API void ZEND_FASTCALL zend_hash_real_init_small(HashTable *ht);
 ZEND_API void ZEND_FASTCALL zend_hash_packed_to_hash(HashTable *ht);
 ZEND_API void ZEND_FASTCALL zend_hash_to_packed(HashTable *ht);
 ZEND_API void ZEND_FASTCALL zend_hash_extend(HashTable *ht, uint32_t nSize, zend_bool packed);
@@ -918,7 +931,7 @@ static zend_always_inline void *zend_hash_get_current_data_ptr_ex(HashTable *ht,
 
 #define ZEND_HASH_FOREACH_END_DEL() \
 			__ht->nNumOfElements--; \
-			do { \
+			if (!HT_IS_SMALL(__ht)) do { \
 				uint32_t j = HT_IDX_TO_HASH(_idx - 1); \
 				uint32_t nIndex = _p->h | __ht->nTableMask; \
 				uint32_t i = HT_HASH(__ht, nIndex); \
@@ -1068,10 +1081,23 @@ static zend_always_inline void *zend_hash_get_current_data_ptr_ex(HashTable *ht,
 		__fill_ht->nInternalPointer = 0; \
 	} while (0)
 
+/* Makes the Bucket idx of a mixed table reachable by its hash p->h, the
+ * slots of a small table stay empty */
+static zend_always_inline void _zend_hash_link(HashTable *ht, Bucket *p, uint32_t idx)
+{
+	uint32_t nIndex;
+
+	if (UNEXPECTED(HT_IS_SMALL(ht))) {
+		return;
+	}
+	nIndex = (uint32_t)p->h | ht->nTableMask;
+	Z_NEXT(p->val) = HT_HASH(ht, nIndex);
+	HT_HASH(ht, nIndex) = idx;
+}
+
 static zend_always_inline zval *_zend_hash_append_ex(HashTable *ht, zend_string *key, zval *zv, int interned)
 {
 	uint32_t idx = ht->nNumUsed++;
-	uint32_t nIndex;
 	Bucket *p = ht->arData + idx;
 
 	ZVAL_COPY_VALUE(&p->val, zv);
@@ -1082,9 +1108,7 @@ static zend_always_inline zval *_zend_hash_append_ex(HashTable *ht, zend_string
 	}
 	p->key = key;
 	p->h = ZSTR_H(key);
-	nIndex = (uint32_t)p->h | ht->nTableMask;
-	Z_NEXT(p->val) = HT_HASH(ht, nIndex);
-	HT_HASH(ht, nIndex) = HT_IDX_TO_HASH(idx);
+	_zend_hash_link(ht, p, HT_IDX_TO_HASH(idx));
 	ht->nNumOfElements++;
 	return &p->val;
 }
@@ -1097,7 +1121,6 @@ static zend_always_inline zval *_zend_hash_append(HashTable *ht, zend_string *ke
 static zend_always_inline zval *_zend_hash_append_ptr_ex(HashTable *ht, zend_string *key, void *ptr, int interned)
 {
 	uint32_t idx = ht->nNumUsed++;
-	uint32_t nIndex;
 	Bucket *p = ht->arData + idx;
 
 	ZVAL_PTR(&p->val, ptr);
@@ -1108,9 +1131,7 @@ static zend_always_inline zval *_zend_hash_append_ptr_ex(HashTable *ht, zend_str
 	}
 	p->key = key;
 	p->h = ZSTR_H(key);
-	nIndex = (uint32_t)p->h | ht->nTableMask;
-	Z_NEXT(p->val) = HT_HASH(ht, nIndex);
-	HT_HASH(ht, nIndex) = HT_IDX_TO_HASH(idx);
+	_zend_hash_link(ht, p, HT_IDX_TO_HASH(idx));
 	ht->nNumOfElements++;
 	return &p->val;
 }
@@ -1123,7 +1144,6 @@ static zend_always_inline zval *_zend_hash_append_ptr(HashTable *ht, zend_string
 static zend_always_inline void _zend_hash_append_ind(HashTable *ht, zend_string *key, zval *ptr)
 {
 	uint32_t idx = ht->nNumUsed++;
-	uint32_t nIndex;
 	Bucket *p = ht->arData + idx;
 
 	ZVAL_INDIRECT(&p->val, ptr);
@@ -1134,9 +1154,7 @@ static zend_always_inline void _zend_hash_append_ind(HashTable *ht, zend_string
 	}
 	p->key = key;
 	p->h = ZSTR_H(key);
-	nIndex = (uint32_t)p->h | ht->nTableMask;
-	Z_NEXT(p->val) = HT_HASH(ht, nIndex);
-	HT_HASH(ht, nIndex) = HT_IDX_TO_HASH(idx);
+	_zend_hash_link(ht, p, HT_IDX_TO_HASH(idx));
 	ht->nNumOfElements++;
 }
 
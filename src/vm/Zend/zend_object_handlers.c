@@ -365,8 +365,13 @@ static zend_always_inline uintptr_t zend_get_property_offset(zend_class_entry *c
 	uint32_t flags;
 	zend_class_entry *scope;
 
-	if (cache_slot && EXPECTED(ce == CACHED_PTR_EX(cache_slot))) {
-		return (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+	if (cache_slot) {
+		void **cache_entry = zend_inline_cache_find(cache_slot, ce);
+
+		if (EXPECTED(cache_entry != NULL)) {
+			zend_inline_cache_promote(cache_slot, cache_entry);
+			return (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+		}
 	}
 
 	if (UNEXPECTED(zend_hash_num_elements(&ce->properties_info) == 0)) {
@@ -423,7 +428,7 @@ exit_dynamic:
 			return ZEND_WRONG_PROPERTY_OFFSET;
 		}
 		if (cache_slot) {
-			CACHE_POLYMORPHIC_PTR_EX(cache_slot, ce, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+			zend_inline_cache_insert(cache_slot, ce, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 		}
 		return ZEND_DYNAMIC_PROPERTY_OFFSET;
 	} else if (UNEXPECTED(property_info == ZEND_WRONG_PROPERTY_INFO)) {
@@ -436,7 +441,7 @@ exit_dynamic:
 
 exit:
 	if (cache_slot) {
-		CACHE_POLYMORPHIC_PTR_EX(cache_slot, ce, (void*)(uintptr_t)property_info->offset);
+		zend_inline_cache_insert(cache_slot, ce, (void*)(uintptr_t)property_info->offset);
 	}
 	return property_info->offset;
 }
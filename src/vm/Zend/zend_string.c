@@ -37,6 +37,15 @@ static zend_string* ZEND_FASTCALL zend_string_init_interned_request(const char *
    possible on costs of locking in the thread safe builds. */
 static HashTable interned_strings_permanent;
 
+/* Strings of persistent entries registered from inside a request, like the
+   lazily registered internal functions and classes. Common to all the threads
+   as well, guarded by a mutex in the thread safe builds. */
+static HashTable interned_strings_late;
+#ifdef ZTS
+static MUTEX_T interned_strings_late_mutex;
+#endif
+ZEND_TLS int interned_strings_late_level = 0;
+
 static zend_new_interned_string_func_t interned_string_request_handler = zend_new_interned_string_request;
 static zend_string_init_interned_func_t interned_string_init_request_handler = zend_string_init_interned_request;
 static zend_string_copy_storage_func_t interned_string_copy_storage = NULL;
@@ -90,6 +99,10 @@ ZEND_API void zend_interned_strings_init(void)
 	zend_known_strings = NULL;
 
 	zend_init_interned_strings_ht(&interned_strings_permanent, 1);
+	zend_init_interned_strings_ht(&interned_strings_late, 1);
+#ifdef ZTS
+	interned_strings_late_mutex = tsrm_mutex_alloc();
+#endif
 
 	zend_new_interned_string = zend_new_interned_string_permanent;
 	zend_string_init_interned = zend_string_init_interned_permanent;
@@ -116,6 +129,10 @@ ZEND_API void zend_interned_strings_init(void)
 ZEND_API void zend_interned_strings_dtor(void)
 {
 	zend_hash_destroy(&interned_strings_permanent);
+	zend_hash_destroy(&interned_strings_late);
+#ifdef ZTS
+	tsrm_mutex_free(interned_strings_late_mutex);
+#endif
 
 	free(zend_known_strings);
 	zend_known_strings = NULL;
@@ -210,6 +227,47 @@ static zend_string* ZEND_FASTCALL zend_new_interned_string_permanent(zend_string
 	return zend_add_interned_string(str, &interned_strings_permanent, IS_STR_PERMANENT);
 }
 
+static zend_string* ZEND_FASTCALL zend_new_interned_string_late(zend_string *str)
+{
+	zend_string *ret;
+
+#ifdef ZTS
+	tsrm_mutex_lock(interned_strings_late_mutex);
+#endif
+	ret = zend_interned_string_ht_lookup(str, &interned_strings_late);
+	if (!ret) {
+		zend_ulong h = ZSTR_H(str);
+
+		ret = zend_string_init(ZSTR_VAL(str), ZSTR_LEN(str), 1);
+		ZSTR_H(ret) = h;
+		ret = zend_add_interned_string(ret, &interned_strings_late, IS_STR_PERMANENT);
+	}
+#ifdef ZTS
+	tsrm_mutex_unlock(interned_strings_late_mutex);
+#endif
+	zend_string_release(str);
+	return ret;
+}
+
+static zend_string* ZEND_FASTCALL zend_string_init_interned_late(zend_ulong h, const char *str, size_t size)
+{
+	zend_string *ret;
+
+#ifdef ZTS
+	tsrm_mutex_lock(interned_strings_late_mutex);
+#endif
+	ret = zend_interned_string_ht_lookup_ex(h, str, size, &interned_strings_late);
+	if (!ret) {
+		ret = zend_string_init(str, size, 1);
+		ZSTR_H(ret) = h;
+		ret = zend_add_interned_string(ret, &interned_strings_late, IS_STR_PERMANENT);
+	}
+#ifdef ZTS
+	tsrm_mutex_unlock(interned_strings_late_mutex);
+#endif
+	return ret;
+}
+
 static zend_string* ZEND_FASTCALL zend_new_interned_string_request(zend_string *str)
 {
 	zend_string *ret;
@@ -227,6 +285,10 @@ static zend_string* ZEND_FASTCALL zend_new_interned_string_request(zend_string *
 		return ret;
 	}
 
+	if (UNEXPECTED(interned_strings_late_level)) {
+		return zend_new_interned_string_late(str);
+	}
+
 	ret = zend_interned_string_ht_lookup(str, &CG(interned_strings));
 	if (ret) {
 		zend_string_release(str);
@@ -273,6 +335,10 @@ static zend_string* ZEND_FASTCALL zend_string_init_interned_request(const char *
 		return ret;
 	}
 
+	if (UNEXPECTED(interned_strings_late_level)) {
+		return zend_string_init_interned_late(h, str, size);
+	}
+
 	ret = zend_interned_string_ht_lookup_ex(h, str, size, &CG(interned_strings));
 	if (ret) {
 		return ret;
@@ -307,6 +373,19 @@ ZEND_API void zend_interned_strings_set_permanent_storage_copy_handlers(zend_str
 	interned_string_restore_storage = restore_handler;
 }
 
+/* Strings interned by the current thread between these calls outlive the
+   request, they are kept until the process exits. Nesting is allowed. */
+ZEND_API void zend_interned_strings_begin_late(void)
+{
+	interned_strings_late_level++;
+}
+
+ZEND_API void zend_interned_strings_end_late(void)
+{
+	ZEND_ASSERT(interned_strings_late_level > 0);
+	interned_strings_late_level--;
+}
+
 ZEND_API void zend_interned_strings_switch_storage(zend_bool request)
 {
 	if (request) {
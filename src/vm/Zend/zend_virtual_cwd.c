@@ -87,6 +87,16 @@ static cwd_state main_cwd_state; /* True global */
 
 #ifndef ZEND_WIN32
 #include <unistd.h>
+#include <sys/mman.h>
+#include <signal.h>
+# ifndef MAP_ANON
+#  ifdef MAP_ANONYMOUS
+#   define MAP_ANON MAP_ANONYMOUS
+#  endif
+# endif
+# ifdef MAP_ANON
+#  define ZEND_REALPATH_SHARED_CACHE 1
+# endif
 #else
 #include <direct.h>
 #endif
@@ -395,9 +405,12 @@ static void cwd_globals_ctor(virtual_cwd_globals *cwd_g) /* {{{ */
 }
 /* }}} */
 
+static void realpath_cache_clean_local(void);
+
 static void cwd_globals_dtor(virtual_cwd_globals *cwd_g) /* {{{ */
 {
-	realpath_cache_clean();
+	/* only this thread's cache goes away, the shared entries stay valid */
+	realpath_cache_clean_local();
 }
 /* }}} */
 
@@ -455,6 +468,7 @@ CWD_API void virtual_cwd_shutdown(void) /* {{{ */
 	tsrm_mutex_free(cwd_mutex);
 #endif
 
+	realpath_cache_shared_shutdown();
 	free(main_cwd_state.cwd); /* Don't use CWD_STATE_FREE because the non global states will probably use emalloc()/efree() */
 }
 /* }}} */
@@ -583,7 +597,277 @@ static inline zend_ulong realpath_cache_key(const char *path, size_t path_len) /
 /* }}} */
 #endif /* defined(ZEND_WIN32) */
 
-CWD_API void realpath_cache_clean(void) /* {{{ */
+#ifdef ZEND_REALPATH_SHARED_CACHE
+/* Second level of the realpath cache, shared by every worker process forked
+ * after realpath_cache_shared_startup(). It is a fixed size open addressing
+ * table in an anonymous MAP_SHARED mapping, slots are never freed so an
+ * unused slot ends a probe sequence. Every slot is guarded by a seqlock: a
+ * writer makes the sequence odd while it fills the slot, a reader copies
+ * what it needs and drops the slot if the sequence moved meanwhile.
+ *
+ * The lock word carries the pid of the writer next to the sequence, a slot
+ * left odd by a worker that died in the middle of an update is taken over
+ * by the next writer. The mapping starts with a header holding the epoch,
+ * realpath_cache_clean() bumps it and every entry stored before is stale. */
+# define REALPATH_SHARED_CACHE_SLOT_SIZE 1024
+# define REALPATH_SHARED_CACHE_PROBES    8
+
+typedef struct _realpath_shared_cache_header {
+	uint32_t  epoch;
+} realpath_shared_cache_header;
+
+typedef struct _realpath_shared_cache_slot {
+	uint64_t  lock;
+	uint32_t  epoch;
+	uint32_t  is_dir;
+	uint32_t  path_len;
+	uint32_t  realpath_len;
+	zend_ulong key;
+	time_t    expires;
+	char      data[1];
+} realpath_shared_cache_slot;
+
+# define REALPATH_SHARED_CACHE_DATA_SIZE \
+	(REALPATH_SHARED_CACHE_SLOT_SIZE - XtOffsetOf(realpath_shared_cache_slot, data))
+# define REALPATH_SHARED_CACHE_HEADER() \
+	((realpath_shared_cache_header *)realpath_shared_cache)
+# define REALPATH_SHARED_CACHE_SLOT(n) \
+	((realpath_shared_cache_slot *)(realpath_shared_cache + (((n) & realpath_shared_cache_mask) + 1) * REALPATH_SHARED_CACHE_SLOT_SIZE))
+# define REALPATH_SHARED_CACHE_LOCK(seq, pid) \
+	(((uint64_t)(uint32_t)(pid) << 32) | (uint32_t)(seq))
+# define REALPATH_SHARED_CACHE_SEQ(lock)   ((uint32_t)(lock))
+# define REALPATH_SHARED_CACHE_OWNER(lock) ((pid_t)((lock) >> 32))
+
+static char *realpath_shared_cache = NULL; /* True global */
+static size_t realpath_shared_cache_mapped = 0;
+static zend_ulong realpath_shared_cache_mask = 0;
+
+CWD_API int realpath_cache_shared_startup(zend_long size) /* {{{ */
+{
+	size_t slots = 16;
+	void *mem;
+
+	if (realpath_shared_cache || size <= 0) {
+		return SUCCESS;
+	}
+	while ((slots << 1) * REALPATH_SHARED_CACHE_SLOT_SIZE <= (size_t)size) {
+		slots <<= 1;
+	}
+	/* one more slot for the header keeps the slots aligned */
+	mem = mmap(NULL, (slots + 1) * REALPATH_SHARED_CACHE_SLOT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, -1, 0);
+	if (mem == MAP_FAILED) {
+		return FAILURE;
+	}
+	/* anonymous mappings are zero filled, every slot starts unused */
+	realpath_shared_cache = (char *)mem;
+	realpath_shared_cache_mapped = (slots + 1) * REALPATH_SHARED_CACHE_SLOT_SIZE;
+	realpath_shared_cache_mask = slots - 1;
+	return SUCCESS;
+}
+/* }}} */
+
+CWD_API void realpath_cache_shared_shutdown(void) /* {{{ */
+{
+	if (realpath_shared_cache) {
+		munmap(realpath_shared_cache, realpath_shared_cache_mapped);
+		realpath_shared_cache = NULL;
+		realpath_shared_cache_mapped = 0;
+		realpath_shared_cache_mask = 0;
+	}
+}
+/* }}} */
+
+CWD_API zend_long realpath_cache_shared_slots(void) /* {{{ */
+{
+	return realpath_shared_cache ? (zend_long)(realpath_shared_cache_mask + 1) : 0;
+}
+/* }}} */
+
+static inline uint32_t realpath_shared_cache_epoch(void) /* {{{ */
+{
+	return __atomic_load_n(&REALPATH_SHARED_CACHE_HEADER()->epoch, __ATOMIC_ACQUIRE);
+}
+/* }}} */
+
+static void realpath_shared_cache_reset(void) /* {{{ */
+{
+	__atomic_add_fetch(&REALPATH_SHARED_CACHE_HEADER()->epoch, 1, __ATOMIC_RELEASE);
+}
+/* }}} */
+
+static int realpath_shared_cache_writer_died(uint64_t lock) /* {{{ */
+{
+	pid_t owner = REALPATH_SHARED_CACHE_OWNER(lock);
+
+	/* a live thread of this process or a recycled pid keeps the slot, the
+	 * latter only until the process owning that pid exits */
+	return owner > 0 && owner != getpid() && kill(owner, 0) == -1 && errno == ESRCH;
+}
+/* }}} */
+
+static int realpath_shared_cache_find(const char *path, size_t path_len, time_t t, char *realpath, size_t *realpath_len, int *is_dir) /* {{{ */
+{
+	zend_ulong key = realpath_cache_key(path, path_len);
+	uint32_t epoch = realpath_shared_cache_epoch();
+	int i;
+
+	if (path_len >= REALPATH_SHARED_CACHE_DATA_SIZE) {
+		return 0;
+	}
+	for (i = 0; i < REALPATH_SHARED_CACHE_PROBES; i++) {
+		realpath_shared_cache_slot *slot = REALPATH_SHARED_CACHE_SLOT(key + i);
+		uint64_t lock = __atomic_load_n(&slot->lock, __ATOMIC_ACQUIRE);
+		size_t len;
+		time_t expires;
+		uint32_t slot_epoch;
+		int dir;
+
+		if (lock == 0) {
+			/* never used, the entry can't be further down */
+			return 0;
+		}
+		if ((REALPATH_SHARED_CACHE_SEQ(lock) & 1) || slot->key != key || slot->path_len != path_len) {
+			continue;
+		}
+		/* the fields may be torn by a concurrent writer, bound them before
+		 * copying and validate everything against the sequence afterwards */
+		len = slot->realpath_len;
+		expires = slot->expires;
+		slot_epoch = slot->epoch;
+		dir = slot->is_dir;
+		if (path_len + 1 + len + 1 > REALPATH_SHARED_CACHE_DATA_SIZE ||
+			memcmp(slot->data, path, path_len) != 0) {
+			continue;
+		}
+		memcpy(realpath, slot->data + path_len + 1, len);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&slot->lock, __ATOMIC_RELAXED) != lock) {
+			continue;
+		}
+		if (expires < t || slot_epoch != epoch) {
+			return 0;
+		}
+		realpath[len] = '\0';
+		*realpath_len = len;
+		*is_dir = dir;
+		return 1;
+	}
+	return 0;
+}
+/* }}} */
+
+static void realpath_shared_cache_store(realpath_shared_cache_slot *slot, zend_ulong key, const char *path, size_t path_len, const char *realpath, size_t realpath_len, int is_dir, time_t expires) /* {{{ */
+{
+	uint64_t lock = __atomic_load_n(&slot->lock, __ATOMIC_RELAXED);
+	uint32_t seq = REALPATH_SHARED_CACHE_SEQ(lock);
+
+	/* another worker is filling the slot, it will most likely store the
+	 * same path, so just leave it alone unless that worker is gone */
+	if ((seq & 1) && !realpath_shared_cache_writer_died(lock)) {
+		return;
+	}
+	/* taking over a dead writer keeps the sequence odd but moves it */
+	seq += (seq & 1) ? 2 : 1;
+	if (!__atomic_compare_exchange_n(&slot->lock, &lock, REALPATH_SHARED_CACHE_LOCK(seq, getpid()), 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+		return;
+	}
+	slot->epoch = realpath_shared_cache_epoch();
+	slot->key = key;
+	slot->is_dir = is_dir > 0;
+	slot->path_len = path_len;
+	slot->realpath_len = realpath_len;
+	slot->expires = expires;
+	if (path) {
+		memcpy(slot->data, path, path_len);
+		slot->data[path_len] = '\0';
+		memcpy(slot->data + path_len + 1, realpath, realpath_len);
+		slot->data[path_len + 1 + realpath_len] = '\0';
+	}
+	/* zero is reserved for slots that were never used */
+	seq += 1;
+	__atomic_store_n(&slot->lock, REALPATH_SHARED_CACHE_LOCK(seq ? seq : 2, 0), __ATOMIC_RELEASE);
+}
+/* }}} */
+
+static inline int realpath_shared_cache_match(realpath_shared_cache_slot *slot, zend_ulong key, const char *path, size_t path_len) /* {{{ */
+{
+	/* racy, a wrong answer only costs an lstat walk or a lost entry */
+	return slot->key == key && slot->path_len == path_len && memcmp(slot->data, path, path_len) == 0;
+}
+/* }}} */
+
+static void realpath_shared_cache_add(const char *path, size_t path_len, const char *realpath, size_t realpath_len, int is_dir, time_t t) /* {{{ */
+{
+	zend_ulong key = realpath_cache_key(path, path_len);
+	uint32_t epoch = realpath_shared_cache_epoch();
+	realpath_shared_cache_slot *victim = NULL;
+	int i;
+
+	if (path_len + 1 + realpath_len + 1 > REALPATH_SHARED_CACHE_DATA_SIZE) {
+		return;
+	}
+	for (i = 0; i < REALPATH_SHARED_CACHE_PROBES; i++) {
+		realpath_shared_cache_slot *slot = REALPATH_SHARED_CACHE_SLOT(key + i);
+		uint64_t lock = __atomic_load_n(&slot->lock, __ATOMIC_ACQUIRE);
+		int busy = REALPATH_SHARED_CACHE_SEQ(lock) & 1;
+
+		if (lock == 0 || (!busy && realpath_shared_cache_match(slot, key, path, path_len))) {
+			victim = slot;
+			break;
+		}
+		if (!victim && (busy ? realpath_shared_cache_writer_died(lock) : (slot->expires < t || slot->epoch != epoch))) {
+			victim = slot;
+		}
+	}
+	if (!victim) {
+		/* no free or expired slot in reach, replace the home slot */
+		victim = REALPATH_SHARED_CACHE_SLOT(key);
+	}
+	realpath_shared_cache_store(victim, key, path, path_len, realpath, realpath_len, is_dir, t + CWDG(realpath_cache_ttl));
+}
+/* }}} */
+
+static void realpath_shared_cache_del(const char *path, size_t path_len) /* {{{ */
+{
+	zend_ulong key = realpath_cache_key(path, path_len);
+	int i;
+
+	for (i = 0; i < REALPATH_SHARED_CACHE_PROBES; i++) {
+		realpath_shared_cache_slot *slot = REALPATH_SHARED_CACHE_SLOT(key + i);
+		uint64_t lock = __atomic_load_n(&slot->lock, __ATOMIC_ACQUIRE);
+
+		if (lock == 0) {
+			return;
+		}
+		if (!(REALPATH_SHARED_CACHE_SEQ(lock) & 1) && realpath_shared_cache_match(slot, key, path, path_len)) {
+			/* keep the slot in use so the probe sequences stay intact, an
+			 * expired entry is never returned */
+			realpath_shared_cache_store(slot, key, NULL, path_len, NULL, 0, 0, 0);
+		}
+	}
+}
+/* }}} */
+
+#else
+CWD_API int realpath_cache_shared_startup(zend_long size) /* {{{ */
+{
+	return size > 0 ? FAILURE : SUCCESS;
+}
+/* }}} */
+
+CWD_API void realpath_cache_shared_shutdown(void) /* {{{ */
+{
+}
+/* }}} */
+
+CWD_API zend_long realpath_cache_shared_slots(void) /* {{{ */
+{
+	return 0;
+}
+/* }}} */
+#endif
+
+static void realpath_cache_clean_local(void) /* {{{ */
 {
 	uint32_t i;
 
@@ -600,6 +884,18 @@ CWD_API void realpath_cache_clean(void) /* {{{ */
 }
 /* }}} */
 
+CWD_API void realpath_cache_clean(void) /* {{{ */
+{
+	realpath_cache_clean_local();
+#ifdef ZEND_REALPATH_SHARED_CACHE
+	if (realpath_shared_cache) {
+		/* clearstatcache(true) must not be answered by another worker */
+		realpath_shared_cache_reset();
+	}
+#endif
+}
+/* }}} */
+
 CWD_API void realpath_cache_del(const char *path, size_t path_len) /* {{{ */
 {
 	zend_ulong key = realpath_cache_key(path, path_len);
@@ -620,11 +916,16 @@ CWD_API void realpath_cache_del(const char *path, size_t path_len) /* {{{ */
 			}
 
 			free(r);
-			return;
+			break;
 		} else {
 			bucket = &(*bucket)->next;
 		}
 	}
+#ifdef ZEND_REALPATH_SHARED_CACHE
+	if (realpath_shared_cache) {
+		realpath_shared_cache_del(path, path_len);
+	}
+#endif
 }
 /* }}} */
 
@@ -674,6 +975,23 @@ static inline void realpath_cache_add(const char *path, size_t path_len, const c
 }
 /* }}} */
 
+#ifdef ZEND_REALPATH_SHARED_CACHE
+static zend_never_inline size_t realpath_shared_cache_lookup(char *path, size_t path_len, time_t t, int *is_dir) /* {{{ */
+{
+	char resolved[MAXPATHLEN];
+	size_t resolved_len;
+
+	if (!realpath_shared_cache_find(path, path_len, t, resolved, &resolved_len, is_dir)) {
+		return (size_t)-1;
+	}
+	/* another worker paid for the lstat walk, keep the result locally too */
+	realpath_cache_add(path, path_len, resolved, resolved_len, *is_dir, t);
+	memcpy(path, resolved, resolved_len + 1);
+	return resolved_len;
+}
+/* }}} */
+#endif
+
 static inline realpath_cache_bucket* realpath_cache_find(const char *path, size_t path_len, time_t t) /* {{{ */
 {
 	zend_ulong key = realpath_cache_key(path, path_len);
@@ -832,6 +1150,23 @@ static size_t tsrm_realpath_r(char *path, size_t start, size_t len, int *ll, tim
 					return bucket->realpath_len;
 				}
 			}
+#ifdef ZEND_REALPATH_SHARED_CACHE
+			if (realpath_shared_cache) {
+				int shared_is_dir;
+				size_t shared_len = realpath_shared_cache_lookup(path, len, *t, &shared_is_dir);
+
+				if (shared_len != (size_t)-1) {
+					if (is_dir && !shared_is_dir) {
+						/* not a directory */
+						return (size_t)-1;
+					}
+					if (link_is_dir) {
+						*link_is_dir = shared_is_dir;
+					}
+					return shared_len;
+				}
+			}
+#endif
 		}
 
 #ifdef ZEND_WIN32
@@ -1195,6 +1530,11 @@ static size_t tsrm_realpath_r(char *path, size_t start, size_t len, int *ll, tim
 		if (save && start && CWDG(realpath_cache_size_limit)) {
 			/* save absolute path in the cache */
 			realpath_cache_add(tmp, len, path, j, directory, *t);
+#ifdef ZEND_REALPATH_SHARED_CACHE
+			if (realpath_shared_cache) {
+				realpath_shared_cache_add(tmp, len, path, j, directory, *t);
+			}
+#endif
 		}
 
 		free_alloca(tmp, use_heap);
@@ -221,6 +221,12 @@ CWD_API zend_long realpath_cache_size(void);
 CWD_API zend_long realpath_cache_max_buckets(void);
 CWD_API realpath_cache_bucket** realpath_cache_get_buckets(void);
 
+/* Shared second level of the realpath cache, size is in bytes. The table
+ * must be created before the worker processes are forked. */
+CWD_API int realpath_cache_shared_startup(zend_long size);
+CWD_API void realpath_cache_shared_shutdown(void);
+CWD_API zend_long realpath_cache_shared_slots(void);
+
 #ifdef CWD_EXPORTS
 extern void virtual_cwd_main_cwd_init(uint8_t);
 #endif
@@ -1805,10 +1805,13 @@ ZEND_VM_HOT_OBJ_HANDLER(82, ZEND_FETCH_OBJ_R, CONST|TMPVAR|UNUSED|THIS|CV, CONST
 		zval *retval;
 
 		if (OP2_TYPE == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -1832,12 +1835,12 @@ ZEND_VM_HOT_OBJ_HANDLER(82, ZEND_FETCH_OBJ_R, CONST|TMPVAR|UNUSED|THIS|CV, CONST
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -1949,10 +1952,13 @@ ZEND_VM_COLD_CONST_HANDLER(91, ZEND_FETCH_OBJ_IS, CONST|TMPVAR|UNUSED|THIS|CV, C
 		zval *retval;
 
 		if (OP2_TYPE == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -1976,12 +1982,12 @@ ZEND_VM_COLD_CONST_HANDLER(91, ZEND_FETCH_OBJ_IS, CONST|TMPVAR|UNUSED|THIS|CV, C
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -2086,6 +2092,7 @@ ZEND_VM_HANDLER(136, ZEND_ASSIGN_OBJ, VAR|UNUSED|THIS|CV, CONST|TMPVAR|CV, CACHE
 	USE_OPLINE
 	zend_free_op free_op1, free_op2, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = GET_OP1_OBJ_ZVAL_PTR_PTR_UNDEF(BP_VAR_W);
@@ -2112,8 +2119,8 @@ ZEND_VM_HANDLER(136, ZEND_ASSIGN_OBJ, VAR|UNUSED|THIS|CV, CONST|TMPVAR|CV, CACHE
 
 ZEND_VM_C_LABEL(assign_object):
 	if (OP2_TYPE == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -2999,6 +3006,7 @@ ZEND_VM_HOT_OBJ_HANDLER(112, ZEND_INIT_METHOD_CALL, CONST|TMPVAR|UNUSED|THIS|CV,
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -3067,8 +3075,8 @@ ZEND_VM_HOT_OBJ_HANDLER(112, ZEND_INIT_METHOD_CALL, CONST|TMPVAR|UNUSED|THIS|CV,
 	called_scope = obj->ce;
 
 	if (OP2_TYPE == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -3097,7 +3105,7 @@ ZEND_VM_HOT_OBJ_HANDLER(112, ZEND_INIT_METHOD_CALL, CONST|TMPVAR|UNUSED|THIS|CV,
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -3285,7 +3293,7 @@ ZEND_VM_HOT_HANDLER(59, ZEND_INIT_FCALL_BY_NAME, ANY, CONST, NUM|CACHE_SLOT)
 	if (UNEXPECTED(fbc == NULL)) {
 		function_name = (zval*)RT_CONSTANT(opline, opline->op2);
 		func = zend_hash_find_ex(EG(function_table), Z_STR_P(function_name+1), 1);
-		if (UNEXPECTED(func == NULL)) {
+		if (UNEXPECTED(func == NULL) && (func = zend_lazy_function_find(Z_STR_P(function_name+1))) == NULL) {
 			ZEND_VM_DISPATCH_TO_HELPER(zend_undefined_function_helper, function_name, function_name);
 		}
 		fbc = Z_FUNC_P(func);
@@ -3445,10 +3453,10 @@ ZEND_VM_HOT_HANDLER(69, ZEND_INIT_NS_FCALL_BY_NAME, ANY, CONST, NUM|CACHE_SLOT)
 	if (UNEXPECTED(fbc == NULL)) {
 		func_name = RT_CONSTANT(opline, opline->op2) + 1;
 		func = zend_hash_find_ex(EG(function_table), Z_STR_P(func_name), 1);
-		if (func == NULL) {
+		if (func == NULL && (func = zend_lazy_function_find(Z_STR_P(func_name))) == NULL) {
 			func_name++;
 			func = zend_hash_find_ex(EG(function_table), Z_STR_P(func_name), 1);
-			if (UNEXPECTED(func == NULL)) {
+			if (UNEXPECTED(func == NULL) && (func = zend_lazy_function_find(Z_STR_P(func_name))) == NULL) {
 				ZEND_VM_DISPATCH_TO_HELPER(zend_undefined_function_helper, function_name, func_name);
 			}
 		}
@@ -2070,7 +2070,7 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_FCALL_BY_NAME
 	if (UNEXPECTED(fbc == NULL)) {
 		function_name = (zval*)RT_CONSTANT(opline, opline->op2);
 		func = zend_hash_find_ex(EG(function_table), Z_STR_P(function_name+1), 1);
-		if (UNEXPECTED(func == NULL)) {
+		if (UNEXPECTED(func == NULL) && (func = zend_lazy_function_find(Z_STR_P(function_name+1))) == NULL) {
 			ZEND_VM_TAIL_CALL(zend_undefined_function_helper_SPEC(function_name ZEND_OPCODE_HANDLER_ARGS_PASSTHRU_CC));
 		}
 		fbc = Z_FUNC_P(func);
@@ -2155,10 +2155,10 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_NS_FCALL_BY_N
 	if (UNEXPECTED(fbc == NULL)) {
 		func_name = RT_CONSTANT(opline, opline->op2) + 1;
 		func = zend_hash_find_ex(EG(function_table), Z_STR_P(func_name), 1);
-		if (func == NULL) {
+		if (func == NULL && (func = zend_lazy_function_find(Z_STR_P(func_name))) == NULL) {
 			func_name++;
 			func = zend_hash_find_ex(EG(function_table), Z_STR_P(func_name), 1);
-			if (UNEXPECTED(func == NULL)) {
+			if (UNEXPECTED(func == NULL) && (func = zend_lazy_function_find(Z_STR_P(func_name))) == NULL) {
 				ZEND_VM_TAIL_CALL(zend_undefined_function_helper_SPEC(func_name ZEND_OPCODE_HANDLER_ARGS_PASSTHRU_CC));
 			}
 		}
@@ -4745,10 +4745,13 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_
 		zval *retval;
 
 		if (IS_CONST == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -4772,12 +4775,12 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -4843,10 +4846,13 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC
 		zval *retval;
 
 		if (IS_CONST == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -4870,12 +4876,12 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -5049,6 +5055,7 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -5117,8 +5124,8 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_
 	called_scope = obj->ce;
 
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -5147,7 +5154,7 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -6920,10 +6927,13 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_
 		zval *retval;
 
 		if ((IS_TMP_VAR|IS_VAR) == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -6947,12 +6957,12 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -7019,10 +7029,13 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC
 		zval *retval;
 
 		if ((IS_TMP_VAR|IS_VAR) == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -7046,12 +7059,12 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -7226,6 +7239,7 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -7294,8 +7308,8 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_
 	called_scope = obj->ce;
 
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -7324,7 +7338,7 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -10018,10 +10032,13 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_
 		zval *retval;
 
 		if (IS_CV == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -10045,12 +10062,12 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -10116,10 +10133,13 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC
 		zval *retval;
 
 		if (IS_CV == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -10143,12 +10163,12 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -10322,6 +10342,7 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -10390,8 +10411,8 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_
 	called_scope = obj->ce;
 
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -10420,7 +10441,7 @@ static ZEND_VM_COLD ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -13773,10 +13794,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_TMPVAR_CONST_
 		zval *retval;
 
 		if (IS_CONST == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -13800,12 +13824,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_TMPVAR_CONST_
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -13871,10 +13895,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_TMPVAR_CONST
 		zval *retval;
 
 		if (IS_CONST == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -13898,12 +13925,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_TMPVAR_CONST
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -14050,6 +14077,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_TMPVAR_C
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -14118,8 +14146,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_TMPVAR_C
 	called_scope = obj->ce;
 
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -14148,7 +14176,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_TMPVAR_C
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -15381,10 +15409,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_TMPVAR_TMPVAR
 		zval *retval;
 
 		if ((IS_TMP_VAR|IS_VAR) == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -15408,12 +15439,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_TMPVAR_TMPVAR
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -15480,10 +15511,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_TMPVAR_TMPVA
 		zval *retval;
 
 		if ((IS_TMP_VAR|IS_VAR) == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -15507,12 +15541,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_TMPVAR_TMPVA
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -15660,6 +15694,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_TMPVAR_T
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -15728,8 +15763,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_TMPVAR_T
 	called_scope = obj->ce;
 
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -15758,7 +15793,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_TMPVAR_T
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -17260,10 +17295,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_TMPVAR_CV_HAN
 		zval *retval;
 
 		if (IS_CV == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -17287,12 +17325,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_TMPVAR_CV_HAN
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -17358,10 +17396,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_TMPVAR_CV_HA
 		zval *retval;
 
 		if (IS_CV == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -17385,12 +17426,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_TMPVAR_CV_HA
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -17537,6 +17578,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_TMPVAR_C
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -17605,8 +17647,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_TMPVAR_C
 	called_scope = obj->ce;
 
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -17635,7 +17677,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_TMPVAR_C
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -22731,6 +22773,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CONST_OP_D
 	USE_OPLINE
 	zend_free_op free_op1;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -22757,8 +22800,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CONST_OP_D
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -22852,6 +22895,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CONST_OP_D
 	USE_OPLINE
 	zend_free_op free_op1, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -22878,8 +22922,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CONST_OP_D
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -22973,6 +23017,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CONST_OP_D
 	USE_OPLINE
 	zend_free_op free_op1, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -22999,8 +23044,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CONST_OP_D
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -23094,6 +23139,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CONST_OP_D
 	USE_OPLINE
 	zend_free_op free_op1;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -23120,8 +23166,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CONST_OP_D
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -25101,6 +25147,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_TMPVAR_OP_
 	USE_OPLINE
 	zend_free_op free_op1, free_op2;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -25127,8 +25174,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_TMPVAR_OP_
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -25222,6 +25269,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_TMPVAR_OP_
 	USE_OPLINE
 	zend_free_op free_op1, free_op2, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -25248,8 +25296,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_TMPVAR_OP_
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -25343,6 +25391,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_TMPVAR_OP_
 	USE_OPLINE
 	zend_free_op free_op1, free_op2, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -25369,8 +25418,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_TMPVAR_OP_
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -25464,6 +25513,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_TMPVAR_OP_
 	USE_OPLINE
 	zend_free_op free_op1, free_op2;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -25490,8 +25540,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_TMPVAR_OP_
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -28994,6 +29044,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CV_OP_DATA
 	USE_OPLINE
 	zend_free_op free_op1;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -29020,8 +29071,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CV_OP_DATA
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -29115,6 +29166,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CV_OP_DATA
 	USE_OPLINE
 	zend_free_op free_op1, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -29141,8 +29193,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CV_OP_DATA
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -29236,6 +29288,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CV_OP_DATA
 	USE_OPLINE
 	zend_free_op free_op1, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -29262,8 +29315,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CV_OP_DATA
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -29357,6 +29410,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CV_OP_DATA
 	USE_OPLINE
 	zend_free_op free_op1;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = _get_zval_ptr_ptr_var(opline->op1.var, &free_op1 EXECUTE_DATA_CC);
@@ -29383,8 +29437,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_VAR_CV_OP_DATA
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -31171,10 +31225,13 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_U
 		zval *retval;
 
 		if (IS_CONST == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -31198,12 +31255,12 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_U
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -31314,10 +31371,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_UNUSED_CONST
 		zval *retval;
 
 		if (IS_CONST == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -31341,12 +31401,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_UNUSED_CONST
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -31413,6 +31473,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CONST_O
 	USE_OPLINE
 
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -31439,8 +31500,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CONST_O
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -31534,6 +31595,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CONST_O
 	USE_OPLINE
 	zend_free_op free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -31560,8 +31622,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CONST_O
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -31655,6 +31717,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CONST_O
 	USE_OPLINE
 	zend_free_op free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -31681,8 +31744,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CONST_O
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -31776,6 +31839,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CONST_O
 	USE_OPLINE
 
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -31802,8 +31866,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CONST_O
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -31982,6 +32046,7 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_S
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -32050,8 +32115,8 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_S
 	called_scope = obj->ce;
 
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -32080,7 +32145,7 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_S
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -32899,10 +32964,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_UNUSED_TMPVAR
 		zval *retval;
 
 		if ((IS_TMP_VAR|IS_VAR) == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -32926,12 +32994,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_UNUSED_TMPVAR
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -33043,10 +33111,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_UNUSED_TMPVA
 		zval *retval;
 
 		if ((IS_TMP_VAR|IS_VAR) == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -33070,12 +33141,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_UNUSED_TMPVA
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -33143,6 +33214,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_TMPVAR_
 	USE_OPLINE
 	zend_free_op free_op2;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -33169,8 +33241,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_TMPVAR_
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -33264,6 +33336,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_TMPVAR_
 	USE_OPLINE
 	zend_free_op free_op2, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -33290,8 +33363,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_TMPVAR_
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -33385,6 +33458,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_TMPVAR_
 	USE_OPLINE
 	zend_free_op free_op2, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -33411,8 +33485,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_TMPVAR_
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -33506,6 +33580,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_TMPVAR_
 	USE_OPLINE
 	zend_free_op free_op2;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -33532,8 +33607,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_TMPVAR_
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -33713,6 +33788,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_UNUSED_T
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -33781,8 +33857,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_UNUSED_T
 	called_scope = obj->ce;
 
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -33811,7 +33887,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_UNUSED_T
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -35277,10 +35353,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_UNUSED_CV_HAN
 		zval *retval;
 
 		if (IS_CV == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -35304,12 +35383,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_UNUSED_CV_HAN
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -35420,10 +35499,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_UNUSED_CV_HA
 		zval *retval;
 
 		if (IS_CV == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -35447,12 +35529,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_UNUSED_CV_HA
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -35519,6 +35601,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CV_OP_D
 	USE_OPLINE
 
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -35545,8 +35628,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CV_OP_D
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -35640,6 +35723,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CV_OP_D
 	USE_OPLINE
 	zend_free_op free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -35666,8 +35750,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CV_OP_D
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -35761,6 +35845,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CV_OP_D
 	USE_OPLINE
 	zend_free_op free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -35787,8 +35872,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CV_OP_D
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -35882,6 +35967,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CV_OP_D
 	USE_OPLINE
 
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = &EX(This);
@@ -35908,8 +35994,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_UNUSED_CV_OP_D
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -36088,6 +36174,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_UNUSED_C
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -36156,8 +36243,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_UNUSED_C
 	called_scope = obj->ce;
 
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -36186,7 +36273,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_UNUSED_C
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -39768,10 +39855,13 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_C
 		zval *retval;
 
 		if (IS_CONST == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -39795,12 +39885,12 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_C
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -39911,10 +40001,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_CV_CONST_HAN
 		zval *retval;
 
 		if (IS_CONST == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -39938,12 +40031,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_CV_CONST_HAN
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -40010,6 +40103,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CONST_OP_DA
 	USE_OPLINE
 
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -40036,8 +40130,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CONST_OP_DA
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -40131,6 +40225,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CONST_OP_DA
 	USE_OPLINE
 	zend_free_op free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -40157,8 +40252,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CONST_OP_DA
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -40252,6 +40347,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CONST_OP_DA
 	USE_OPLINE
 	zend_free_op free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -40278,8 +40374,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CONST_OP_DA
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -40373,6 +40469,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CONST_OP_DA
 	USE_OPLINE
 
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -40399,8 +40496,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CONST_OP_DA
 
 assign_object:
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -41109,6 +41206,7 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_S
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -41177,8 +41275,8 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_S
 	called_scope = obj->ce;
 
 	if (IS_CONST == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -41207,7 +41305,7 @@ static ZEND_VM_HOT ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_S
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -43585,10 +43683,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_CV_TMPVAR_HAN
 		zval *retval;
 
 		if ((IS_TMP_VAR|IS_VAR) == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -43612,12 +43713,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_CV_TMPVAR_HAN
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -43729,10 +43830,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_CV_TMPVAR_HA
 		zval *retval;
 
 		if ((IS_TMP_VAR|IS_VAR) == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -43756,12 +43860,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_CV_TMPVAR_HA
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -43829,6 +43933,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_TMPVAR_OP_D
 	USE_OPLINE
 	zend_free_op free_op2;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -43855,8 +43960,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_TMPVAR_OP_D
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -43950,6 +44055,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_TMPVAR_OP_D
 	USE_OPLINE
 	zend_free_op free_op2, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -43976,8 +44082,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_TMPVAR_OP_D
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -44071,6 +44177,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_TMPVAR_OP_D
 	USE_OPLINE
 	zend_free_op free_op2, free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -44097,8 +44204,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_TMPVAR_OP_D
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -44192,6 +44299,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_TMPVAR_OP_D
 	USE_OPLINE
 	zend_free_op free_op2;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -44218,8 +44326,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_TMPVAR_OP_D
 
 assign_object:
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -44872,6 +44980,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_CV_TMPVA
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -44940,8 +45049,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_CV_TMPVA
 	called_scope = obj->ce;
 
 	if ((IS_TMP_VAR|IS_VAR) == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -44970,7 +45079,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_CV_TMPVA
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -49281,10 +49390,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_CV_CV_HANDLER
 		zval *retval;
 
 		if (IS_CV == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -49308,12 +49420,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_R_SPEC_CV_CV_HANDLER
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY_DEREF(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -49424,10 +49536,13 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_CV_CV_HANDLE
 		zval *retval;
 
 		if (IS_CV == IS_CONST) {
+			void **cache_entry;
+
 			cache_slot = CACHE_ADDR(opline->extended_value);
+			cache_entry = zend_inline_cache_find_hit(cache_slot, zobj->ce);
 
-			if (EXPECTED(zobj->ce == CACHED_PTR_EX(cache_slot))) {
-				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_slot + 1);
+			if (EXPECTED(cache_entry != NULL)) {
+				uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 
 				if (EXPECTED(IS_VALID_PROPERTY_OFFSET(prop_offset))) {
 					retval = OBJ_PROP(zobj, prop_offset);
@@ -49451,12 +49566,12 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_FETCH_OBJ_IS_SPEC_CV_CV_HANDLE
 								break;
 							}
 						}
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_DYNAMIC_PROPERTY_OFFSET);
 					}
 					retval = zend_hash_find_ex(zobj->properties, Z_STR_P(offset), 1);
 					if (EXPECTED(retval)) {
 						uintptr_t idx = (char*)retval - (char*)zobj->properties->arData;
-						CACHE_PTR_EX(cache_slot + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
+						CACHE_PTR_EX(cache_entry + 1, (void*)ZEND_ENCODE_DYN_PROP_OFFSET(idx));
 						ZVAL_COPY(EX_VAR(opline->result.var), retval);
 						break;
 					}
@@ -49523,6 +49638,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CV_OP_DATA_
 	USE_OPLINE
 
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -49549,8 +49665,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CV_OP_DATA_
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -49644,6 +49760,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CV_OP_DATA_
 	USE_OPLINE
 	zend_free_op free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -49670,8 +49787,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CV_OP_DATA_
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -49765,6 +49882,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CV_OP_DATA_
 	USE_OPLINE
 	zend_free_op free_op_data;
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -49791,8 +49909,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CV_OP_DATA_
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -49886,6 +50004,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CV_OP_DATA_
 	USE_OPLINE
 
 	zval *object, *property, *value, tmp;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 	object = EX_VAR(opline->op1.var);
@@ -49912,8 +50031,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_ASSIGN_OBJ_SPEC_CV_CV_OP_DATA_
 
 assign_object:
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(Z_OBJCE_P(object) == CACHED_PTR(opline->extended_value))) {
-		uintptr_t prop_offset = (uintptr_t)CACHED_PTR(opline->extended_value + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find_hit(CACHE_ADDR(opline->extended_value), Z_OBJCE_P(object))) != NULL)) {
+		uintptr_t prop_offset = (uintptr_t)CACHED_PTR_EX(cache_entry + 1);
 		zend_object *zobj = Z_OBJ_P(object);
 		zval *property_val;
 
@@ -50670,6 +50789,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_CV_CV_HA
 	zend_object *obj;
 	zend_execute_data *call;
 	uint32_t call_info;
+	void **cache_entry;
 
 	SAVE_OPLINE();
 
@@ -50738,8 +50858,8 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_CV_CV_HA
 	called_scope = obj->ce;
 
 	if (IS_CV == IS_CONST &&
-	    EXPECTED(CACHED_PTR(opline->result.num) == called_scope)) {
-	    fbc = CACHED_PTR(opline->result.num + sizeof(void*));
+	    EXPECTED((cache_entry = zend_inline_cache_find(CACHE_ADDR(opline->result.num), called_scope)) != NULL)) {
+	    fbc = CACHED_PTR_EX(cache_entry + 1);
 	} else {
 	    zend_object *orig_obj = obj;
 
@@ -50768,7 +50888,7 @@ static ZEND_OPCODE_HANDLER_RET ZEND_FASTCALL ZEND_INIT_METHOD_CALL_SPEC_CV_CV_HA
 		    EXPECTED(fbc->type <= ZEND_USER_FUNCTION) &&
 		    EXPECTED(!(fbc->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE|ZEND_ACC_NEVER_CACHE))) &&
 		    EXPECTED(obj == orig_obj)) {
-			CACHE_POLYMORPHIC_PTR(opline->result.num, called_scope, fbc);
+			zend_inline_cache_insert(CACHE_ADDR(opline->result.num), called_scope, fbc);
 		}
 		if (EXPECTED(fbc->type == ZEND_USER_FUNCTION) && UNEXPECTED(!fbc->op_array.run_time_cache)) {
 			init_func_run_time_cache(&fbc->op_array);
@@ -732,6 +732,11 @@ uint32_t ArrayVariant::findArrayIdx(const std::string &key) const noexcept
       }
       idx = Z_NEXT(p->val);
    }
+   if (HT_IS_SMALL(ht)) {
+      // the slots of a small table stay empty, its Buckets are scanned
+      zval *val = zend_hash_str_find(ht, keyStr, length);
+      return val ? calculateIdxFromZval(val) : HT_INVALID_IDX;
+   }
    return HT_INVALID_IDX;
 }
 
@@ -752,6 +757,11 @@ uint32_t ArrayVariant::findArrayIdx(vmapi_ulong index) const noexcept
       }
       idx = Z_NEXT(p->val);
    }
+   if (HT_IS_SMALL(ht)) {
+      // the slots of a small table stay empty, its Buckets are scanned
+      zval *val = zend_hash_index_find(ht, index);
+      return val ? calculateIdxFromZval(val) : HT_INVALID_IDX;
+   }
    return HT_INVALID_IDX;
 }
 
@@ -21,9 +21,13 @@
 #include "polarphp/vm/lang/Namespace.h"
 #include "polarphp/vm/Closure.h"
 #include "polarphp/runtime/RtDefs.h"
+#include "polarphp/basic/adt/StringMap.h"
 
+#include <cstring>
 #include <ostream>
 #include <map>
+#include <mutex>
+#include <vector>
 
 /**
  * We're almost there, we now need to declare an instance of the
@@ -39,6 +43,7 @@ namespace vmapi {
 using internal::ModulePrivate;
 using internal::AbstractClassPrivate;
 using internal::NamespacePrivate;
+using polar::basic::StringMap;
 
 namespace
 {
@@ -46,6 +51,28 @@ namespace
 std::map<std::string, Module *> name2extension;
 std::map<int, Module *> mid2extension;
 
+/// functions and classes of the lazy modules, keyed by their lower case
+/// qualified name, filled at module startup and only read afterwards
+struct LazyFunction
+{
+   ModulePrivate *module;
+   const zend_function_entry *entry;
+};
+
+struct LazyClass
+{
+   ModulePrivate *module;
+   std::string ns;
+   AbstractClass *cls;
+};
+
+StringMap<LazyFunction> lazyFunctions;
+StringMap<LazyClass> lazyClasses;
+std::map<const AbstractClassPrivate *, LazyClass *> lazyClassRecords;
+/// the class entries are shared by the threads, every class is
+/// registered once under this lock
+std::mutex lazyClassMutex;
+
 int match_module(zval *value)
 {
    zend_module_entry *entry = static_cast<zend_module_entry *>(Z_PTR_P(value));
@@ -117,6 +144,16 @@ Module &Module::setInfoHandler(const Callback &callback)
    return *this;
 }
 
+Module &Module::setLazyRegistration(bool lazy)
+{
+   VMAPI_D(Module);
+   if (implPtr->m_locked) {
+      return *this;
+   }
+   implPtr->m_lazy = lazy;
+   return *this;
+}
+
 void *Module::getModule()
 {
    return getImplPtr()->getModule();
@@ -399,7 +436,7 @@ size_t ModulePrivate::getIniCount() const
 
 zend_module_entry *ModulePrivate::getModule()
 {
-   if (m_entry.functions) {
+   if (m_entry.functions || m_lazyFunctionEntries) {
       return &m_entry;
    }
    if (m_entry.module_startup_func == &ModulePrivate::processMismatch) {
@@ -423,6 +460,12 @@ zend_module_entry *ModulePrivate::getModule()
    }
    zend_function_entry *last = &entries[count];
    memset(last, 0, sizeof(zend_function_entry));
+   if (m_lazy) {
+      // the engine must not register them at module startup, processLazyFunction()
+      // registers them one by one
+      m_lazyFunctionEntries.reset(entries);
+      return &m_entry;
+   }
    m_entry.functions = entries;
    return &m_entry;
 }
@@ -530,14 +573,26 @@ bool ModulePrivate::initialize(int moduleNumber)
    iterateConstants([moduleNumber](Constant &constant) {
       constant.initialize(moduleNumber);
    });
-   // here we register all global classes and interfaces
-   iterateClasses([moduleNumber](AbstractClass &cls) {
-      cls.initialize(moduleNumber);
-   });
-   // work with register namespaces
-
-   for (std::shared_ptr<Namespace> &ns : m_namespaces) {
-      ns->initialize(moduleNumber);
+   if (m_lazy) {
+      // only remember the names, the engine asks for the entries on first use
+      for (const zend_function_entry *entry = m_lazyFunctionEntries.get(); entry && entry->fname; ++entry) {
+         lazyFunctions[StringRef(entry->fname).toLower()] = LazyFunction{this, entry};
+      }
+      registerLazyClasses("", m_classes);
+      for (std::shared_ptr<Namespace> &ns : m_namespaces) {
+         registerLazyNamespace(ns->m_implPtr->m_name, *ns, moduleNumber);
+      }
+      zend_lazy_function_handler = &ModulePrivate::processLazyFunction;
+      zend_lazy_class_handler = &ModulePrivate::processLazyClass;
+   } else {
+      // here we register all global classes and interfaces
+      iterateClasses([moduleNumber](AbstractClass &cls) {
+         cls.initialize(moduleNumber);
+      });
+      // work with register namespaces
+      for (std::shared_ptr<Namespace> &ns : m_namespaces) {
+         ns->initialize(moduleNumber);
+      }
    }
    // initialize closure class
    Closure::registerToZendNg(moduleNumber);
@@ -553,6 +608,9 @@ bool ModulePrivate::initialize(int moduleNumber)
 
 bool ModulePrivate::shutdown(int moduleNumber)
 {
+   if (m_lazy) {
+      unregisterLazyEntries();
+   }
    zend_unregister_ini_entries(moduleNumber);
    m_zendIniDefs.reset();
    if (m_shutdownHandler) {
@@ -562,6 +620,117 @@ bool ModulePrivate::shutdown(int moduleNumber)
    m_locked = false;
    return true;
 }
+
+void ModulePrivate::registerLazyClasses(const std::string &ns,
+                                        const std::list<std::shared_ptr<AbstractClass>> &classes)
+{
+   for (const std::shared_ptr<AbstractClass> &cls : classes) {
+      std::string name = cls->getClassName();
+      if (!ns.empty() && ns != "\\") {
+         name = ns + "\\" + name;
+      }
+      LazyClass &record = lazyClasses[StringRef(name).toLower()];
+      record = LazyClass{this, ns, cls.get()};
+      lazyClassRecords[cls->m_implPtr.get()] = &record;
+   }
+}
+
+void ModulePrivate::registerLazyNamespace(const std::string &ns, Namespace &target, int moduleNumber)
+{
+   NamespacePrivate *implPtr = target.m_implPtr.get();
+   implPtr->initializeConstants(ns, moduleNumber);
+   registerLazyClasses(ns, implPtr->m_classes);
+   for (std::shared_ptr<Namespace> &subns : implPtr->m_namespaces) {
+      registerLazyNamespace(ns + "\\" + subns->m_implPtr->m_name, *subns, moduleNumber);
+   }
+}
+
+void ModulePrivate::unregisterLazyEntries()
+{
+   std::vector<std::string> names;
+   for (auto &entry : lazyFunctions) {
+      if (entry.getValue().module == this) {
+         names.push_back(entry.getKey().getStr());
+      }
+   }
+   for (const std::string &name : names) {
+      lazyFunctions.erase(name);
+   }
+   names.clear();
+   for (auto &entry : lazyClasses) {
+      if (entry.getValue().module == this) {
+         lazyClassRecords.erase(entry.getValue().cls->m_implPtr.get());
+         names.push_back(entry.getKey().getStr());
+      }
+   }
+   for (const std::string &name : names) {
+      lazyClasses.erase(name);
+   }
+   if (lazyFunctions.empty() && lazyClasses.empty()) {
+      zend_lazy_function_handler = nullptr;
+      zend_lazy_class_handler = nullptr;
+   }
+}
+
+int ModulePrivate::processLazyFunction(zend_string *lcname)
+{
+   auto iter = lazyFunctions.find(StringRef(ZSTR_VAL(lcname), ZSTR_LEN(lcname)));
+   if (iter == lazyFunctions.end()) {
+      return FAILURE;
+   }
+   const LazyFunction &record = iter->getValue();
+   zend_function_entry entries[2];
+   entries[0] = *record.entry;
+   std::memset(&entries[1], 0, sizeof(zend_function_entry));
+   // every thread has its own function table, no lock is needed
+   zend_module_entry *currentModule = zend_lazy_registration_begin(&record.module->m_entry);
+   int result = zend_register_functions(nullptr, entries, nullptr, MODULE_PERSISTENT);
+   zend_lazy_registration_end(currentModule);
+   return result;
+}
+
+int ModulePrivate::processLazyClass(zend_string *lcname)
+{
+   auto iter = lazyClasses.find(StringRef(ZSTR_VAL(lcname), ZSTR_LEN(lcname)));
+   if (iter == lazyClasses.end()) {
+      return FAILURE;
+   }
+   const LazyClass &record = iter->getValue();
+   std::lock_guard<std::mutex> lock(lazyClassMutex);
+   zend_class_entry *entry = record.cls->m_implPtr->m_classEntry;
+   if (entry) {
+      // registered by another thread or as the parent of another class
+      zend_lazy_class_add(entry);
+   } else {
+      materializeClass(record.module, record.ns, *record.cls);
+   }
+   return SUCCESS;
+}
+
+zend_class_entry *ModulePrivate::materializeClass(ModulePrivate *module, const std::string &ns, AbstractClass &cls)
+{
+   AbstractClassPrivate *implPtr = cls.m_implPtr.get();
+   // the parent and the interfaces must exist before the class inherits them
+   std::list<std::shared_ptr<AbstractClass>> bases(implPtr->m_interfaces);
+   if (implPtr->m_parent) {
+      bases.push_front(implPtr->m_parent);
+   }
+   for (std::shared_ptr<AbstractClass> &base : bases) {
+      if (base->m_implPtr->m_classEntry) {
+         continue;
+      }
+      auto iter = lazyClassRecords.find(base->m_implPtr.get());
+      if (iter != lazyClassRecords.end()) {
+         LazyClass *record = iter->second;
+         materializeClass(record->module, record->ns, *record->cls);
+      }
+   }
+   zend_module_entry *currentModule = zend_lazy_registration_begin(&module->m_entry);
+   zend_class_entry *entry = cls.initialize(ns, module->m_entry.module_number);
+   zend_lazy_registration_end(currentModule);
+   zend_lazy_class_registered(entry);
+   return entry;
+}
 } // internal
 
 } // vmapi
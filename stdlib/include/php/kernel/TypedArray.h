@@ -0,0 +1,104 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#ifndef POLARPHP_STDLIB_KERNEL_TYPED_ARRAY_H
+#define POLARPHP_STDLIB_KERNEL_TYPED_ARRAY_H
+
+#include "polarphp/vm/StdClass.h"
+#include "polarphp/vm/ds/Variant.h"
+#include "polarphp/vm/lang/Parameter.h"
+#include "polarphp/vm/protocol/AbstractIterator.h"
+#include "polarphp/vm/protocol/ArrayAccess.h"
+#include "polarphp/vm/protocol/Countable.h"
+#include "polarphp/vm/protocol/Traversable.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace php {
+namespace kernel {
+
+using polar::vmapi::AbstractIterator;
+using polar::vmapi::Parameters;
+using polar::vmapi::StdClass;
+using polar::vmapi::Variant;
+
+template <typename T>
+class TypedArrayIterator;
+
+///
+/// Fixed element type array of numbers kept in one contiguous buffer, an
+/// element takes the size of \p T instead of a 32 bytes Bucket.
+///
+/// The values written through the array access are converted to \p T, the
+/// offsets are integers in [0, count), writing with an empty offset appends.
+/// The bulk operations run over the raw buffer. The NaN elements of a float
+/// array sort after every number.
+///
+template <typename T>
+class TypedArray :
+      public StdClass,
+      public polar::vmapi::Traversable,
+      public polar::vmapi::Countable,
+      public polar::vmapi::ArrayAccess
+{
+public:
+   using ValueType = T;
+
+   TypedArray();
+   TypedArray(const TypedArray &other);
+
+   /// __construct(int|array $lengthOrValues = 0)
+   void __construct(Parameters &args);
+
+   virtual vmapi_long count() override;
+   virtual bool offsetExists(Variant offset) override;
+   virtual void offsetSet(Variant offset, Variant value) override;
+   virtual Variant offsetGet(Variant offset) override;
+   virtual void offsetUnset(Variant offset) override;
+
+   /// every foreach gets its own position, nested loops over the same
+   /// array do not disturb each other
+   virtual AbstractIterator *getIterator() override;
+   virtual bool createsIterator() const override;
+
+   Variant sum();
+   Variant min();
+   Variant max();
+   /// multiply every element by the argument, an integer array takes an
+   /// integral factor only and is left unchanged when a product overflows
+   void scale(Parameters &args);
+   /// the dot product with an array of the same class and length
+   Variant dot(Parameters &args);
+   void sort();
+   Variant toArray();
+
+private:
+   friend class TypedArrayIterator<T>;
+
+   static T convertValue(const Variant &value);
+   size_t checkOffset(const Variant &offset) const;
+
+   std::vector<T> m_data;
+};
+
+using Int32Array = TypedArray<std::int32_t>;
+using Int64Array = TypedArray<std::int64_t>;
+using Float64Array = TypedArray<double>;
+
+extern template class TypedArray<std::int32_t>;
+extern template class TypedArray<std::int64_t>;
+extern template class TypedArray<double>;
+
+} // kernel
+} // php
+
+#endif // POLARPHP_STDLIB_KERNEL_TYPED_ARRAY_H
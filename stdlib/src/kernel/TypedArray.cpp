@@ -0,0 +1,468 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "php/kernel/TypedArray.h"
+#include "polarphp/vm/ObjectBinder.h"
+#include "polarphp/vm/ds/ObjectVariant.h"
+#include "polarphp/vm/utils/Exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace php {
+namespace kernel {
+
+using polar::vmapi::Exception;
+using polar::vmapi::ObjectBinder;
+
+namespace {
+
+template <typename T>
+Variant make_variant(T value)
+{
+   if constexpr (std::is_floating_point<T>::value) {
+      return Variant(static_cast<double>(value));
+   } else {
+      return Variant(static_cast<vmapi_long>(value));
+   }
+}
+
+/// the int32 values can not overflow an int64 accumulator, the loop is
+/// left to the auto vectorizer
+Variant sum_values(const std::int32_t *data, size_t size)
+{
+   std::int64_t result = 0;
+   for (size_t i = 0; i < size; ++i) {
+      result += data[i];
+   }
+   return make_variant(result);
+}
+
+/// same as array_sum(), the sum continues as a float once it overflows
+Variant sum_values(const std::int64_t *data, size_t size)
+{
+   std::int64_t result = 0;
+   size_t i = 0;
+   for (; i < size; ++i) {
+      std::int64_t next;
+      if (__builtin_add_overflow(result, data[i], &next)) {
+         break;
+      }
+      result = next;
+   }
+   if (i == size) {
+      return make_variant(result);
+   }
+   double fresult = static_cast<double>(result) + static_cast<double>(data[i]);
+   for (++i; i < size; ++i) {
+      fresult += static_cast<double>(data[i]);
+   }
+   return make_variant(fresult);
+}
+
+/// four independent accumulators, the floating point additions can not
+/// be reordered by the compiler itself
+Variant sum_values(const double *data, size_t size)
+{
+   double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+   size_t i = 0;
+   for (; i + 4 <= size; i += 4) {
+      lanes[0] += data[i];
+      lanes[1] += data[i + 1];
+      lanes[2] += data[i + 2];
+      lanes[3] += data[i + 3];
+   }
+   double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+   for (; i < size; ++i) {
+      result += data[i];
+   }
+   return make_variant(result);
+}
+
+Variant dot_values(const std::int32_t *lhs, const std::int32_t *rhs, size_t size)
+{
+   /// a product of two int32 fits, their sum is checked like the int64 one
+   std::int64_t result = 0;
+   for (size_t i = 0; i < size; ++i) {
+      std::int64_t product = static_cast<std::int64_t>(lhs[i]) * rhs[i];
+      std::int64_t next;
+      if (__builtin_add_overflow(result, product, &next)) {
+         double fresult = static_cast<double>(result) + static_cast<double>(product);
+         for (++i; i < size; ++i) {
+            fresult += static_cast<double>(lhs[i]) * rhs[i];
+         }
+         return make_variant(fresult);
+      }
+      result = next;
+   }
+   return make_variant(result);
+}
+
+Variant dot_values(const std::int64_t *lhs, const std::int64_t *rhs, size_t size)
+{
+   std::int64_t result = 0;
+   for (size_t i = 0; i < size; ++i) {
+      std::int64_t product;
+      std::int64_t next;
+      if (__builtin_mul_overflow(lhs[i], rhs[i], &product) ||
+          __builtin_add_overflow(result, product, &next)) {
+         double fresult = static_cast<double>(result);
+         for (; i < size; ++i) {
+            fresult += static_cast<double>(lhs[i]) * static_cast<double>(rhs[i]);
+         }
+         return make_variant(fresult);
+      }
+      result = next;
+   }
+   return make_variant(result);
+}
+
+Variant dot_values(const double *lhs, const double *rhs, size_t size)
+{
+   double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+   size_t i = 0;
+   for (; i + 4 <= size; i += 4) {
+      lanes[0] += lhs[i] * rhs[i];
+      lanes[1] += lhs[i + 1] * rhs[i + 1];
+      lanes[2] += lhs[i + 2] * rhs[i + 2];
+      lanes[3] += lhs[i + 3] * rhs[i + 3];
+   }
+   double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+   for (; i < size; ++i) {
+      result += lhs[i] * rhs[i];
+   }
+   return make_variant(result);
+}
+
+/// a strict weak ordering for std::sort, NaN compares equal to NaN and
+/// greater than any number
+template <typename T>
+bool less_values(T lhs, T rhs)
+{
+   if constexpr (std::is_floating_point<T>::value) {
+      if (std::isnan(rhs)) {
+         return !std::isnan(lhs);
+      }
+   }
+   return lhs < rhs;
+}
+
+/// the integer a factor stands for, false when it has a fractional part or
+/// does not fit a zend_long
+bool integral_factor(zval *factor, zend_long &result)
+{
+   switch (Z_TYPE_P(factor)) {
+   case IS_LONG:
+      result = Z_LVAL_P(factor);
+      return true;
+   case IS_DOUBLE: {
+      double value = Z_DVAL_P(factor);
+      if (!zend_finite(value) || value != std::trunc(value) || !ZEND_DOUBLE_FITS_LONG(value)) {
+         return false;
+      }
+      result = zend_dval_to_lval(value);
+      return true;
+   }
+   case IS_STRING: {
+      double dval;
+      zend_uchar type = is_numeric_string(Z_STRVAL_P(factor), Z_STRLEN_P(factor), &result, &dval, 0);
+      if (type == IS_DOUBLE) {
+         zval converted;
+         ZVAL_DOUBLE(&converted, dval);
+         return integral_factor(&converted, result);
+      }
+      return type == IS_LONG;
+   }
+   case IS_NULL:
+   case IS_FALSE:
+   case IS_TRUE:
+      result = zval_get_long(factor);
+      return true;
+   default:
+      return false;
+   }
+}
+
+} // anonymous namespace
+
+///
+/// The position of one foreach over a typed array, the elements appended
+/// while it runs are visited too.
+///
+template <typename T>
+class TypedArrayIterator : public AbstractIterator
+{
+public:
+   TypedArrayIterator(TypedArray<T> *array)
+      : AbstractIterator(array),
+        m_array(array),
+        m_position(0)
+   {}
+
+   virtual bool valid() override
+   {
+      return m_position < m_array->m_data.size();
+   }
+
+   virtual Variant current() override
+   {
+      return make_variant(m_array->m_data[m_position]);
+   }
+
+   virtual Variant key() override
+   {
+      return Variant(static_cast<vmapi_long>(m_position));
+   }
+
+   virtual void next() override
+   {
+      ++m_position;
+   }
+
+   virtual void rewind() override
+   {
+      m_position = 0;
+   }
+
+private:
+   TypedArray<T> *m_array;
+   size_t m_position;
+};
+
+template <typename T>
+TypedArray<T>::TypedArray()
+{}
+
+template <typename T>
+TypedArray<T>::TypedArray(const TypedArray &other)
+   : StdClass(other),
+     m_data(other.m_data)
+{}
+
+template <typename T>
+void TypedArray<T>::__construct(Parameters &args)
+{
+   if (args.empty()) {
+      return;
+   }
+   Variant source = args.retrieveAsVariant(0);
+   zval *value = source.getZvalPtr();
+   if (Z_TYPE_P(value) == IS_ARRAY) {
+      zval *entry;
+      m_data.reserve(zend_hash_num_elements(Z_ARRVAL_P(value)));
+      ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(value), entry) {
+         m_data.push_back(convertValue(Variant(entry)));
+      } ZEND_HASH_FOREACH_END();
+   } else if (Z_TYPE_P(value) == IS_LONG) {
+      if (Z_LVAL_P(value) < 0) {
+         throw Exception("Length must not be negative");
+      }
+      m_data.resize(static_cast<size_t>(Z_LVAL_P(value)));
+   } else {
+      throw Exception("Expected an array or a length");
+   }
+}
+
+template <typename T>
+T TypedArray<T>::convertValue(const Variant &value)
+{
+   zval *zv = const_cast<zval *>(value.getZvalPtr());
+   if constexpr (std::is_floating_point<T>::value) {
+      return static_cast<T>(zval_get_double(zv));
+   } else {
+      /// a value the element type cannot hold is refused instead of truncated
+      if (Z_TYPE_P(zv) == IS_DOUBLE && !ZEND_DOUBLE_FITS_LONG(Z_DVAL_P(zv))) {
+         throw Exception("Value overflows the element type");
+      }
+      zend_long result = zval_get_long(zv);
+      if constexpr (sizeof(T) < sizeof(zend_long)) {
+         if (result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max()) {
+            throw Exception("Value overflows the element type");
+         }
+      }
+      return static_cast<T>(result);
+   }
+}
+
+template <typename T>
+size_t TypedArray<T>::checkOffset(const Variant &offset) const
+{
+   if (!offset.isLong()) {
+      throw Exception("Offset must be an integer");
+   }
+   zend_long index = Z_LVAL_P(offset.getZvalPtr());
+   if (index < 0 || static_cast<size_t>(index) >= m_data.size()) {
+      throw Exception("Offset out of range");
+   }
+   return static_cast<size_t>(index);
+}
+
+template <typename T>
+vmapi_long TypedArray<T>::count()
+{
+   return static_cast<vmapi_long>(m_data.size());
+}
+
+template <typename T>
+bool TypedArray<T>::offsetExists(Variant offset)
+{
+   if (!offset.isLong()) {
+      return false;
+   }
+   zend_long index = Z_LVAL_P(offset.getZvalPtr());
+   return index >= 0 && static_cast<size_t>(index) < m_data.size();
+}
+
+template <typename T>
+void TypedArray<T>::offsetSet(Variant offset, Variant value)
+{
+   if (offset.isNull()) {
+      m_data.push_back(convertValue(value));
+      return;
+   }
+   m_data[checkOffset(offset)] = convertValue(value);
+}
+
+template <typename T>
+Variant TypedArray<T>::offsetGet(Variant offset)
+{
+   return make_variant(m_data[checkOffset(offset)]);
+}
+
+template <typename T>
+void TypedArray<T>::offsetUnset(Variant offset)
+{
+   throw Exception("Cannot unset the elements of a typed array");
+}
+
+template <typename T>
+AbstractIterator *TypedArray<T>::getIterator()
+{
+   return new TypedArrayIterator<T>(this);
+}
+
+template <typename T>
+bool TypedArray<T>::createsIterator() const
+{
+   return true;
+}
+
+template <typename T>
+Variant TypedArray<T>::sum()
+{
+   return sum_values(m_data.data(), m_data.size());
+}
+
+template <typename T>
+Variant TypedArray<T>::min()
+{
+   if (m_data.empty()) {
+      return nullptr;
+   }
+   return make_variant(*std::min_element(m_data.begin(), m_data.end(), less_values<T>));
+}
+
+template <typename T>
+Variant TypedArray<T>::max()
+{
+   if (m_data.empty()) {
+      return nullptr;
+   }
+   return make_variant(*std::max_element(m_data.begin(), m_data.end(), less_values<T>));
+}
+
+template <typename T>
+void TypedArray<T>::scale(Parameters &args)
+{
+   if (args.empty()) {
+      throw Exception("Expected a factor");
+   }
+   Variant factorVariant = args.retrieveAsVariant(0);
+   if constexpr (std::is_floating_point<T>::value) {
+      T factor = convertValue(factorVariant);
+      for (T &value : m_data) {
+         value *= factor;
+      }
+   } else {
+      zend_long factor;
+      if (!integral_factor(factorVariant.getZvalPtr(), factor)) {
+         throw Exception("The factor of an integer array must be an integer");
+      }
+      /// check every product before writing any, a failed scale leaves the
+      /// array as it was
+      for (T value : m_data) {
+         T product;
+         if (__builtin_mul_overflow(value, factor, &product)) {
+            throw Exception("Scaling overflows the element type");
+         }
+      }
+      for (T &value : m_data) {
+         value = static_cast<T>(value * factor);
+      }
+   }
+}
+
+template <typename T>
+Variant TypedArray<T>::dot(Parameters &args)
+{
+   if (args.empty()) {
+      throw Exception("Expected a typed array");
+   }
+   Variant otherVariant = args.retrieveAsVariant(0);
+   zval *other = otherVariant.getZvalPtr();
+   zval *self = getObjectZvalPtr()->getZvalPtr();
+   /// an object of the same class is a native TypedArray<T>
+   if (Z_TYPE_P(other) != IS_OBJECT || Z_OBJCE_P(other) != Z_OBJCE_P(self)) {
+      throw Exception("Expected a typed array of the same class");
+   }
+   TypedArray<T> *rhs = static_cast<TypedArray<T> *>(ObjectBinder::retrieveSelfPtr(other)->getNativeObject());
+   if (rhs->m_data.size() != m_data.size()) {
+      throw Exception("The arrays must have the same length");
+   }
+   return dot_values(m_data.data(), rhs->m_data.data(), m_data.size());
+}
+
+template <typename T>
+void TypedArray<T>::sort()
+{
+   std::sort(m_data.begin(), m_data.end(), less_values<T>);
+}
+
+template <typename T>
+Variant TypedArray<T>::toArray()
+{
+   zval array;
+   array_init_size(&array, static_cast<uint32_t>(m_data.size()));
+   zend_hash_real_init_packed(Z_ARRVAL(array));
+   ZEND_HASH_FILL_PACKED(Z_ARRVAL(array)) {
+      for (T value : m_data) {
+         zval item;
+         if constexpr (std::is_floating_point<T>::value) {
+            ZVAL_DOUBLE(&item, value);
+         } else {
+            ZVAL_LONG(&item, value);
+         }
+         ZEND_HASH_FILL_ADD(&item);
+      }
+   } ZEND_HASH_FILL_END();
+   Variant result(array);
+   zval_ptr_dtor(&array);
+   return result;
+}
+
+template class TypedArray<std::int32_t>;
+template class TypedArray<std::int64_t>;
+template class TypedArray<double>;
+
+} // kernel
+} // php
@@ -9,9 +9,11 @@
 //
 // Created by polarboy on 2018/01/26.
 
+#include "polarphp/vm/lang/Class.h"
 #include "polarphp/vm/lang/Module.h"
 #include "polarphp/vm/lang/Namespace.h"
 
+#include "php/kernel/TypedArray.h"
 #include "php/kernel/Utils.h"
 #include "php/vmbinder/kernel/KernelExporter.h"
 #include "php/vmbinder/NamespaceDefs.h"
@@ -19,16 +21,21 @@
 namespace php {
 namespace vmbinder {
 
+using polar::vmapi::Class;
+using polar::vmapi::ClassType;
 using polar::vmapi::Namespace;
+using polar::vmapi::ValueArgument;
 
 namespace {
 void export_stdlib_kernel_funcs(Module &module);
+void export_stdlib_kernel_classes(Module &module);
 } // anonymous namespace
 
 bool export_stdlib_kernel_module(Module &module)
 {
    register_stdlib_namespaces(module);
    export_stdlib_kernel_funcs(module);
+   export_stdlib_kernel_classes(module);
    return module.registerToVM();
 }
 
@@ -42,6 +49,38 @@ void export_stdlib_kernel_funcs(Module &module)
    php->registerFunction<decltype(php::kernel::retrieve_patch_version), php::kernel::retrieve_patch_version>("retrieve_patch_version");
    php->registerFunction<decltype(php::kernel::retrieve_version_id), php::kernel::retrieve_version_id>("retrieve_version_id");
 }
+
+template <typename ArrayType>
+void export_typed_array_class(Namespace *ns, const char *name)
+{
+   Class<ArrayType> arrayClass(name, ClassType::Final);
+   arrayClass.template registerMethod<decltype(&ArrayType::__construct), &ArrayType::__construct>
+         ("__construct", {
+             ValueArgument("values", polar::vmapi::Type::Undefined, false)
+          });
+   arrayClass.template registerMethod<decltype(&ArrayType::sum), &ArrayType::sum>("sum");
+   arrayClass.template registerMethod<decltype(&ArrayType::min), &ArrayType::min>("min");
+   arrayClass.template registerMethod<decltype(&ArrayType::max), &ArrayType::max>("max");
+   arrayClass.template registerMethod<decltype(&ArrayType::scale), &ArrayType::scale>
+         ("scale", {
+             ValueArgument("factor")
+          });
+   arrayClass.template registerMethod<decltype(&ArrayType::dot), &ArrayType::dot>
+         ("dot", {
+             ValueArgument("other")
+          });
+   arrayClass.template registerMethod<decltype(&ArrayType::sort), &ArrayType::sort>("sort");
+   arrayClass.template registerMethod<decltype(&ArrayType::toArray), &ArrayType::toArray>("toArray");
+   ns->registerClass(std::move(arrayClass));
+}
+
+void export_stdlib_kernel_classes(Module &module)
+{
+   Namespace *php = module.findNamespace("php");
+   export_typed_array_class<php::kernel::Int32Array>(php, "Int32Array");
+   export_typed_array_class<php::kernel::Int64Array>(php, "Int64Array");
+   export_typed_array_class<php::kernel::Float64Array>(php, "Float64Array");
+}
 } // anonymous namespace
 
 } // vmbinder
@@ -0,0 +1,106 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "LazyExports.h"
+
+#include "polarphp/vm/lang/Module.h"
+#include "polarphp/vm/lang/Namespace.h"
+#include "polarphp/vm/lang/Class.h"
+#include "polarphp/vm/lang/Argument.h"
+#include "polarphp/vm/lang/Parameter.h"
+#include "polarphp/vm/ds/NumericVariant.h"
+#include "polarphp/vm/ds/Variant.h"
+#include "polarphp/vm/StdClass.h"
+
+namespace php {
+
+using polar::vmapi::Class;
+using polar::vmapi::Module;
+using polar::vmapi::Namespace;
+using polar::vmapi::NumericVariant;
+using polar::vmapi::Parameters;
+using polar::vmapi::StdClass;
+using polar::vmapi::ValueArgument;
+using polar::vmapi::Variant;
+
+namespace {
+
+Variant lazy_add(Parameters &args)
+{
+   NumericVariant &num1 = args.at<NumericVariant>(0);
+   NumericVariant &num2 = args.at<NumericVariant>(1);
+   return num1 + num2;
+}
+
+Variant lazy_name()
+{
+   return "lazystdlib";
+}
+
+class LazyShape : public StdClass
+{
+public:
+   Variant getName()
+   {
+      return "shape";
+   }
+};
+
+class LazyCircle : public LazyShape
+{
+public:
+   Variant getName()
+   {
+      return "circle";
+   }
+};
+
+class LazyItem : public StdClass
+{
+public:
+   Variant getName()
+   {
+      return "item";
+   }
+};
+
+} // anonymous namespace
+
+bool export_lazy_module_to_zendvm()
+{
+   static Module lazyModule("lazystdlib", "1.0");
+   lazyModule.setLazyRegistration();
+   lazyModule.registerFunction<decltype(lazy_add), lazy_add>
+         ("lazy_add", {
+             ValueArgument("num1"),
+             ValueArgument("num2")
+          });
+   lazyModule.registerFunction<decltype(lazy_name), lazy_name>("lazy_name");
+
+   Class<LazyShape> shape("LazyShape");
+   Class<LazyCircle> circle("LazyCircle");
+   shape.registerMethod<decltype(&LazyShape::getName), &LazyShape::getName>("getName");
+   circle.registerMethod<decltype(&LazyCircle::getName), &LazyCircle::getName>("getName");
+   circle.registerBaseClass(shape);
+   lazyModule.registerClass(shape);
+   lazyModule.registerClass(circle);
+
+   Namespace lazyns("lazyns");
+   Class<LazyItem> item("LazyItem");
+   item.registerMethod<decltype(&LazyItem::getName), &LazyItem::getName>("getName");
+   lazyns.registerFunction<decltype(lazy_name), lazy_name>("lazy_name");
+   lazyns.registerClass(item);
+   lazyModule.registerNamespace(std::move(lazyns));
+
+   return lazyModule.registerToVM();
+}
+
+} // php
@@ -0,0 +1,22 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#ifndef POLARPHP_STDLIBMOCK_LAZY_EXPORTS_H
+#define POLARPHP_STDLIBMOCK_LAZY_EXPORTS_H
+
+namespace php {
+
+/// a module whose functions and classes are registered on first use
+bool export_lazy_module_to_zendvm();
+
+} // php
+
+#endif // POLARPHP_STDLIBMOCK_LAZY_EXPORTS_H
@@ -11,6 +11,7 @@
 
 #include "PdkMockDefs.h"
 #include "StdlibExports.h"
+#include "LazyExports.h"
 
 namespace php {
 
@@ -19,6 +20,9 @@ bool stdlib_init_entry()
    if (!export_stdlib_to_zendvm()) {
       return false;
    }
+   if (!export_lazy_module_to_zendvm()) {
+      return false;
+   }
    return true;
 }
 
@@ -0,0 +1,150 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+// the array functions reuse one prepared call frame for their callback,
+// every kind of callable must behave as with a regular call
+
+class Math
+{
+    public $factor = 10;
+
+    public static function square($x)
+    {
+        return $x * $x;
+    }
+
+    public function scale($x)
+    {
+        return $x * $this->factor;
+    }
+
+    public static function compare($a, $b)
+    {
+        return $a <=> $b;
+    }
+}
+
+// a closure importing by reference updates the outer variable
+$calls = 0;
+$doubled = array_map(function ($x) use (&$calls) {
+    ++$calls;
+    return $x * 2;
+}, [1, 2, 3]);
+echo implode(",", $doubled), " calls=", $calls, "\n";
+$sum = 0;
+$odd = array_filter([1, 2, 3, 4], function ($x) use (&$sum) {
+    $sum += $x;
+    return $x % 2;
+});
+echo implode(",", $odd), " sum=", $sum, "\n";
+
+// static and instance methods
+echo implode(",", array_map('Math::square', [1, 2, 3])), "\n";
+echo implode(",", array_map(['Math', 'square'], [4])), "\n";
+$math = new Math();
+$math->factor = 3;
+echo implode(",", array_map([$math, 'scale'], [1, 2])), "\n";
+echo array_reduce([1, 2, 3], function ($carry, $x) use ($math) {
+    return $carry + $math->scale($x);
+}, 0), "\n";
+$values = [3, 1, 2];
+usort($values, ['Math', 'compare']);
+echo implode(",", $values), "\n";
+$values = ['b' => 2, 'c' => 3, 'a' => 1];
+uasort($values, 'Math::compare');
+echo implode(",", array_keys($values)), "\n";
+uksort($values, [new Math(), 'compare']);
+echo implode(",", array_keys($values)), "\n";
+
+// arguments beyond the parameters are passed, missing ones are an error
+$counts = [];
+array_walk($values, function ($value) use (&$counts) {
+    $counts[] = func_num_args();
+});
+echo implode(",", $counts), "\n";
+echo implode(",", array_map('str_repeat', ['a', 'b'], [2, 3])), "\n";
+echo implode(",", array_filter(['x' => 1, 'y' => 2], function ($value) {
+    return func_get_arg(1) == 'y';
+}, ARRAY_FILTER_USE_BOTH)), "\n";
+try {
+    array_map(function ($x, $y) {
+        return $x . $y;
+    }, [1]);
+} catch (ArgumentCountError $e) {
+    echo get_class($e), "\n";
+}
+
+// an exception leaves the loop and the next call still works
+foreach (['array_map', 'array_filter', 'usort'] as $name) {
+    $array = [1, 2, 3];
+    try {
+        if ($name == 'usort') {
+            usort($array, function ($a, $b) {
+                throw new Exception("compare $a $b");
+            });
+        } else {
+            $name(function ($x) {
+                if ($x == 2) {
+                    throw new Exception("at $x");
+                }
+                return $x;
+            }, $array);
+        }
+    } catch (Exception $e) {
+        echo $name, ": ", substr($e->getMessage(), 0, 7), "\n";
+    }
+}
+echo implode(",", array_map('Math::square', [5])), "\n";
+
+// a comparator sorting on its own keeps the outer sort intact
+$outer = [[3, 1], [2, 9, 0], [5], [4, 8]];
+$inner = 0;
+usort($outer, function ($a, $b) use (&$inner) {
+    usort($a, function ($x, $y) use (&$inner) {
+        ++$inner;
+        return $x <=> $y;
+    });
+    usort($b, ['Math', 'compare']);
+    return $a[0] <=> $b[0];
+});
+echo implode("|", array_map(function ($list) {
+    return implode(" ", $list);
+}, $outer)), " ", $inner > 0 ? "nested" : "flat", "\n";
+
+// array_walk passes the value by reference
+$array = [1, 2, 3];
+array_walk($array, function (&$value, $key) {
+    $value = $value * 10 + $key;
+});
+echo implode(",", $array), "\n";
+$nested = ['a' => 1, 'b' => [2, 3, [4]]];
+array_walk_recursive($nested, function (&$value) {
+    ++$value;
+});
+echo $nested['a'], ",", $nested['b'][0], ",", $nested['b'][1], ",", $nested['b'][2][0], "\n";
+$array = [1, 2];
+array_walk($array, [$math, 'scale']);
+echo implode(",", $array), "\n";
+
+// CHECK: 2,4,6 calls=3
+// CHECK-NEXT: 1,3 sum=10
+// CHECK-NEXT: 1,4,9
+// CHECK-NEXT: 16
+// CHECK-NEXT: 3,6
+// CHECK-NEXT: 18
+// CHECK-NEXT: 1,2,3
+// CHECK-NEXT: a,b,c
+// CHECK-NEXT: a,b,c
+// CHECK-NEXT: 2,2,2
+// CHECK-NEXT: aa,bbb
+// CHECK-NEXT: 2
+// CHECK-NEXT: ArgumentCountError
+// CHECK-NEXT: array_map: at 2
+// CHECK-NEXT: array_filter: at 2
+// CHECK-NEXT: usort: compare
+// CHECK-NEXT: 25
+// CHECK-NEXT: 2 9 0|3 1|4 8|5 nested
+// CHECK-NEXT: 10,21,32
+// CHECK-NEXT: 2,3,4,5
+// CHECK-NEXT: 1,2
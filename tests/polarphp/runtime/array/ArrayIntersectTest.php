@@ -0,0 +1,61 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+// array_intersect() compares the string forms of the values and keeps the
+// elements of the first array, with their keys and in their order
+
+function dump_pairs($array)
+{
+    $pairs = [];
+    foreach ($array as $key => $value) {
+        $pairs[] = "$key=" . var_export($value, true);
+    }
+    echo "[", implode(",", $pairs), "]\n";
+}
+
+// "1" and 1 have the same string form, "01" does not
+dump_pairs(array_intersect([1, "1", 1.0, "01", true, 2], ["1"]));
+dump_pairs(array_intersect(["1", "2"], [1, 2.0]));
+
+// the duplicates of the first array are all kept, the ones of the others
+// count once
+dump_pairs(array_intersect(["a", "b", "a", "c", "a"], ["a", "c", "c"], ["c", "a", "a"]));
+
+// string and integer keys are preserved
+dump_pairs(array_intersect(["x" => "red", 5 => "green", "y" => "blue", 9 => "red"], [3 => "blue", 4 => "red"]));
+
+// a value must be in every other array
+dump_pairs(array_intersect(["a", "b"], ["b"], ["a"]));
+dump_pairs(array_intersect(["a", "b"], []));
+dump_pairs(array_intersect([], ["a"]));
+
+// an error handler throwing on a value without string form stops the
+// intersection
+class NoStringForm
+{
+}
+
+set_error_handler(function ($errno, $message) {
+    throw new Exception($message);
+});
+foreach ([[[1, new stdClass], [1]], [[1, 2], [2, new NoStringForm()]]] as $args) {
+    try {
+        var_dump(array_intersect(...$args));
+    } catch (Exception $e) {
+        echo get_class($e), ": ", $e->getMessage(), "\n";
+    }
+}
+restore_error_handler();
+dump_pairs(array_intersect([1, 2], [2]));
+
+// CHECK: [0=1,1='1',2=1.0,4=true]
+// CHECK-NEXT: [0='1',1='2']
+// CHECK-NEXT: [0='a',2='a',3='c',4='a']
+// CHECK-NEXT: [x='red',y='blue',9='red']
+// CHECK-NEXT: []
+// CHECK-NEXT: []
+// CHECK-NEXT: []
+// CHECK-NEXT: Exception: Object of class stdClass could not be converted to string
+// CHECK-NEXT: Exception: Object of class NoStringForm could not be converted to string
+// CHECK-NEXT: [1=2]
@@ -0,0 +1,27 @@
+<?php
+// RUN: %{polarphp} -d disable_functions=intval %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+// a disabled function loses its thread safe flag, its warning handler runs
+// on the executor thread for every element
+
+$warnings = [];
+set_error_handler(function ($errno, $message) use (&$warnings) {
+    $warnings[$message] = ($warnings[$message] ?? 0) + 1;
+    return true;
+});
+$input = [];
+for ($i = 0; $i < 70000; ++$i) {
+    $input[] = $i + 0.5;
+}
+$result = array_map_parallel('intval', $input);
+echo count($result), " ", count(array_filter($result, 'is_null')), "\n";
+$result = array_map_parallel('is_float', $input);
+echo count(array_filter($result)), "\n";
+foreach ($warnings as $message => $count) {
+    echo $message, ": ", $count, "\n";
+}
+
+// CHECK: 70000 70000
+// CHECK-NEXT: 70000
+// CHECK-NEXT: intval() has been disabled for security reasons: 70000
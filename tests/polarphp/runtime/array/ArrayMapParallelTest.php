@@ -0,0 +1,73 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+// array_map_parallel() returns what array_map() returns, whether the
+// workers run the callback or it falls back to the sequential path
+
+function dump_pairs($array)
+{
+    $pairs = [];
+    foreach ($array as $key => $value) {
+        $pairs[] = "$key=" . var_export($value, true);
+    }
+    echo implode(",", $pairs), "\n";
+}
+
+// large enough to be split across the workers, the strings are mapped on
+// the executor thread afterwards
+$input = [];
+for ($i = 0; $i < 70000; ++$i) {
+    switch ($i % 4) {
+    case 0:
+        $input[] = $i + 0.75;
+        break;
+    case 1:
+        $input[] = "$i";
+        break;
+    case 2:
+        $input[] = $i % 8 == 2 ? true : null;
+        break;
+    default:
+        $input[] = -$i;
+    }
+}
+$parallel = array_map_parallel('intval', $input);
+echo count($parallel), "\n";
+echo $parallel === array_map('intval', $input) ? "same" : "differs", "\n";
+dump_pairs(array_slice($parallel, 0, 8));
+dump_pairs(array_slice($parallel, 69996));
+$parallel = array_map_parallel('\IS_NUMERIC', $input);
+echo $parallel === array_map('is_numeric', $input) ? "same" : "differs", "\n";
+
+// a user closure is never run on the workers
+$factor = 3;
+$parallel = array_map_parallel(function ($value) use ($factor) {
+    return intval($value) * $factor;
+}, $input);
+echo $parallel === array_map(function ($value) use ($factor) {
+    return intval($value) * $factor;
+}, $input) ? "same" : "differs", "\n";
+dump_pairs(array_slice($parallel, 0, 4));
+
+// a single array keeps its keys
+dump_pairs(array_map_parallel('intval', ['a' => 1.5, 'b' => '2', 10 => 3.25, 7 => null]));
+dump_pairs(array_map_parallel('is_int', [5 => 1, 3 => 1.0]));
+
+// several arrays are zipped and renumbered like with array_map()
+dump_pairs(array_map_parallel(function ($left, $right) {
+    return "$left$right";
+}, ['x' => 1, 'y' => 2, 'z' => 3], ['a', 'b']));
+dump_pairs(array_map_parallel(null, [1, 2], [3, 4])[1]);
+
+// CHECK: 70000
+// CHECK-NEXT: same
+// CHECK-NEXT: 0=0,1=1,2=1,3=-3,4=4,5=5,6=0,7=-7
+// CHECK-NEXT: 0=69996,1=69997,2=0,3=-69999
+// CHECK-NEXT: same
+// CHECK-NEXT: same
+// CHECK-NEXT: 0=0,1=3,2=3,3=-9
+// CHECK-NEXT: a=1,b=2,10=3,7=0
+// CHECK-NEXT: 5=true,3=false
+// CHECK-NEXT: 0='1a',1='2b',2='3'
+// CHECK-NEXT: 0=2,1=4
@@ -0,0 +1,130 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+// in_array() and array_search() scan packed arrays of integers or doubles
+// two elements per step, the results must match the == and === semantics
+
+function check($label, $needle, $array, $strict = false)
+{
+    echo $label, ": ", var_export(in_array($needle, $array, $strict), true), " ",
+        var_export(array_search($needle, $array, $strict), true), "\n";
+}
+
+function packed($count, $value)
+{
+    $array = [];
+    for ($i = 0; $i < $count; ++$i) {
+        $array[] = $value($i);
+    }
+    return $array;
+}
+
+$ints = packed(9, function ($i) { return $i * 3; });
+$floats = packed(9, function ($i) { return $i * 0.5; });
+
+// hits in both halves of a step and at the tail after the paired loop
+check("int first", 0, $ints);
+check("int second of pair", 3, $ints);
+check("int tail", 24, $ints);
+check("int before tail", 21, $ints);
+check("int missing", 25, $ints);
+check("int even count tail", 21, packed(8, function ($i) { return $i * 3; }));
+check("int single", 7, [7]);
+check("int empty", 7, []);
+check("float tail", 4.0, $floats);
+check("float second of pair", 0.5, $floats);
+check("float missing", 0.25, $floats);
+
+// the halves of a 64 bit integer are compared together
+check("int low half", -1, [4294967295, 0]);
+check("int high half", 4294967296, [0, 1, 4294967297]);
+check("int max", PHP_INT_MAX, [PHP_INT_MIN, 0, PHP_INT_MAX]);
+check("int min", PHP_INT_MIN, [PHP_INT_MAX, PHP_INT_MIN]);
+
+// NAN is equal to nothing, 0.0 equals -0.0
+check("nan", NAN, [1.0, NAN, NAN]);
+check("nan strict", NAN, [NAN], true);
+check("nan tail", NAN, [1.0, 2.0, NAN]);
+check("zero finds negative zero", 0.0, [1.5, 2.5, -0.0]);
+check("negative zero finds zero", -0.0, [1.5, 0.0]);
+check("negative zero strict", -0.0, [0.0], true);
+check("inf", INF, [-INF, 1.0, INF]);
+check("float loose int elements", 2.0, [1, 2, 3]);
+check("float loose tail", 3.0, [1.5, 2.5, 3]);
+
+// loose equality between integers and doubles
+check("int finds float", 2, [1.5, 2.0]);
+check("int finds float after ints", 5, [1, 2, 3, 5.0]);
+check("int strict skips float", 2, [2.0, 2], true);
+check("float strict skips int", 2.0, [2, 2.0], true);
+check("int strict missing", 2, [2.0, "2"], true);
+check("float strict missing", 1.0, [1, "1"], true);
+
+// elements of another type hand the rest of the search to the generic loop
+check("int string element", 3, [1, 2, "3"]);
+check("int numeric string", 10, [1, 2, "1e1", 10]);
+check("int non numeric string", 0, [1, 2, "a"]);
+check("int null element", 0, [1, 2, null]);
+check("int bool element", 5, [1, 2, true]);
+check("int bool strict", 5, [1, 2, true, 5], true);
+check("float string element", 1.5, [1.0, "1.5"]);
+check("int after array", 4, [1, [4], 4]);
+$value = 6;
+$refs = [1, 2, 3];
+$refs[1] = &$value;
+check("int reference", 6, $refs);
+check("int reference strict", 6, $refs, true);
+
+// arrays with holes or string keys take the generic loop
+$holes = [1, 2, 3, 4];
+unset($holes[1]);
+check("int hole", 2, $holes);
+check("int after hole", 4, $holes);
+check("int hash", 8, ["a" => 4, "b" => 8]);
+check("float hash", 0.5, [5 => 1.5, 3 => 0.5]);
+
+// CHECK: int first: true 0
+// CHECK-NEXT: int second of pair: true 1
+// CHECK-NEXT: int tail: true 8
+// CHECK-NEXT: int before tail: true 7
+// CHECK-NEXT: int missing: false false
+// CHECK-NEXT: int even count tail: true 7
+// CHECK-NEXT: int single: true 0
+// CHECK-NEXT: int empty: false false
+// CHECK-NEXT: float tail: true 8
+// CHECK-NEXT: float second of pair: true 1
+// CHECK-NEXT: float missing: false false
+// CHECK-NEXT: int low half: false false
+// CHECK-NEXT: int high half: false false
+// CHECK-NEXT: int max: true 2
+// CHECK-NEXT: int min: true 1
+// CHECK-NEXT: nan: false false
+// CHECK-NEXT: nan strict: false false
+// CHECK-NEXT: nan tail: false false
+// CHECK-NEXT: zero finds negative zero: true 2
+// CHECK-NEXT: negative zero finds zero: true 1
+// CHECK-NEXT: negative zero strict: true 0
+// CHECK-NEXT: inf: true 2
+// CHECK-NEXT: float loose int elements: true 1
+// CHECK-NEXT: float loose tail: true 2
+// CHECK-NEXT: int finds float: true 1
+// CHECK-NEXT: int finds float after ints: true 3
+// CHECK-NEXT: int strict skips float: true 1
+// CHECK-NEXT: float strict skips int: true 1
+// CHECK-NEXT: int strict missing: false false
+// CHECK-NEXT: float strict missing: false false
+// CHECK-NEXT: int string element: true 2
+// CHECK-NEXT: int numeric string: true 2
+// CHECK-NEXT: int non numeric string: true 2
+// CHECK-NEXT: int null element: true 2
+// CHECK-NEXT: int bool element: true 2
+// CHECK-NEXT: int bool strict: true 3
+// CHECK-NEXT: float string element: true 1
+// CHECK-NEXT: int after array: true 2
+// CHECK-NEXT: int reference: true 1
+// CHECK-NEXT: int reference strict: true 1
+// CHECK-NEXT: int hole: false false
+// CHECK-NEXT: int after hole: true 3
+// CHECK-NEXT: int hash: true 'b'
+// CHECK-NEXT: float hash: true 3
@@ -0,0 +1,169 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+// array_slice() and array_chunk() address packed arrays without holes by
+// position, every window must give the result of a walk over the elements
+
+function walk_slice($array, $offset, $length, $preserveKeys)
+{
+    $count = count($array);
+    if ($offset > $count) {
+        return [];
+    }
+    if ($offset < 0 && ($offset = $count + $offset) < 0) {
+        $offset = 0;
+    }
+    if ($length === null) {
+        $length = $count;
+    }
+    if ($length < 0) {
+        $length = $count - $offset + $length;
+    } elseif ($offset + $length > $count) {
+        $length = $count - $offset;
+    }
+    $result = [];
+    $position = 0;
+    foreach ($array as $key => $value) {
+        if ($position >= $offset && $position < $offset + $length) {
+            if (is_string($key) || $preserveKeys) {
+                $result[$key] = $value;
+            } else {
+                $result[] = $value;
+            }
+        }
+        ++$position;
+    }
+    return $result;
+}
+
+function walk_chunk($array, $size, $preserveKeys)
+{
+    $result = [];
+    $chunk = [];
+    foreach ($array as $key => $value) {
+        if ($preserveKeys) {
+            $chunk[$key] = $value;
+        } else {
+            $chunk[] = $value;
+        }
+        if (count($chunk) == $size) {
+            $result[] = $chunk;
+            $chunk = [];
+        }
+    }
+    if ($chunk) {
+        $result[] = $chunk;
+    }
+    return $result;
+}
+
+function dump_pairs($label, $array)
+{
+    $pairs = [];
+    foreach ($array as $key => $value) {
+        $pairs[] = "$key=" . (is_array($value) ? "[" . implode(",", array_keys($value)) . "]" : $value);
+    }
+    echo $label, ": ", implode(",", $pairs), "\n";
+}
+
+$packed = [10, 20, 30, 40, 50, 60, 70];
+$holes = $packed;
+unset($holes[2], $holes[5]);
+$trailing = $packed;
+unset($trailing[6]);
+$hash = ["a" => 1, 5 => 2, "b" => 3, 3 => 4, 9 => 5];
+$numericHash = [7 => "x", 2 => "y", 4 => "z", 11 => "w"];
+$shared = 99;
+$references = [1, 2, 3, 4];
+$references[1] = &$shared;
+
+$arrays = [
+    "packed" => $packed,
+    "holes" => $holes,
+    "trailing" => $trailing,
+    "hash" => $hash,
+    "numeric hash" => $numericHash,
+    "references" => $references,
+    "empty" => [],
+];
+
+foreach ($arrays as $name => $array) {
+    $mismatches = 0;
+    for ($offset = -9; $offset <= 9; ++$offset) {
+        foreach (array_merge([null], range(-9, 9)) as $length) {
+            foreach ([false, true] as $preserveKeys) {
+                if (array_slice($array, $offset, $length, $preserveKeys) !== walk_slice($array, $offset, $length, $preserveKeys)) {
+                    echo "slice $name $offset ", var_export($length, true), " ", var_export($preserveKeys, true), " differs\n";
+                    ++$mismatches;
+                }
+            }
+        }
+    }
+    for ($size = 1; $size <= 8; ++$size) {
+        foreach ([false, true] as $preserveKeys) {
+            if (array_chunk($array, $size, $preserveKeys) !== walk_chunk($array, $size, $preserveKeys)) {
+                echo "chunk $name $size ", var_export($preserveKeys, true), " differs\n";
+                ++$mismatches;
+            }
+        }
+    }
+    echo $name, ": ", $mismatches, " mismatches\n";
+}
+
+dump_pairs("slice packed", array_slice($packed, 2, 3));
+dump_pairs("slice packed keys", array_slice($packed, 2, 3, true));
+dump_pairs("slice packed negative", array_slice($packed, -3, -1));
+dump_pairs("slice holes", array_slice($holes, 1, 3));
+dump_pairs("slice holes keys", array_slice($holes, 1, 3, true));
+dump_pairs("slice hash", array_slice($hash, 1, -1));
+dump_pairs("slice hash keys", array_slice($hash, 1, -1, true));
+dump_pairs("chunk packed", array_chunk($packed, 3));
+dump_pairs("chunk holes keys", array_chunk($holes, 2, true));
+
+// the results are arrays of their own, the next index follows the last key
+$whole = array_slice($packed, 0);
+$whole[] = 80;
+echo "whole: ", count($whole), " ", count($packed), "\n";
+$window = array_slice($packed, 1, 2);
+$window[] = 0;
+dump_pairs("window append", $window);
+$trailingWhole = array_slice($trailing, 0, null, true);
+$trailingWhole[] = 0;
+dump_pairs("trailing append", $trailingWhole);
+$chunks = array_chunk($packed, 3);
+$chunks[2][] = 0;
+dump_pairs("chunk append", $chunks[2]);
+echo "chunk source: ", implode(",", $packed), "\n";
+
+// a reference shared with a variable stays shared
+$slice = array_slice($references, 0, 2);
+$slice[1] = 100;
+echo "shared: ", $shared, "\n";
+$chunks = array_chunk($references, 2);
+$chunks[0][1] = 200;
+echo "shared: ", $shared, "\n";
+
+// CHECK: packed: 0 mismatches
+// CHECK-NEXT: holes: 0 mismatches
+// CHECK-NEXT: trailing: 0 mismatches
+// CHECK-NEXT: hash: 0 mismatches
+// CHECK-NEXT: numeric hash: 0 mismatches
+// CHECK-NEXT: references: 0 mismatches
+// CHECK-NEXT: empty: 0 mismatches
+// CHECK-NEXT: slice packed: 0=30,1=40,2=50
+// CHECK-NEXT: slice packed keys: 2=30,3=40,4=50
+// CHECK-NEXT: slice packed negative: 0=50,1=60
+// CHECK-NEXT: slice holes: 0=20,1=40,2=50
+// CHECK-NEXT: slice holes keys: 1=20,3=40,4=50
+// CHECK-NEXT: slice hash: 0=2,b=3,1=4
+// CHECK-NEXT: slice hash keys: 5=2,b=3,3=4
+// CHECK-NEXT: chunk packed: 0=[0,1,2],1=[0,1,2],2=[0]
+// CHECK-NEXT: chunk holes keys: 0=[0,1],1=[3,4],2=[6]
+// CHECK-NEXT: whole: 8 7
+// CHECK-NEXT: window append: 0=20,1=30,2=0
+// CHECK-NEXT: trailing append: 0=10,1=20,2=30,3=40,4=50,5=60,6=0
+// CHECK-NEXT: chunk append: 0=70,1=0
+// CHECK-NEXT: chunk source: 10,20,30,40,50,60,70
+// CHECK-NEXT: shared: 100
+// CHECK-NEXT: shared: 200
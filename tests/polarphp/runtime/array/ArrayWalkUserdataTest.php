@@ -0,0 +1,31 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+// the third argument of array_walk() and array_walk_recursive() reaches
+// the callback after the value and the key
+
+$seen = [];
+$array = ['x' => 1, 'y' => 2];
+array_walk($array, function ($value, $key, $prefix) use (&$seen) {
+    $seen[] = $prefix . $key . "=" . $value . "/" . func_num_args();
+}, "p:");
+echo implode(",", $seen), "\n";
+
+// the same userdata is passed to every level, even by reference
+$nested = [1, [2, [3]]];
+array_walk_recursive($nested, function (&$value, $key, $step) {
+    $value += $step;
+}, 10);
+echo $nested[0], ",", $nested[1][0], ",", $nested[1][1][0], "\n";
+
+// without userdata the callback gets two arguments
+$counts = [];
+array_walk($array, function () use (&$counts) {
+    $counts[] = func_num_args();
+});
+echo implode(",", $counts), "\n";
+
+// CHECK: p:x=1/3,p:y=2/3
+// CHECK-NEXT: 11,12,13
+// CHECK-NEXT: 2,2
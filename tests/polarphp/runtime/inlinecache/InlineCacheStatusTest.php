@@ -0,0 +1,68 @@
+<?php
+// REQUIRES: inline_cache_stats
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+class A { public $x = 1; public function m() { return 1; } }
+class B { public $x = 2; public function m() { return 2; } }
+class C { public function m() { return 3; } }
+class D { public function m() { return 4; } }
+class E { public function m() { return 5; } }
+
+function read_x($obj) { return $obj->x; }
+function isset_x($obj) { return isset($obj->x); }
+function call_m($obj) { return $obj->m(); }
+
+function print_delta($title, $before)
+{
+    $after = inline_cache_status();
+    echo $title, "\n";
+    foreach (["hits", "polymorphic_hits", "misses", "evictions"] as $name) {
+        echo $name, ": ", $after[$name] - $before[$name], "\n";
+    }
+}
+
+$a = new A();
+$b = new B();
+
+$before = inline_cache_status();
+read_x($a);
+read_x($a);
+read_x($b);
+read_x($a);
+print_delta("property fetch", $before);
+
+// CHECK: property fetch
+// CHECK-NEXT: hits: 1
+// CHECK-NEXT: polymorphic_hits: 1
+// CHECK-NEXT: misses: 2
+// CHECK-NEXT: evictions: 0
+
+// isset() has no fast path, zend_get_property_offset() does the lookup
+$before = inline_cache_status();
+isset_x($a);
+isset_x($a);
+isset_x($b);
+print_delta("property isset", $before);
+
+// CHECK: property isset
+// CHECK-NEXT: hits: 1
+// CHECK-NEXT: polymorphic_hits: 0
+// CHECK-NEXT: misses: 2
+// CHECK-NEXT: evictions: 0
+
+$before = inline_cache_status();
+call_m($a);
+call_m($a);
+call_m($b);
+call_m(new C());
+call_m(new D());
+call_m($a);
+call_m(new E());
+print_delta("method call", $before);
+
+// CHECK: method call
+// CHECK-NEXT: hits: 1
+// CHECK-NEXT: polymorphic_hits: 1
+// CHECK-NEXT: misses: 5
+// CHECK-NEXT: evictions: 1
@@ -0,0 +1,115 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+function dump($array)
+{
+    echo implode(",", $array->toArray()), "\n";
+}
+
+// every foreach has its own position
+$a = new php\Int32Array([3, 1, 2]);
+$pairs = [];
+foreach ($a as $i => $x) {
+    foreach ($a as $j => $y) {
+        $pairs[] = "$i$j";
+    }
+}
+echo implode(" ", $pairs), "\n";
+
+// an integer array takes integral factors only
+$a->scale(2);
+dump($a);
+$a->scale(2.0);
+dump($a);
+$a->scale("3");
+dump($a);
+try {
+    $a->scale(0.5);
+} catch (Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+dump($a);
+
+// an overflowing product leaves the array unchanged
+$b = new php\Int32Array([2147483647, 1]);
+try {
+    $b->scale(2);
+} catch (Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+dump($b);
+$c = new php\Int64Array([PHP_INT_MAX, -1]);
+$c->scale(-1);
+dump($c);
+try {
+    $c->scale(PHP_INT_MAX);
+} catch (Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+dump($c);
+
+$d = new php\Float64Array([1.5, -2.0]);
+$d->scale(0.5);
+dump($d);
+
+// NaN sorts after every number
+$f = new php\Float64Array([3.5, NAN, 1.0, NAN, -2.0]);
+$f->sort();
+dump($f);
+echo $f->min(), " ", $f->max(), "\n";
+
+// a value out of the range of the element type is refused, not truncated
+$g = new php\Int32Array([2147483647, -2147483648]);
+foreach ([2147483648, -2147483649, 1e10, "4294967296"] as $value) {
+    try {
+        $g[] = $value;
+    } catch (Exception $e) {
+        echo $e->getMessage(), "\n";
+    }
+}
+try {
+    new php\Int32Array([1, 4294967297]);
+} catch (Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+dump($g);
+// the negated minimum does not fit either
+try {
+    $g->scale(-1);
+} catch (Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+dump($g);
+$h = new php\Int64Array([1]);
+try {
+    $h[0] = 1e19;
+} catch (Exception $e) {
+    echo $e->getMessage(), "\n";
+}
+dump($h);
+
+// CHECK: 00 01 02 10 11 12 20 21 22
+// CHECK-NEXT: 6,2,4
+// CHECK-NEXT: 12,4,8
+// CHECK-NEXT: 36,12,24
+// CHECK-NEXT: The factor of an integer array must be an integer
+// CHECK-NEXT: 36,12,24
+// CHECK-NEXT: Scaling overflows the element type
+// CHECK-NEXT: 2147483647,1
+// CHECK-NEXT: -9223372036854775807,1
+// CHECK-NEXT: Scaling overflows the element type
+// CHECK-NEXT: -9223372036854775807,1
+// CHECK-NEXT: 0.75,-1
+// CHECK-NEXT: -2,1,3.5,NAN,NAN
+// CHECK-NEXT: -2 NAN
+// CHECK-NEXT: Value overflows the element type
+// CHECK-NEXT: Value overflows the element type
+// CHECK-NEXT: Value overflows the element type
+// CHECK-NEXT: Value overflows the element type
+// CHECK-NEXT: Value overflows the element type
+// CHECK-NEXT: 2147483647,-2147483648
+// CHECK-NEXT: Scaling overflows the element type
+// CHECK-NEXT: 2147483647,-2147483648
+// CHECK-NEXT: Value overflows the element type
+// CHECK-NEXT: 1
@@ -0,0 +1,116 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+// foreach over range() and array_fill() walks a LazyRange, the keys and
+// values must match the ones of the eager array
+
+function dump_pairs($label, $pairs)
+{
+    echo $label, ": ", implode(",", $pairs), "\n";
+}
+
+$lazy = [];
+foreach (range(1, 5) as $key => $value) {
+    $lazy[] = "$key=$value";
+}
+$eager = [];
+$array = range(1, 5);
+foreach ($array as $key => $value) {
+    $eager[] = "$key=$value";
+}
+dump_pairs("range(1, 5)", $lazy);
+echo $lazy === $eager ? "same" : "differs", "\n";
+
+$lazy = [];
+foreach (range(5, 1, 2) as $key => $value) {
+    $lazy[] = "$key=$value";
+}
+$eager = [];
+$array = range(5, 1, 2);
+foreach ($array as $key => $value) {
+    $eager[] = "$key=$value";
+}
+dump_pairs("range(5, 1, 2)", $lazy);
+echo $lazy === $eager ? "same" : "differs", "\n";
+
+$lazy = [];
+foreach (range(0, 10, 3) as $key => $value) {
+    $lazy[] = "$key=$value";
+}
+$eager = [];
+$array = range(0, 10, 3);
+foreach ($array as $key => $value) {
+    $eager[] = "$key=$value";
+}
+dump_pairs("range(0, 10, 3)", $lazy);
+echo $lazy === $eager ? "same" : "differs", "\n";
+
+$lazy = [];
+foreach (array_fill(5, 3, 'x') as $key => $value) {
+    $lazy[] = "$key=$value";
+}
+$eager = [];
+$array = array_fill(5, 3, 'x');
+foreach ($array as $key => $value) {
+    $eager[] = "$key=$value";
+}
+dump_pairs("array_fill(5, 3)", $lazy);
+echo $lazy === $eager ? "same" : "differs", "\n";
+
+// the keys after a negative start key restart at 0
+$lazy = [];
+foreach (array_fill(-3, 3, 'y') as $key => $value) {
+    $lazy[] = "$key=$value";
+}
+$eager = [];
+$array = array_fill(-3, 3, 'y');
+foreach ($array as $key => $value) {
+    $eager[] = "$key=$value";
+}
+dump_pairs("array_fill(-3, 3)", $lazy);
+echo $lazy === $eager ? "same" : "differs", "\n";
+
+$lazy = [];
+foreach (array_fill(0, 2, 'z') as $key => $value) {
+    $lazy[] = "$key=$value";
+}
+dump_pairs("array_fill(0, 2)", $lazy);
+
+// breaking out of the loop leaves nothing behind
+foreach (range(1, 1000000) as $value) {
+    if ($value == 3) {
+        break;
+    }
+}
+echo "break at ", $value, "\n";
+
+// only range() and array_fill() create the object
+try {
+    new LazyRange();
+} catch (Error $e) {
+    echo "new: ", $e->getMessage(), "\n";
+}
+try {
+    unserialize('C:9:"LazyRange":0:{}');
+} catch (Exception $e) {
+    echo "unserialize: ", $e->getMessage(), "\n";
+}
+$class = new ReflectionClass('LazyRange');
+echo $class->isFinal() ? "final" : "not final", "\n";
+
+// CHECK: range(1, 5): 0=1,1=2,2=3,3=4,4=5
+// CHECK-NEXT: same
+// CHECK-NEXT: range(5, 1, 2): 0=5,1=3,2=1
+// CHECK-NEXT: same
+// CHECK-NEXT: range(0, 10, 3): 0=0,1=3,2=6,3=9
+// CHECK-NEXT: same
+// CHECK-NEXT: array_fill(5, 3): 5=x,6=x,7=x
+// CHECK-NEXT: same
+// CHECK-NEXT: array_fill(-3, 3): -3=y,0=y,1=y
+// CHECK-NEXT: same
+// CHECK-NEXT: array_fill(0, 2): 0=z,1=z
+// CHECK-NEXT: break at 3
+// CHECK-NEXT: new: Instantiation of 'LazyRange' is not allowed
+// CHECK-NEXT: unserialize: Unserialization of 'LazyRange' is not allowed
+// CHECK-NEXT: final
@@ -0,0 +1,208 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+// Traversable and generator sources, iterating a sequence again and
+// exceptions thrown by the callbacks or by the source
+
+function show($label, $array)
+{
+    $pairs = [];
+    foreach ($array as $key => $value) {
+        $pairs[] = "$key=$value";
+    }
+    echo $label, ": ", implode(",", $pairs), "\n";
+}
+
+class LetterIterator implements Iterator
+{
+    public $pulled = 0;
+    private $letters;
+    private $position = 0;
+
+    public function __construct($letters)
+    {
+        $this->letters = $letters;
+    }
+
+    public function rewind()
+    {
+        $this->position = 0;
+    }
+
+    public function valid()
+    {
+        return $this->position < count($this->letters);
+    }
+
+    public function current()
+    {
+        ++$this->pulled;
+        if ($this->letters[$this->position] === "!") {
+            throw new RuntimeException("bad letter at " . $this->position);
+        }
+        return $this->letters[$this->position];
+    }
+
+    public function key()
+    {
+        return "k" . $this->position;
+    }
+
+    public function next()
+    {
+        ++$this->position;
+    }
+}
+
+class LetterAggregate implements IteratorAggregate
+{
+    public function getIterator()
+    {
+        return new LetterIterator(["x", "y"]);
+    }
+}
+
+function numbers($limit)
+{
+    for ($i = 1; $limit === null || $i <= $limit; ++$i) {
+        yield "n$i" => $i;
+    }
+}
+
+$upper = function ($value) {
+    return strtoupper($value);
+};
+
+// Traversable sources keep their keys
+$letters = new LetterIterator(["a", "b", "c", "d"]);
+$seq = (new LazySequence($letters))->map($upper);
+show("iterator", $seq->toArray());
+show("iterator again", $seq->toArray());
+show("iterator foreach", $seq);
+echo "count: ", count($seq), "\n";
+$letters->pulled = 0;
+show("iterator take", $seq->take(2));
+echo "pulled: ", $letters->pulled, "\n";
+show("aggregate", (new LazySequence(new LetterAggregate()))->map($upper));
+
+// generators run once, take() ends an endless one
+show("generator", (new LazySequence(numbers(4)))->filter(function ($value) { return $value % 2 == 0; }));
+show("endless generator", (new LazySequence(numbers(null)))->map(function ($value) { return $value * $value; })->take(3));
+$once = new LazySequence(numbers(3));
+echo "generator sum: ", $once->sum(), "\n";
+try {
+    $once->sum();
+} catch (Exception $e) {
+    echo "generator again: ", $e->getMessage(), "\n";
+}
+$partial = new LazySequence(numbers(3));
+show("generator take", $partial->take(2));
+try {
+    $partial->toArray();
+} catch (Exception $e) {
+    echo "generator rewind: ", $e->getMessage(), "\n";
+}
+
+// an array source is walked again from the start every time
+$seq = (new LazySequence([1, 2, 3]))->map(function ($value) { return $value * 10; });
+$first = [];
+foreach ($seq as $key => $value) {
+    foreach ($seq as $innerValue) {
+        $first[] = "$key:$innerValue";
+    }
+}
+echo "nested: ", implode(",", $first), "\n";
+show("after nested", $seq);
+
+// callback exceptions stop the pipeline and reach the caller
+$calls = 0;
+$seq = (new LazySequence([1, 2, 3, 4]))->map(function ($value) use (&$calls) {
+    ++$calls;
+    if ($value == 3) {
+        throw new LogicException("map failed at $value");
+    }
+    return $value;
+});
+try {
+    foreach ($seq as $value) {
+        echo "foreach got ", $value, "\n";
+    }
+} catch (LogicException $e) {
+    echo "foreach: ", $e->getMessage(), ", calls: ", $calls, "\n";
+}
+foreach (["toArray", "sum", "count"] as $method) {
+    $calls = 0;
+    try {
+        $seq->$method();
+        echo $method, " returned\n";
+    } catch (LogicException $e) {
+        echo $method, ": ", $e->getMessage(), ", calls: ", $calls, "\n";
+    }
+}
+try {
+    (new LazySequence([1, 2, 3]))->filter(function ($value, $key) {
+        throw new LogicException("filter failed at $key");
+    }, ARRAY_FILTER_USE_BOTH)->toArray();
+} catch (LogicException $e) {
+    echo "filter: ", $e->getMessage(), "\n";
+}
+try {
+    (new LazySequence([1, 2, 3]))->reduce(function ($carry, $value) {
+        if ($value == 2) {
+            throw new LogicException("reduce failed after $carry");
+        }
+        return $carry + $value;
+    }, 0);
+} catch (LogicException $e) {
+    echo "reduce: ", $e->getMessage(), "\n";
+}
+try {
+    (new LazySequence([1, 2, 3, 4, 5]))->map(function ($value) {
+        if ($value == 4) {
+            throw new LogicException("chunk failed at $value");
+        }
+        return $value;
+    })->chunk(2)->toArray();
+} catch (LogicException $e) {
+    echo "chunk: ", $e->getMessage(), "\n";
+}
+try {
+    (new LazySequence(new LetterIterator(["a", "!", "c"])))->toArray();
+} catch (RuntimeException $e) {
+    echo "source: ", $e->getMessage(), "\n";
+}
+try {
+    new LazySequence(42);
+} catch (InvalidArgumentException $e) {
+    echo "constructor: ", $e->getMessage(), "\n";
+}
+echo "done\n";
+
+// CHECK: iterator: k0=A,k1=B,k2=C,k3=D
+// CHECK-NEXT: iterator again: k0=A,k1=B,k2=C,k3=D
+// CHECK-NEXT: iterator foreach: k0=A,k1=B,k2=C,k3=D
+// CHECK-NEXT: count: 4
+// CHECK-NEXT: iterator take: k0=A,k1=B
+// CHECK-NEXT: pulled: 2
+// CHECK-NEXT: aggregate: k0=X,k1=Y
+// CHECK-NEXT: generator: n2=2,n4=4
+// CHECK-NEXT: endless generator: n1=1,n2=4,n3=9
+// CHECK-NEXT: generator sum: 6
+// CHECK-NEXT: generator again: Cannot traverse an already closed generator
+// CHECK-NEXT: generator take: n1=1,n2=2
+// CHECK-NEXT: generator rewind: Cannot rewind a generator that was already run
+// CHECK-NEXT: nested: 0:10,0:20,0:30,1:10,1:20,1:30,2:10,2:20,2:30
+// CHECK-NEXT: after nested: 0=10,1=20,2=30
+// CHECK-NEXT: foreach got 1
+// CHECK-NEXT: foreach got 2
+// CHECK-NEXT: foreach: map failed at 3, calls: 3
+// CHECK-NEXT: toArray: map failed at 3, calls: 3
+// CHECK-NEXT: sum: map failed at 3, calls: 3
+// CHECK-NEXT: count: map failed at 3, calls: 3
+// CHECK-NEXT: filter: filter failed at 0
+// CHECK-NEXT: reduce: reduce failed after 1
+// CHECK-NEXT: chunk: chunk failed at 4
+// CHECK-NEXT: source: bad letter at 1
+// CHECK-NEXT: constructor: Source must be an array or a Traversable
+// CHECK-NEXT: done
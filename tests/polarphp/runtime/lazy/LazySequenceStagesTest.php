@@ -0,0 +1,101 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+// the filter modes, chunk and the terminal operations of LazySequence must
+// give the results of the matching array functions
+
+function show($label, $value)
+{
+    echo $label, ": ", describe($value), "\n";
+}
+
+function describe($value)
+{
+    if (!is_array($value)) {
+        return var_export($value, true);
+    }
+    $pairs = [];
+    foreach ($value as $key => $item) {
+        $pairs[] = var_export($key, true) . "=>" . describe($item);
+    }
+    return "[" . implode(", ", $pairs) . "]";
+}
+
+$words = ["a" => 1, "bb" => 2, "ccc" => 3, "dd" => 0];
+$seq = new LazySequence($words);
+$longKey = function ($key) {
+    return strlen($key) > 1;
+};
+$both = function ($value, $key) {
+    return $value > 1 && $key != "ccc";
+};
+show("filter", $seq->filter()->toArray());
+show("filter value", $seq->filter(function ($value) { return $value % 2 == 1; })->toArray());
+show("filter key", $seq->filter($longKey, ARRAY_FILTER_USE_KEY)->toArray());
+show("array_filter key", array_filter($words, $longKey, ARRAY_FILTER_USE_KEY));
+show("filter both", $seq->filter($both, ARRAY_FILTER_USE_BOTH)->toArray());
+show("array_filter both", array_filter($words, $both, ARRAY_FILTER_USE_BOTH));
+show("filter toArray(false)", $seq->filter($longKey, ARRAY_FILTER_USE_KEY)->toArray(false));
+
+$numbers = new LazySequence([10 => 1, 11 => 2, 12 => 3, 13 => 4, 14 => 5]);
+show("chunk", $numbers->chunk(2)->toArray());
+show("array_chunk", array_chunk([10 => 1, 11 => 2, 12 => 3, 13 => 4, 14 => 5], 2));
+show("chunk keys", $numbers->chunk(2, true)->toArray());
+show("chunk larger", $numbers->chunk(10)->toArray());
+show("chunk empty", (new LazySequence([]))->chunk(3)->toArray());
+show("chunk of filter", $numbers->filter(function ($value) { return $value != 3; })->chunk(3)->toArray());
+try {
+    $numbers->chunk(0);
+} catch (InvalidArgumentException $e) {
+    echo "chunk(0): ", $e->getMessage(), "\n";
+}
+
+$add = function ($carry, $value) {
+    return $carry + $value;
+};
+show("reduce", $numbers->reduce($add));
+show("reduce initial", $numbers->reduce($add, 100));
+show("reduce empty", (new LazySequence([]))->reduce($add, "initial"));
+show("reduce concat", $seq->reduce(function ($carry, $value) { return $carry . $value; }, ">"));
+
+show("sum", $numbers->sum());
+show("sum mixed", (new LazySequence([1, 2.5, "3", "0.5", true, null, [9]]))->sum());
+show("array_sum mixed", array_sum([1, 2.5, "3", "0.5", true, null, [9]]));
+show("sum empty", (new LazySequence([]))->sum());
+show("sum overflow", is_float((new LazySequence([PHP_INT_MAX, 1]))->sum()));
+
+show("count", $numbers->count());
+show("count()", count($numbers));
+show("count filter", count($numbers->filter(function ($value) { return $value > 2; })));
+show("count take", $numbers->take(2)->count());
+show("count empty", count(new LazySequence([])));
+
+// CHECK: filter: ['a'=>1, 'bb'=>2, 'ccc'=>3]
+// CHECK-NEXT: filter value: ['a'=>1, 'ccc'=>3]
+// CHECK-NEXT: filter key: ['bb'=>2, 'ccc'=>3, 'dd'=>0]
+// CHECK-NEXT: array_filter key: ['bb'=>2, 'ccc'=>3, 'dd'=>0]
+// CHECK-NEXT: filter both: ['bb'=>2]
+// CHECK-NEXT: array_filter both: ['bb'=>2]
+// CHECK-NEXT: filter toArray(false): [0=>2, 1=>3, 2=>0]
+// CHECK-NEXT: chunk: [0=>[0=>1, 1=>2], 1=>[0=>3, 1=>4], 2=>[0=>5]]
+// CHECK-NEXT: array_chunk: [0=>[0=>1, 1=>2], 1=>[0=>3, 1=>4], 2=>[0=>5]]
+// CHECK-NEXT: chunk keys: [0=>[10=>1, 11=>2], 1=>[12=>3, 13=>4], 2=>[14=>5]]
+// CHECK-NEXT: chunk larger: [0=>[0=>1, 1=>2, 2=>3, 3=>4, 4=>5]]
+// CHECK-NEXT: chunk empty: []
+// CHECK-NEXT: chunk of filter: [0=>[0=>1, 1=>2, 2=>4], 1=>[0=>5]]
+// CHECK-NEXT: chunk(0): Size must be greater than 0
+// CHECK-NEXT: reduce: 15
+// CHECK-NEXT: reduce initial: 115
+// CHECK-NEXT: reduce empty: 'initial'
+// CHECK-NEXT: reduce concat: '>1230'
+// CHECK-NEXT: sum: 15
+// CHECK-NEXT: sum mixed: 8.0
+// CHECK-NEXT: array_sum mixed: 8.0
+// CHECK-NEXT: sum empty: 0
+// CHECK-NEXT: sum overflow: true
+// CHECK-NEXT: count: 5
+// CHECK-NEXT: count(): 5
+// CHECK-NEXT: count filter: 3
+// CHECK-NEXT: count take: 2
+// CHECK-NEXT: count empty: 0
@@ -0,0 +1,35 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+
+$seq = new LazySequence([1, 2, 3, 4]);
+echo implode(",", $seq->map(function ($x) { return $x * 10; })->take(3)->toArray()), "\n";
+
+// an object created without its constructor has no source to pull from
+$seq = unserialize('O:12:"LazySequence":0:{}');
+echo get_class($seq), "\n";
+try {
+    foreach ($seq as $value) {
+        echo "unreachable\n";
+    }
+} catch (Error $e) {
+    echo "foreach: ", $e->getMessage(), "\n";
+}
+try {
+    $seq->map(function ($x) { return $x; })->toArray();
+} catch (Error $e) {
+    echo "toArray: ", $e->getMessage(), "\n";
+}
+try {
+    $seq->count();
+} catch (Error $e) {
+    echo "count: ", $e->getMessage(), "\n";
+}
+echo "done\n";
+
+// CHECK: 10,20,30
+// CHECK-NEXT: LazySequence
+// CHECK-NEXT: foreach: LazySequence has no source, its constructor was not called
+// CHECK-NEXT: toArray: LazySequence has no source, its constructor was not called
+// CHECK-NEXT: count: LazySequence has no source, its constructor was not called
+// CHECK-NEXT: done
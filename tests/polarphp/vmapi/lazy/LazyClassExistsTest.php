@@ -0,0 +1,40 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+// a lazy class enters the class table on its first lookup, together with its parents
+
+function show_declared()
+{
+    $classes = array_map('strtolower', get_declared_classes());
+    foreach (['LazyShape', 'LazyCircle', 'lazyns\LazyItem'] as $name) {
+        echo $name, ": ", in_array(strtolower($name), $classes) ? "declared" : "undeclared", "\n";
+    }
+}
+
+show_declared();
+var_dump(class_exists("lazycircle", false));
+show_declared();
+var_dump(class_exists("lazyns\\LazyItem"));
+var_dump(class_exists("\\lazyns\\LazyItem", false));
+var_dump(class_exists("LazyMissing", false));
+var_dump(class_exists("LazyMissing"));
+var_dump(interface_exists("LazyShape", false));
+var_dump(trait_exists("LazyShape", false));
+show_declared();
+
+// CHECK: LazyShape: undeclared
+// CHECK-NEXT: LazyCircle: undeclared
+// CHECK-NEXT: lazyns\LazyItem: undeclared
+// CHECK-NEXT: bool(true)
+// CHECK-NEXT: LazyShape: declared
+// CHECK-NEXT: LazyCircle: declared
+// CHECK-NEXT: lazyns\LazyItem: undeclared
+// CHECK-NEXT: bool(true)
+// CHECK-NEXT: bool(true)
+// CHECK-NEXT: bool(false)
+// CHECK-NEXT: bool(false)
+// CHECK-NEXT: bool(false)
+// CHECK-NEXT: bool(false)
+// CHECK-NEXT: LazyShape: declared
+// CHECK-NEXT: LazyCircle: declared
+// CHECK-NEXT: lazyns\LazyItem: declared
@@ -0,0 +1,29 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+// the first use of a lazy class is a new expression
+
+$circle = new LazyCircle();
+echo get_class($circle), "\n";
+echo $circle->getName(), "\n";
+var_dump($circle instanceof LazyShape);
+echo get_parent_class($circle), "\n";
+$shape = new LazyShape();
+echo $shape->getName(), "\n";
+$item = new \lazyns\LazyItem();
+echo get_class($item), "\n";
+echo $item->getName(), "\n";
+try {
+    $missing = new LazyMissing();
+} catch (Error $e) {
+    echo $e->getMessage(), "\n";
+}
+
+// CHECK: LazyCircle
+// CHECK-NEXT: circle
+// CHECK-NEXT: bool(true)
+// CHECK-NEXT: LazyShape
+// CHECK-NEXT: shape
+// CHECK-NEXT: lazyns\LazyItem
+// CHECK-NEXT: item
+// CHECK-NEXT: Class 'LazyMissing' not found
@@ -0,0 +1,42 @@
+<?php
+// RUN: %{polarphp} %s 1> %t.out 2>&1
+// RUN: filechecker --input-file %t.out %s
+// a lazy function enters the function table on its first lookup
+
+function show_registered()
+{
+    $functions = get_defined_functions()['internal'];
+    foreach (['lazy_add', 'lazy_name', 'lazyns\lazy_name'] as $name) {
+        echo $name, ": ", in_array($name, $functions) ? "registered" : "unregistered", "\n";
+    }
+}
+
+show_registered();
+var_dump(function_exists("lazy_add"));
+var_dump(is_callable("Lazy_Name"));
+show_registered();
+echo lazy_add(1, 2), "\n";
+echo call_user_func("lazy_name"), "\n";
+echo \lazyns\lazy_name(), "\n";
+var_dump(is_callable("\\lazyns\\LAZY_NAME"));
+var_dump(function_exists("lazy_missing"));
+var_dump(is_callable("lazy_missing"));
+show_registered();
+
+// CHECK: lazy_add: unregistered
+// CHECK-NEXT: lazy_name: unregistered
+// CHECK-NEXT: lazyns\lazy_name: unregistered
+// CHECK-NEXT: bool(true)
+// CHECK-NEXT: bool(true)
+// CHECK-NEXT: lazy_add: registered
+// CHECK-NEXT: lazy_name: registered
+// CHECK-NEXT: lazyns\lazy_name: unregistered
+// CHECK-NEXT: 3
+// CHECK-NEXT: lazystdlib
+// CHECK-NEXT: lazystdlib
+// CHECK-NEXT: bool(true)
+// CHECK-NEXT: bool(false)
+// CHECK-NEXT: bool(false)
+// CHECK-NEXT: lazy_add: registered
+// CHECK-NEXT: lazy_name: registered
+// CHECK-NEXT: lazyns\lazy_name: registered
@@ -0,0 +1,158 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 polarboy <polarboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+// Lookup benchmarks of the chained layout, the baseline of the changes to the
+// lookup paths, and of the small layout, they are disabled by default, run
+// them with
+//    ZendApiDsTest --gtest_also_run_disabled_tests --gtest_filter='HashTableBenchmark.*'
+
+#include "polarphp/vm/ZendApi.h"
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const long sg_lookupCount = 20000000;
+
+struct BenchResult
+{
+   double hitNs;
+   double strHitNs;
+   double missNs;
+};
+
+HashTable *new_table(bool small, const std::vector<zend_string *> &keys)
+{
+   HashTable *ht = zend_new_array(keys.size());
+   if (small) {
+      zend_hash_real_init_small(ht);
+   } else {
+      zend_hash_real_init_mixed(ht);
+   }
+   for (size_t i = 0; i < keys.size(); ++i) {
+      zval value;
+      ZVAL_LONG(&value, i);
+      zend_hash_add_new(ht, keys[i], &value);
+   }
+   return ht;
+}
+
+template <typename LookupFunc>
+double time_lookups(size_t keyCount, LookupFunc lookup)
+{
+   long found = 0;
+   auto start = std::chrono::steady_clock::now();
+   for (long i = 0; i < sg_lookupCount; ++i) {
+      found += lookup(i % keyCount);
+   }
+   auto elapsed = std::chrono::steady_clock::now() - start;
+   // keeps the lookups from being optimized out
+   EXPECT_TRUE(found >= 0);
+   return std::chrono::duration<double, std::nano>(elapsed).count() / sg_lookupCount;
+}
+
+BenchResult bench_table(bool small, const std::vector<zend_string *> &keys,
+                        const std::vector<zend_string *> &missingKeys)
+{
+   HashTable *ht = new_table(small, keys);
+   BenchResult result;
+   // the keys of compiled code and of the interned strings carry their hash
+   result.hitNs = time_lookups(keys.size(), [&](size_t i) {
+      return zend_hash_find(ht, keys[i]) != nullptr;
+   });
+   // ini_get() and ini_set() look the names up by their characters
+   result.strHitNs = time_lookups(keys.size(), [&](size_t i) {
+      return zend_hash_str_find(ht, ZSTR_VAL(keys[i]), ZSTR_LEN(keys[i])) != nullptr;
+   });
+   result.missNs = time_lookups(missingKeys.size(), [&](size_t i) {
+      return zend_hash_find(ht, missingKeys[i]) != nullptr;
+   });
+   zend_array_destroy(ht);
+   return result;
+}
+
+std::vector<zend_string *> make_keys(const std::vector<std::string> &names)
+{
+   std::vector<zend_string *> keys;
+   for (const std::string &name : names) {
+      zend_string *key = zend_string_init(name.c_str(), name.size(), 0);
+      zend_string_hash_val(key);
+      keys.push_back(key);
+   }
+   return keys;
+}
+
+void release_keys(std::vector<zend_string *> &keys)
+{
+   for (zend_string *key : keys) {
+      zend_string_release(key);
+   }
+   keys.clear();
+}
+
+void report(const char *workload, const std::vector<std::string> &names,
+            const std::vector<std::string> &missingNames)
+{
+   std::vector<zend_string *> keys = make_keys(names);
+   std::vector<zend_string *> missingKeys = make_keys(missingNames);
+   BenchResult chained = bench_table(false, keys, missingKeys);
+   std::cout << std::fixed << std::setprecision(2)
+             << workload << " (" << names.size() << " keys), ns per lookup\n"
+             << "   chained: hit " << chained.hitNs << ", str hit " << chained.strHitNs
+             << ", miss " << chained.missNs << "\n";
+   if (names.size() <= HT_MIN_SIZE) {
+      BenchResult small = bench_table(true, keys, missingKeys);
+      std::cout << "   small:   hit " << small.hitNs << ", str hit " << small.strHitNs
+                << ", miss " << small.missNs << "\n";
+   }
+   release_keys(keys);
+   release_keys(missingKeys);
+}
+
+} // anonymous namespace
+
+TEST(HashTableBenchmark, DISABLED_benchConfigMap)
+{
+   // shaped like the ini directive tables, a few hundred dotted names
+   const char *sections[] = {"session", "mbstring", "opcache", "date", "pcre",
+                             "zend", "mysqli", "curl", "intl", "assert"};
+   std::vector<std::string> names;
+   std::vector<std::string> missingNames;
+   for (const char *section : sections) {
+      for (int i = 0; i < 30; ++i) {
+         names.push_back(std::string(section) + ".directive_" + std::to_string(i));
+         missingNames.push_back(std::string(section) + ".unknown_" + std::to_string(i));
+      }
+   }
+   report("config map", names, missingNames);
+}
+
+TEST(HashTableBenchmark, DISABLED_benchSymbolTable)
+{
+   // shaped like the symbol table of a function, a dozen short names
+   std::vector<std::string> names{"i", "j", "count", "result", "value", "key",
+                                  "items", "this", "options", "name", "data", "e"};
+   std::vector<std::string> missingNames{"k", "total", "row", "args", "tmp", "x"};
+   report("symbol table", names, missingNames);
+}
+
+TEST(HashTableBenchmark, DISABLED_benchRecord)
+{
+   // shaped like the records of compact() and get_object_vars()
+   std::vector<std::string> names{"id", "name", "email", "created_at", "updated_at", "status"};
+   std::vector<std::string> missingNames{"deleted_at", "role", "phone", "address"};
+   report("record", names, missingNames);
+}
@@ -225,3 +225,339 @@ TEST(HashTableTest, testGetKeysAndValues)
    ASSERT_EQ(table.getKeys(), expectedKeys);
    ASSERT_EQ(table.getValues(), expectedValues);
 }
+
+namespace {
+
+enum class Layout
+{
+   Chained,
+   Small
+};
+
+const Layout sg_layouts[] = {Layout::Chained, Layout::Small};
+
+HashTable *new_table(Layout layout, uint32_t size = HT_MIN_SIZE)
+{
+   HashTable *ht = zend_new_array(size);
+   if (layout == Layout::Small) {
+      zend_hash_real_init_small(ht);
+   } else {
+      zend_hash_real_init_mixed(ht);
+   }
+   return ht;
+}
+
+std::string key_of(int i)
+{
+   return "key_" + std::to_string(i);
+}
+
+void add_key(HashTable *ht, int i)
+{
+   std::string key = key_of(i);
+   zval value;
+   ZVAL_LONG(&value, i);
+   zend_hash_str_add(ht, key.c_str(), key.size(), &value);
+}
+
+bool has_key(HashTable *ht, int i)
+{
+   std::string key = key_of(i);
+   zval *value = zend_hash_str_find(ht, key.c_str(), key.size());
+   return value && Z_LVAL_P(value) == i;
+}
+
+bool del_key(HashTable *ht, int i)
+{
+   std::string key = key_of(i);
+   return zend_hash_str_del(ht, key.c_str(), key.size()) == SUCCESS;
+}
+
+std::vector<std::string> keys_of(HashTable *ht)
+{
+   std::vector<std::string> keys;
+   zend_string *key;
+   zend_ulong index;
+   ZEND_HASH_FOREACH_KEY(ht, index, key) {
+      keys.push_back(key ? std::string(ZSTR_VAL(key), ZSTR_LEN(key)) : std::to_string(index));
+   } ZEND_HASH_FOREACH_END();
+   return keys;
+}
+
+std::string current_key(HashTable *ht, HashPosition *pos)
+{
+   zend_string *key;
+   zend_ulong index;
+   if (zend_hash_get_current_key_ex(ht, &key, &index, pos) != HASH_KEY_IS_STRING) {
+      return std::string();
+   }
+   return std::string(ZSTR_VAL(key), ZSTR_LEN(key));
+}
+
+} // anonymous namespace
+
+TEST(HashTableTest, testLayouts)
+{
+   HashTable *ht = new_table(Layout::Chained);
+   ASSERT_FALSE(HT_IS_SMALL(ht));
+   zend_array_destroy(ht);
+   ht = new_table(Layout::Small);
+   ASSERT_TRUE(HT_IS_SMALL(ht));
+   // the two slots of a packed table, they stay empty
+   ASSERT_EQ(ht->nTableMask, HT_MIN_MASK);
+   zend_array_destroy(ht);
+   // a bigger table never gets the small layout
+   ht = new_table(Layout::Small, 32);
+   ASSERT_FALSE(HT_IS_SMALL(ht));
+   zend_array_destroy(ht);
+}
+
+TEST(HashTableTest, testLayoutInsertFindDelete)
+{
+   for (Layout layout : sg_layouts) {
+      HashTable *ht = new_table(layout);
+      for (int i = 0; i < 6; ++i) {
+         add_key(ht, i);
+      }
+      zval value;
+      ZVAL_LONG(&value, 100);
+      zend_hash_index_add(ht, 100, &value);
+      ASSERT_EQ(zend_hash_num_elements(ht), 7u);
+      for (int i = 0; i < 6; ++i) {
+         ASSERT_TRUE(has_key(ht, i));
+      }
+      ASSERT_FALSE(has_key(ht, 6));
+      ASSERT_TRUE(zend_hash_index_exists(ht, 100));
+      ASSERT_FALSE(zend_hash_index_exists(ht, 101));
+      // a second add of an existing key fails
+      ASSERT_EQ(zend_hash_str_add(ht, "key_1", 5, &value), nullptr);
+      ASSERT_TRUE(del_key(ht, 1));
+      ASSERT_TRUE(del_key(ht, 5));
+      ASSERT_FALSE(del_key(ht, 5));
+      ASSERT_EQ(zend_hash_index_del(ht, 100), SUCCESS);
+      ASSERT_EQ(zend_hash_num_elements(ht), 4u);
+      ASSERT_FALSE(has_key(ht, 1));
+      ASSERT_FALSE(has_key(ht, 5));
+      ASSERT_FALSE(zend_hash_index_exists(ht, 100));
+      ASSERT_EQ(keys_of(ht), (std::vector<std::string>{"key_0", "key_2", "key_3", "key_4"}));
+      ASSERT_EQ(HT_IS_SMALL(ht), layout == Layout::Small);
+      zend_array_destroy(ht);
+   }
+}
+
+TEST(HashTableTest, testLayoutDeleteAndReinsert)
+{
+   for (Layout layout : sg_layouts) {
+      HashTable *ht = new_table(layout);
+      add_key(ht, 0);
+      add_key(ht, 1);
+      // every round leaves a hole, the table is compacted when it is full
+      for (int round = 0; round < 100; ++round) {
+         ASSERT_TRUE(del_key(ht, 0));
+         ASSERT_FALSE(has_key(ht, 0));
+         add_key(ht, 0);
+         ASSERT_TRUE(has_key(ht, 0));
+         ASSERT_TRUE(has_key(ht, 1));
+         ASSERT_EQ(zend_hash_num_elements(ht), 2u);
+      }
+      ASSERT_EQ(keys_of(ht), (std::vector<std::string>{"key_1", "key_0"}));
+      ASSERT_EQ(HT_IS_SMALL(ht), layout == Layout::Small);
+      zend_array_destroy(ht);
+   }
+}
+
+TEST(HashTableTest, testLayoutClean)
+{
+   for (Layout layout : sg_layouts) {
+      HashTable *ht = new_table(layout);
+      for (int i = 0; i < 5; ++i) {
+         add_key(ht, i);
+      }
+      zend_hash_clean(ht);
+      ASSERT_EQ(zend_hash_num_elements(ht), 0u);
+      ASSERT_FALSE(has_key(ht, 0));
+      ASSERT_EQ(HT_IS_SMALL(ht), layout == Layout::Small);
+      add_key(ht, 3);
+      // the lookups and deletions by zend_string take the same paths
+      zend_string *key = zend_string_init("key_3", 5, 0);
+      zval *value = zend_hash_find(ht, key);
+      ASSERT_TRUE(value && Z_LVAL_P(value) == 3);
+      ASSERT_EQ(zend_hash_del(ht, key), SUCCESS);
+      ASSERT_EQ(zend_hash_find(ht, key), nullptr);
+      ASSERT_EQ(zend_hash_del(ht, key), FAILURE);
+      zend_string_release(key);
+      zend_array_destroy(ht);
+   }
+}
+
+TEST(HashTableTest, testLayoutDiscard)
+{
+   for (Layout layout : sg_layouts) {
+      HashTable *ht = new_table(layout);
+      for (int i = 0; i < 4; ++i) {
+         add_key(ht, i);
+      }
+      uint32_t used = ht->nNumUsed;
+      for (int i = 4; i < 8; ++i) {
+         add_key(ht, i);
+      }
+      ASSERT_TRUE(del_key(ht, 5));
+      zend_hash_discard(ht, used);
+      ASSERT_EQ(zend_hash_num_elements(ht), 4u);
+      for (int i = 0; i < 8; ++i) {
+         ASSERT_EQ(has_key(ht, i), i < 4);
+      }
+      // the discarded keys can be added again
+      add_key(ht, 6);
+      ASSERT_TRUE(has_key(ht, 6));
+      ASSERT_EQ(zend_hash_num_elements(ht), 5u);
+      zend_array_destroy(ht);
+   }
+}
+
+TEST(HashTableTest, testLayoutForeachEndDel)
+{
+   for (Layout layout : sg_layouts) {
+      HashTable *ht = new_table(layout);
+      for (int i = 0; i < 8; ++i) {
+         add_key(ht, i);
+      }
+      ASSERT_TRUE(del_key(ht, 6));
+      zval *value;
+      // drops the elements from the tail down to key_3
+      ZEND_HASH_REVERSE_FOREACH_VAL(ht, value) {
+         if (Z_LVAL_P(value) == 3) {
+            break;
+         }
+      } ZEND_HASH_FOREACH_END_DEL();
+      ASSERT_EQ(zend_hash_num_elements(ht), 4u);
+      for (int i = 0; i < 8; ++i) {
+         ASSERT_EQ(has_key(ht, i), i < 4);
+      }
+      add_key(ht, 7);
+      ASSERT_TRUE(has_key(ht, 7));
+      ASSERT_EQ(keys_of(ht), (std::vector<std::string>{"key_0", "key_1", "key_2", "key_3", "key_7"}));
+      zend_array_destroy(ht);
+   }
+}
+
+TEST(HashTableTest, testLayoutGrowth)
+{
+   for (Layout layout : sg_layouts) {
+      HashTable *ht = new_table(layout);
+      for (int i = 0; i < HT_MIN_SIZE; ++i) {
+         add_key(ht, i);
+      }
+      ASSERT_EQ(HT_IS_SMALL(ht), layout == Layout::Small);
+      for (int i = HT_MIN_SIZE; i < 100; ++i) {
+         add_key(ht, i);
+      }
+      // a small table grows into the chained layout
+      ASSERT_FALSE(HT_IS_SMALL(ht));
+      for (int i = 0; i < 100; ++i) {
+         ASSERT_TRUE(has_key(ht, i));
+      }
+      ASSERT_FALSE(has_key(ht, 100));
+      for (int i = 0; i < 100; i += 2) {
+         ASSERT_TRUE(del_key(ht, i));
+      }
+      ASSERT_EQ(zend_hash_rehash(ht), SUCCESS);
+      ASSERT_EQ(ht->nNumUsed, 50u);
+      for (int i = 0; i < 100; ++i) {
+         ASSERT_EQ(has_key(ht, i), i % 2 == 1);
+      }
+      zend_array_destroy(ht);
+   }
+}
+
+TEST(HashTableTest, testLayoutDup)
+{
+   for (Layout layout : sg_layouts) {
+      HashTable *source = new_table(layout);
+      for (int i = 0; i < 6; ++i) {
+         add_key(source, i);
+      }
+      ASSERT_TRUE(del_key(source, 2));
+      HashTable *target = zend_array_dup(source);
+      ASSERT_EQ(HT_IS_SMALL(target), layout == Layout::Small);
+      ASSERT_EQ(zend_hash_num_elements(target), 5u);
+      for (int i = 0; i < 6; ++i) {
+         ASSERT_EQ(has_key(target, i), i != 2);
+      }
+      ASSERT_EQ(keys_of(target), keys_of(source));
+      // the copy is independent of its source
+      add_key(target, 2);
+      ASSERT_TRUE(del_key(target, 0));
+      ASSERT_TRUE(has_key(source, 0));
+      ASSERT_FALSE(has_key(source, 2));
+      ASSERT_TRUE(has_key(target, 2));
+      zend_array_destroy(target);
+      // an empty copy falls back to a lazily initialized chained table
+      HashTable *empty = new_table(layout);
+      target = zend_array_dup(empty);
+      add_key(target, 0);
+      ASSERT_FALSE(HT_IS_SMALL(target));
+      ASSERT_TRUE(has_key(target, 0));
+      zend_array_destroy(target);
+      zend_array_destroy(empty);
+      zend_array_destroy(source);
+   }
+}
+
+TEST(HashTableTest, testLayoutIntAndStringKeyWithSameHash)
+{
+   for (Layout layout : sg_layouts) {
+      HashTable *ht = new_table(layout);
+      zend_string *key = zend_string_init("shared", sizeof("shared") - 1, 0);
+      zend_ulong h = zend_string_hash_val(key);
+      zval value;
+      ZVAL_LONG(&value, 1);
+      zend_hash_add(ht, key, &value);
+      ZVAL_LONG(&value, 2);
+      zend_hash_index_add(ht, h, &value);
+      ASSERT_EQ(zend_hash_num_elements(ht), 2u);
+      ASSERT_EQ(Z_LVAL_P(zend_hash_find(ht, key)), 1);
+      ASSERT_EQ(Z_LVAL_P(zend_hash_index_find(ht, h)), 2);
+      ASSERT_EQ(zend_hash_index_del(ht, h), SUCCESS);
+      ASSERT_EQ(zend_hash_index_find(ht, h), nullptr);
+      ASSERT_EQ(Z_LVAL_P(zend_hash_find(ht, key)), 1);
+      ZVAL_LONG(&value, 3);
+      zend_hash_index_add(ht, h, &value);
+      ASSERT_EQ(zend_hash_del(ht, key), SUCCESS);
+      ASSERT_EQ(zend_hash_find(ht, key), nullptr);
+      ASSERT_EQ(Z_LVAL_P(zend_hash_index_find(ht, h)), 3);
+      zend_string_release(key);
+      zend_array_destroy(ht);
+   }
+}
+
+TEST(HashTableTest, testLayoutPositionsAcrossRehash)
+{
+   for (Layout layout : sg_layouts) {
+      HashTable *ht = new_table(layout);
+      for (int i = 0; i < HT_MIN_SIZE; ++i) {
+         add_key(ht, i);
+      }
+      for (int i = 0; i < 4; ++i) {
+         ASSERT_TRUE(del_key(ht, i));
+      }
+      // the internal pointer on key_6, an iterator on key_5
+      zend_hash_internal_pointer_reset(ht);
+      zend_hash_move_forward(ht);
+      zend_hash_move_forward(ht);
+      HashPosition pos;
+      zend_hash_internal_pointer_reset_ex(ht, &pos);
+      zend_hash_move_forward_ex(ht, &pos);
+      uint32_t iterator = zend_hash_iterator_add(ht, pos);
+      ASSERT_EQ(current_key(ht, &pos), "key_5");
+      // the table is full, the next add compacts it
+      add_key(ht, 8);
+      ASSERT_EQ(ht->nNumUsed, 5u);
+      ASSERT_EQ(current_key(ht, &ht->nInternalPointer), "key_6");
+      pos = zend_hash_iterator_pos(iterator, ht);
+      ASSERT_EQ(current_key(ht, &pos), "key_5");
+      ASSERT_EQ(keys_of(ht), (std::vector<std::string>{"key_4", "key_5", "key_6", "key_7", "key_8"}));
+      zend_hash_iterator_del(iterator);
+      zend_array_destroy(ht);
+   }
+}
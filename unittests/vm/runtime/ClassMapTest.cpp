@@ -0,0 +1,225 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 polarboy <polarboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "polarphp/vm/ZendApi.h"
+#include "polarphp/runtime/langsupport/ClassMap.h"
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using polar::runtime::ClassMap;
+using polar::basic::StringRef;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::vector<std::string> extract(const char *source)
+{
+   std::vector<std::string> names;
+   ClassMap::extractClassNames(source, names);
+   return names;
+}
+
+void write_file(const fs::path &path, const std::string &code)
+{
+   std::ofstream(path) << code;
+}
+
+} // anonymous namespace
+
+TEST(ClassMapTest, testExtractDeclarations)
+{
+   std::vector<std::string> names = extract("<?php\n"
+                                            "class Foo {}\n"
+                                            "interface Bar {}\n"
+                                            "TRAIT Baz {}\n"
+                                            "final class Qux extends Foo implements Bar {}\n");
+   ASSERT_EQ(names, (std::vector<std::string>{"Foo", "Bar", "Baz", "Qux"}));
+   ASSERT_TRUE(extract("no php tag class Foo {}").empty());
+   ASSERT_TRUE(extract("").empty());
+}
+
+TEST(ClassMapTest, testExtractNamespaces)
+{
+   std::vector<std::string> names = extract("<?php\n"
+                                            "namespace App\\Model;\n"
+                                            "class User {}\n"
+                                            "namespace App\\Http {\n"
+                                            "   class Request {}\n"
+                                            "}\n");
+   ASSERT_EQ(names, (std::vector<std::string>{"App\\Model\\User", "App\\Http\\Request"}));
+   // namespace\foo() is a call relative to the current namespace, not a declaration
+   names = extract("<?php\n"
+                   "namespace App;\n"
+                   "namespace\\helper();\n"
+                   "class Kernel {}\n");
+   ASSERT_EQ(names, (std::vector<std::string>{"App\\Kernel"}));
+}
+
+TEST(ClassMapTest, testExtractSkipsNonDeclarations)
+{
+   std::vector<std::string> names = extract("<?php\n"
+                                            "$name = Foo::class;\n"
+                                            "$object = new class {};\n"
+                                            "$value = $node->class;\n"
+                                            "// class InComment {}\n"
+                                            "# class InHashComment {}\n"
+                                            "/* class InBlockComment {} */\n"
+                                            "$text = 'class InSingleQuoted {}';\n"
+                                            "$text = \"class InDoubleQuoted {}\";\n"
+                                            "$text = <<<EOT\n"
+                                            "class InHeredoc {}\n"
+                                            "EOT;\n"
+                                            "$text = <<<'EOT'\n"
+                                            "class InNowdoc {}\n"
+                                            "EOT;\n"
+                                            "class Real {}\n");
+   ASSERT_EQ(names, (std::vector<std::string>{"Real"}));
+}
+
+TEST(ClassMapTest, testExtractInlineHtml)
+{
+   std::vector<std::string> names = extract("<html>class NotPhp {}</html>\n"
+                                            "<?php class First {} ?>\n"
+                                            "class StillHtml {}\n"
+                                            "<?PHP class Second {}");
+   ASSERT_EQ(names, (std::vector<std::string>{"First", "Second"}));
+}
+
+TEST(ClassMapTest, testBuildAndReuse)
+{
+   fs::path root = fs::temp_directory_path() / "polar_class_map_test";
+   fs::remove_all(root);
+   fs::create_directories(root / "sub" / "deep");
+   write_file(root / "a.php", "<?php class Alpha {} class Beta {}");
+   write_file(root / "sub" / "c.php", "<?php namespace Sub; class Gamma {}");
+   // a second declaration of Alpha is not indexed nor counted
+   write_file(root / "sub" / "deep" / "d.php", "<?php class Alpha {} class Delta {}");
+   write_file(root / "sub" / "ignored.txt", "<?php class Ignored {}");
+   // the index lives outside of the root, writing it must not touch an indexed mtime
+   std::string indexPath = (fs::temp_directory_path() / "polar_class_map_test.idx").string();
+   std::vector<std::string> roots{root.string()};
+   std::vector<std::string> extensions{".php"};
+   ASSERT_EQ(ClassMap::build(indexPath, roots, extensions), 4);
+   // nothing changed, every directory is reused from the previous index
+   ASSERT_EQ(ClassMap::build(indexPath, roots, extensions), 4);
+   std::unique_ptr<ClassMap> classMap = ClassMap::open(indexPath);
+   ASSERT_TRUE(classMap != nullptr);
+   ASSERT_EQ(classMap->getClassCount(), 4u);
+   ASSERT_EQ(classMap->getDirCount(), 3u);
+   ASSERT_FALSE(classMap->isStale());
+   StringRef filename;
+   ASSERT_TRUE(classMap->lookup("alpha", filename));
+   ASSERT_EQ(filename.getStr(), (root / "a.php").string());
+   ASSERT_TRUE(classMap->lookup("sub\\gamma", filename));
+   ASSERT_EQ(filename.getStr(), (root / "sub" / "c.php").string());
+   ASSERT_TRUE(classMap->lookup("delta", filename));
+   ASSERT_EQ(filename.getStr(), (root / "sub" / "deep" / "d.php").string());
+   ASSERT_FALSE(classMap->lookup("ignored", filename));
+   classMap.reset();
+   fs::remove(indexPath);
+   fs::remove_all(root);
+}
+
+TEST(ClassMapTest, testFileEditedInPlace)
+{
+   fs::path root = fs::temp_directory_path() / "polar_class_map_edit_test";
+   fs::remove_all(root);
+   fs::create_directories(root);
+   write_file(root / "a.php", "<?php class Alpha {}");
+   write_file(root / "empty.php", "<?php echo 1;");
+   std::string indexPath = (fs::temp_directory_path() / "polar_class_map_edit_test.idx").string();
+   std::vector<std::string> roots{root.string()};
+   std::vector<std::string> extensions{".php"};
+   ASSERT_EQ(ClassMap::build(indexPath, roots, extensions), 1);
+   int64_t dirMtime = ClassMap::open(indexPath)->getDirMtime(0);
+   // rewriting existing files leaves the mtime of the directory as is
+   write_file(root / "a.php", "<?php class Renamed {}");
+   write_file(root / "empty.php", "<?php class NowDeclared {}");
+   std::unique_ptr<ClassMap> classMap = ClassMap::open(indexPath);
+   ASSERT_EQ(classMap->getFileCount(), 2u);
+   ASSERT_TRUE(classMap->isStale());
+   classMap.reset();
+   ASSERT_EQ(ClassMap::build(indexPath, roots, extensions), 2);
+   classMap = ClassMap::open(indexPath);
+   ASSERT_EQ(classMap->getDirMtime(0), dirMtime);
+   ASSERT_FALSE(classMap->isStale());
+   StringRef filename;
+   ASSERT_FALSE(classMap->lookup("alpha", filename));
+   ASSERT_TRUE(classMap->lookup("renamed", filename));
+   ASSERT_TRUE(classMap->lookup("nowdeclared", filename));
+   ASSERT_EQ(filename.getStr(), (root / "empty.php").string());
+   classMap.reset();
+   fs::remove(indexPath);
+   fs::remove_all(root);
+}
+
+TEST(ClassMapTest, testCorruptIndex)
+{
+   fs::path root = fs::temp_directory_path() / "polar_class_map_corrupt_test";
+   fs::remove_all(root);
+   fs::create_directories(root);
+   write_file(root / "a.php", "<?php class Alpha {} class Beta {}");
+   std::string indexPath = (fs::temp_directory_path() / "polar_class_map_corrupt_test.idx").string();
+   std::vector<std::string> roots{root.string()};
+   std::vector<std::string> extensions{".php"};
+   ASSERT_EQ(ClassMap::build(indexPath, roots, extensions), 2);
+   std::string content;
+   {
+      std::ifstream input(indexPath, std::ios::binary);
+      content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+   }
+   auto write_index = [&](const std::string &data) {
+      std::ofstream(indexPath, std::ios::binary | std::ios::trunc) << data;
+   };
+   ASSERT_TRUE(ClassMap::open(indexPath) != nullptr);
+   // truncated
+   write_index(content.substr(0, content.size() - 1));
+   ASSERT_TRUE(ClassMap::open(indexPath) == nullptr);
+   write_index(content.substr(0, sizeof(ClassMap::ClassMapHeader) - 1));
+   ASSERT_TRUE(ClassMap::open(indexPath) == nullptr);
+   // a file path past the string pool
+   size_t filesOffset = sizeof(ClassMap::ClassMapHeader) + sizeof(ClassMap::ClassMapDir);
+   std::string corrupt = content;
+   ClassMap::ClassMapFile file;
+   memcpy(&file, corrupt.data() + filesOffset, sizeof(file));
+   file.pathOffset = 0xfffffff0u;
+   memcpy(&corrupt[filesOffset], &file, sizeof(file));
+   write_index(corrupt);
+   ASSERT_TRUE(ClassMap::open(indexPath) == nullptr);
+   // an entry pointing to a missing file
+   size_t entriesOffset = filesOffset + sizeof(ClassMap::ClassMapFile);
+   corrupt = content;
+   ClassMap::ClassMapEntry entry;
+   memcpy(&entry, corrupt.data() + entriesOffset, sizeof(entry));
+   entry.fileIndex = 7;
+   memcpy(&corrupt[entriesOffset], &entry, sizeof(entry));
+   write_index(corrupt);
+   ASSERT_TRUE(ClassMap::open(indexPath) == nullptr);
+   // a bucket past the entries
+   size_t bucketsOffset = entriesOffset + 2 * sizeof(ClassMap::ClassMapEntry);
+   corrupt = content;
+   uint32_t bucket = 100;
+   memcpy(&corrupt[bucketsOffset], &bucket, sizeof(bucket));
+   write_index(corrupt);
+   ASSERT_TRUE(ClassMap::open(indexPath) == nullptr);
+   // a broken index is rebuilt
+   ASSERT_EQ(ClassMap::build(indexPath, roots, extensions), 2);
+   ASSERT_TRUE(ClassMap::open(indexPath) != nullptr);
+   fs::remove(indexPath);
+   fs::remove_all(root);
+}
@@ -0,0 +1,248 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 polarboy <polarboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "polarphp/vm/ZendApi.h"
+#include "polarphp/runtime/IniCache.h"
+
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using polar::runtime::IniCache;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using Records = std::vector<std::string>;
+
+void collect_callback(zval *arg1, zval *arg2, zval *arg3, int callbackType, void *arg)
+{
+   std::string record = std::to_string(callbackType);
+   for (zval *value : {arg1, arg2, arg3}) {
+      record += "|";
+      record += value ? std::string(Z_STRVAL_P(value), Z_STRLEN_P(value)) : std::string("-");
+   }
+   reinterpret_cast<Records *>(arg)->push_back(record);
+}
+
+/// the callbacks of \p path, parsed through \p cache
+Records parse_file(IniCache &cache, const fs::path &path)
+{
+   Records records;
+   std::string filename = path.string();
+   zend_file_handle fh;
+   memset(&fh, 0, sizeof(fh));
+   fh.type = ZEND_HANDLE_FP;
+   fh.handle.fp = fopen(filename.c_str(), "r");
+   fh.filename = filename.c_str();
+   EXPECT_TRUE(fh.handle.fp != nullptr) << filename;
+   EXPECT_EQ(cache.parseFile(&fh, collect_callback, &records), SUCCESS) << filename;
+   return records;
+}
+
+/// the callbacks of \p path without a cache
+Records parse_fresh(const fs::path &path)
+{
+   IniCache noCache("");
+   return parse_file(noCache, path);
+}
+
+void write_file(const fs::path &path, const std::string &content)
+{
+   std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+}
+
+std::string read_file(const fs::path &path)
+{
+   std::ifstream input(path, std::ios::binary);
+   return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+/// replace the content of \p path keeping its size and mtime, a cache hit
+/// still replays the old content
+void rewrite_keep_stat(const fs::path &path, const std::string &content)
+{
+   fs::file_time_type mtime = fs::last_write_time(path);
+   ASSERT_EQ(fs::file_size(path), content.size());
+   write_file(path, content);
+   fs::last_write_time(path, mtime);
+}
+
+void touch_later(const fs::path &path)
+{
+   fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(10));
+}
+
+class IniCacheTest : public ::testing::Test
+{
+protected:
+   void SetUp() override
+   {
+      m_root = fs::temp_directory_path() / "polar_ini_cache_test";
+      fs::remove_all(m_root);
+      fs::create_directories(m_root / "conf.d");
+      m_cacheFile = (m_root / "ini.cache").string();
+      m_phpIni = m_root / "php.ini";
+      write_file(m_phpIni,
+                 "memory_limit = 128M\n"
+                 "error_reporting = E_ALL & ~E_NOTICE\n"
+                 "extension = first\n"
+                 "extension = second\n"
+                 "list[] = one\n"
+                 "list[key] = two\n"
+                 "quoted = \"a b ; c\"\n"
+                 "[PATH=/srv/www]\n"
+                 "display_errors = Off\n"
+                 "[HOST=example.org]\n"
+                 "max_execution_time = 5\n");
+   }
+
+   void TearDown() override
+   {
+      fs::remove_all(m_root);
+   }
+
+   fs::path m_root;
+   std::string m_cacheFile;
+   fs::path m_phpIni;
+};
+
+} // anonymous namespace
+
+TEST_F(IniCacheTest, testHitMatchesParse)
+{
+   Records fresh = parse_fresh(m_phpIni);
+   ASSERT_FALSE(fresh.empty());
+   {
+      IniCache cache(m_cacheFile);
+      ASSERT_EQ(parse_file(cache, m_phpIni), fresh);
+      ASSERT_TRUE(cache.save());
+   }
+   ASSERT_TRUE(fs::exists(m_cacheFile));
+   // the same size and mtime, the records come from the cache
+   std::string content = read_file(m_phpIni);
+   std::string changed = content;
+   changed.replace(changed.find("128M"), 4, "256M");
+   rewrite_keep_stat(m_phpIni, changed);
+   IniCache cache(m_cacheFile);
+   ASSERT_EQ(parse_file(cache, m_phpIni), fresh);
+   ASSERT_NE(parse_fresh(m_phpIni), fresh);
+}
+
+TEST_F(IniCacheTest, testInvalidation)
+{
+   fs::path scanned = m_root / "conf.d" / "10-scanned.ini";
+   fs::path other = m_root / "conf.d" / "20-other.ini";
+   write_file(scanned, "scanned = 1\n");
+   write_file(other, "other = 1\n");
+   {
+      IniCache cache(m_cacheFile);
+      parse_file(cache, m_phpIni);
+      parse_file(cache, scanned);
+      parse_file(cache, other);
+      ASSERT_TRUE(cache.save());
+   }
+   // php.ini grows, the scanned files are still replayed
+   write_file(m_phpIni, read_file(m_phpIni) + "added = 1\n");
+   rewrite_keep_stat(other, "other = 2\n");
+   {
+      IniCache cache(m_cacheFile);
+      ASSERT_EQ(parse_file(cache, m_phpIni), parse_fresh(m_phpIni));
+      ASSERT_EQ(parse_file(cache, scanned), parse_fresh(scanned));
+      Records records = parse_file(cache, other);
+      ASSERT_EQ(records, Records{"1|other|1|-"});
+      ASSERT_TRUE(cache.save());
+   }
+   // a scanned file keeping its size gets a new mtime
+   rewrite_keep_stat(scanned, "scanned = 2\n");
+   touch_later(scanned);
+   {
+      IniCache cache(m_cacheFile);
+      ASSERT_EQ(parse_file(cache, scanned), Records{"1|scanned|2|-"});
+      ASSERT_EQ(parse_file(cache, other), Records{"1|other|1|-"});
+      ASSERT_TRUE(cache.save());
+   }
+   // a file left out of the scan is dropped by the next save that writes
+   fs::path added = m_root / "conf.d" / "30-added.ini";
+   write_file(added, "added = 1\n");
+   {
+      IniCache cache(m_cacheFile);
+      parse_file(cache, m_phpIni);
+      parse_file(cache, scanned);
+      parse_file(cache, added);
+      ASSERT_TRUE(cache.save());
+   }
+   IniCache cache(m_cacheFile);
+   ASSERT_EQ(parse_file(cache, other), Records{"1|other|2|-"});
+}
+
+TEST_F(IniCacheTest, testEnvironmentIsNotCached)
+{
+   fs::path scanned = m_root / "conf.d" / "env.ini";
+   write_file(scanned, "from_env = ${POLAR_INI_CACHE_TEST_VALUE}\n");
+   setenv("POLAR_INI_CACHE_TEST_VALUE", "first", 1);
+   {
+      IniCache cache(m_cacheFile);
+      ASSERT_EQ(parse_file(cache, scanned), Records{"1|from_env|first|-"});
+      ASSERT_TRUE(cache.save());
+   }
+   setenv("POLAR_INI_CACHE_TEST_VALUE", "second", 1);
+   IniCache cache(m_cacheFile);
+   ASSERT_EQ(parse_file(cache, scanned), Records{"1|from_env|second|-"});
+   unsetenv("POLAR_INI_CACHE_TEST_VALUE");
+}
+
+TEST_F(IniCacheTest, testCorruptCacheFallsBackToParse)
+{
+   Records fresh = parse_fresh(m_phpIni);
+   {
+      IniCache cache(m_cacheFile);
+      parse_file(cache, m_phpIni);
+      ASSERT_TRUE(cache.save());
+   }
+   std::string valid = read_file(m_cacheFile);
+   std::string huge = valid;
+   // the length of the build string
+   huge[8] = '\xff';
+   huge[11] = '\x7f';
+   std::string badMagic = valid;
+   badMagic[0] = 'X';
+   std::string badVersion = valid;
+   badVersion[4] ^= 1;
+   std::vector<std::string> corruptions{
+      "", "PINC", "garbage that is not a cache", badMagic, badVersion, huge,
+      valid.substr(0, valid.size() - 1), valid + "trailing"
+   };
+   // the stale content would come back from a valid cache
+   std::string content = read_file(m_phpIni);
+   std::string changed = content;
+   changed.replace(changed.find("128M"), 4, "512M");
+   rewrite_keep_stat(m_phpIni, changed);
+   Records changedFresh = parse_fresh(m_phpIni);
+   ASSERT_NE(changedFresh, fresh);
+   for (const std::string &corruption : corruptions) {
+      write_file(m_cacheFile, corruption);
+      IniCache cache(m_cacheFile);
+      ASSERT_EQ(parse_file(cache, m_phpIni), changedFresh) << corruption.size();
+      // the parse writes a valid cache again
+      ASSERT_TRUE(cache.save());
+      IniCache reloaded(m_cacheFile);
+      ASSERT_EQ(parse_file(reloaded, m_phpIni), changedFresh);
+   }
+}
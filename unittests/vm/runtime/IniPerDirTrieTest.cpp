@@ -0,0 +1,204 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 polarboy <polarboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "polarphp/vm/ZendApi.h"
+#include "polarphp/runtime/IniPerDirTrie.h"
+
+#include "gtest/gtest.h"
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using polar::runtime::IniPerDirTrie;
+
+namespace {
+
+using Applied = std::map<std::string, std::string>;
+
+///
+/// The PATH sections keyed like the configuration hash, with the trie
+/// built over them.
+///
+class PerDirConfig
+{
+public:
+   ~PerDirConfig()
+   {
+      for (auto &item : m_sections) {
+         zend_array_destroy(item.second);
+      }
+   }
+
+   void addSection(const std::string &key, std::initializer_list<std::pair<const char *, const char *>> settings)
+   {
+      HashTable *&section = m_sections[key];
+      if (!section) {
+         section = zend_new_array(0);
+      }
+      for (auto &setting : settings) {
+         zval value;
+         ZVAL_STRING(&value, setting.second);
+         zend_hash_str_update(section, setting.first, strlen(setting.first), &value);
+      }
+      m_keys.push_back(key);
+   }
+
+   void build()
+   {
+      for (const std::string &key : m_keys) {
+         m_trie.addSection(key, m_sections[key]);
+      }
+      m_trie.build();
+   }
+
+   Applied lookup(const std::string &path) const
+   {
+      Applied applied;
+      const IniPerDirTrie::Settings *settings = m_trie.lookup(path);
+      if (settings) {
+         for (auto &setting : *settings) {
+            applied[ZSTR_VAL(setting.first)] = ZSTR_VAL(setting.second);
+         }
+      }
+      return applied;
+   }
+
+   /// the walk the trie replaced: every leading directory of the path is
+   /// looked up in the configuration hash and its section applied in turn
+   Applied linearWalk(const std::string &path) const
+   {
+      Applied applied;
+      size_t slash = 0;
+      while ((slash = path.find('/', slash + 1)) != std::string::npos) {
+         auto iter = m_sections.find(path.substr(0, slash));
+         if (iter == m_sections.end()) {
+            continue;
+         }
+         zend_string *name;
+         zval *value;
+         ZEND_HASH_FOREACH_STR_KEY_VAL(iter->second, name, value) {
+            applied[ZSTR_VAL(name)] = Z_STRVAL_P(value);
+         } ZEND_HASH_FOREACH_END();
+      }
+      return applied;
+   }
+
+private:
+   std::map<std::string, HashTable *> m_sections;
+   std::vector<std::string> m_keys;
+   IniPerDirTrie m_trie;
+};
+
+} // anonymous namespace
+
+TEST(IniPerDirTrieTest, testNestedSections)
+{
+   PerDirConfig config;
+   config.addSection("/srv", {{"memory_limit", "64M"}, {"display_errors", "0"}});
+   config.addSection("/srv/www", {{"memory_limit", "128M"}});
+   config.addSection("/srv/www/app/admin", {{"display_errors", "1"}, {"max_execution_time", "5"}});
+   config.addSection("/srv/www", {{"precision", "10"}});
+   config.build();
+   ASSERT_EQ(config.lookup("/srv/index.php"), (Applied{{"memory_limit", "64M"}, {"display_errors", "0"}}));
+   ASSERT_EQ(config.lookup("/srv/www/index.php"),
+             (Applied{{"memory_limit", "128M"}, {"display_errors", "0"}, {"precision", "10"}}));
+   // app has no section of its own, the one of www applies
+   ASSERT_EQ(config.lookup("/srv/www/app/index.php"), config.lookup("/srv/www/index.php"));
+   Applied admin{{"memory_limit", "128M"}, {"display_errors", "1"}, {"precision", "10"},
+                 {"max_execution_time", "5"}};
+   ASSERT_EQ(config.lookup("/srv/www/app/admin/index.php"), admin);
+   ASSERT_EQ(config.lookup("/srv/www/app/admin/deep/er/index.php"), admin);
+   ASSERT_TRUE(config.lookup("/index.php").empty());
+   ASSERT_TRUE(config.lookup("/var/www/index.php").empty());
+   for (const char *path : {"/srv/index.php", "/srv/www/index.php", "/srv/www/app/index.php",
+        "/srv/www/app/admin/index.php", "/srv/www/app/admin/deep/er/index.php", "/srv/other/index.php",
+        "/index.php", "/srv", "/srv/", "srv/www/index.php"}) {
+      ASSERT_EQ(config.lookup(path), config.linearWalk(path)) << path;
+   }
+}
+
+TEST(IniPerDirTrieTest, testPrefixOnlyMatches)
+{
+   PerDirConfig config;
+   config.addSection("/a/b", {{"precision", "3"}});
+   config.build();
+   Applied matched{{"precision", "3"}};
+   ASSERT_EQ(config.lookup("/a/b/x.php"), matched);
+   ASSERT_EQ(config.lookup("/a/b/c/x.php"), matched);
+   ASSERT_EQ(config.lookup("/a/b/"), matched);
+   // a directory name starting with the one of the section
+   ASSERT_TRUE(config.lookup("/a/bc/x.php").empty());
+   ASSERT_TRUE(config.lookup("/a/bc").empty());
+   // the section directory itself names no file inside it
+   ASSERT_TRUE(config.lookup("/a/b").empty());
+   ASSERT_TRUE(config.lookup("/a/x.php").empty());
+   ASSERT_TRUE(config.lookup("/ab/x.php").empty());
+   for (const char *path : {"/a/b/x.php", "/a/b/c/x.php", "/a/b/", "/a/bc/x.php", "/a/bc", "/a/b",
+        "/a/x.php", "/ab/x.php", "/a/b.php"}) {
+      ASSERT_EQ(config.lookup(path), config.linearWalk(path)) << path;
+   }
+}
+
+TEST(IniPerDirTrieTest, testSlashes)
+{
+   PerDirConfig config;
+   // [PATH=/] and [PATH=/a/] are stored as "" and "/a" by the ini parser
+   config.addSection("", {{"root", "1"}});
+   config.addSection("/a", {{"a", "1"}});
+   config.addSection("/a//b", {{"double", "1"}});
+   config.addSection("rel/dir", {{"relative", "1"}});
+   config.build();
+   ASSERT_EQ(config.lookup("/a/x.php"), (Applied{{"a", "1"}}));
+   ASSERT_EQ(config.lookup("/a//b/x.php"), (Applied{{"a", "1"}, {"double", "1"}}));
+   ASSERT_EQ(config.lookup("/a/b/x.php"), (Applied{{"a", "1"}}));
+   ASSERT_EQ(config.lookup("rel/dir/x.php"), (Applied{{"relative", "1"}}));
+   // the empty key matches no path
+   ASSERT_TRUE(config.lookup("/x.php").empty());
+   ASSERT_TRUE(config.lookup("//x.php").empty());
+   for (const char *path : {"/a/x.php", "/a//b/x.php", "/a/b/x.php", "/a/", "/a//", "//a/x.php",
+        "/a///b/x.php", "rel/dir/x.php", "/rel/dir/x.php", "/x.php", "//x.php", "/", "//", "x"}) {
+      ASSERT_EQ(config.lookup(path), config.linearWalk(path)) << path;
+   }
+}
+
+TEST(IniPerDirTrieTest, testRandomAgainstLinearWalk)
+{
+   const std::vector<std::string> components{"a", "b", "ab", "ba", "", "a.b"};
+   std::mt19937 generator(2019);
+   auto random_path = [&](size_t maxDepth) {
+      std::string path;
+      size_t depth = generator() % (maxDepth + 1);
+      for (size_t i = 0; i < depth; ++i) {
+         path += "/" + components[generator() % components.size()];
+      }
+      return path;
+   };
+   PerDirConfig config;
+   const char *names[] = {"s1", "s2", "s3"};
+   for (int i = 0; i < 40; ++i) {
+      std::string key = random_path(4);
+      // the ini parser strips the trailing slashes of a key
+      while (!key.empty() && key.back() == '/') {
+         key.pop_back();
+      }
+      std::string value = std::to_string(i);
+      config.addSection(key, {{names[generator() % 3], value.c_str()}});
+   }
+   config.build();
+   for (int i = 0; i < 5000; ++i) {
+      std::string path = random_path(6) + (generator() % 4 ? "/x.php" : "");
+      ASSERT_EQ(config.lookup(path), config.linearWalk(path)) << path;
+   }
+}
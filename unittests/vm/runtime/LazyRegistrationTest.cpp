@@ -0,0 +1,109 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 polarboy <polarboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "polarphp/vm/ZendApi.h"
+#include "polarphp/vm/lang/Module.h"
+#include "polarphp/vm/lang/Class.h"
+#include "polarphp/vm/ds/Variant.h"
+#include "polarphp/vm/StdClass.h"
+#include "polarphp/runtime/RtDefs.h"
+#include "polarphp/runtime/RequestExecutor.h"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+#ifdef ZTS
+
+using polar::vmapi::Class;
+using polar::vmapi::Module;
+using polar::vmapi::StdClass;
+using polar::vmapi::Variant;
+using polar::runtime::RequestExecutor;
+
+namespace {
+
+class RaceShape : public StdClass
+{};
+
+class RaceCircle : public RaceShape
+{};
+
+Variant race_name()
+{
+   return "race";
+}
+
+bool register_race_module()
+{
+   static Module raceModule("lazyrace", "1.0");
+   raceModule.setLazyRegistration();
+   raceModule.registerFunction<decltype(race_name), race_name>("lazy_race_name");
+   Class<RaceShape> shape("LazyRaceShape");
+   Class<RaceCircle> circle("LazyRaceCircle");
+   circle.registerBaseClass(shape);
+   raceModule.registerClass(shape);
+   raceModule.registerClass(circle);
+   return raceModule.registerToVM();
+}
+
+/// the hook must be in place before TestEntry.cpp boots the vm
+const bool sg_raceModuleHooked = (polar::runtime::sg_vmExtensionInitHook = register_race_module, true);
+
+} // anonymous namespace
+
+TEST(LazyRegistrationTest, testConcurrentMaterialization)
+{
+   ASSERT_TRUE(sg_raceModuleHooked);
+   constexpr size_t threadCount = 4;
+   constexpr size_t jobCount = 16;
+   std::atomic<size_t> arrived(0);
+   std::vector<zend_class_entry *> classes(jobCount, nullptr);
+   std::vector<zend_function *> functions(jobCount, nullptr);
+   std::vector<std::future<int>> statuses;
+   {
+      RequestExecutor executor(threadCount);
+      for (size_t i = 0; i < jobCount; ++i) {
+         statuses.push_back(executor.submit([i, &arrived, &classes, &functions]() {
+            // the first job of every worker waits for the others, so the
+            // lookups of the same names start together
+            ++arrived;
+            while (arrived.load() < threadCount) {
+               std::this_thread::yield();
+            }
+            zend_string *className = zend_string_init("LazyRaceCircle", sizeof("LazyRaceCircle") - 1, 0);
+            classes[i] = zend_lookup_class_ex(className, nullptr, 0);
+            zend_string_release(className);
+            zend_string *funcName = zend_string_init("lazy_race_name", sizeof("lazy_race_name") - 1, 0);
+            functions[i] = zend_fetch_function(funcName);
+            zend_string_release(funcName);
+            return 0;
+         }));
+      }
+      executor.wait();
+   }
+   for (std::future<int> &status : statuses) {
+      ASSERT_EQ(status.get(), 0);
+   }
+   ASSERT_TRUE(classes[0] != nullptr);
+   ASSERT_TRUE(classes[0]->parent != nullptr);
+   ASSERT_STREQ(ZSTR_VAL(classes[0]->parent->name), "LazyRaceShape");
+   for (size_t i = 0; i < jobCount; ++i) {
+      // the class entry is shared, the function is registered once per thread
+      ASSERT_EQ(classes[i], classes[0]);
+      ASSERT_TRUE(functions[i] != nullptr);
+      ASSERT_EQ(functions[i]->type, ZEND_INTERNAL_FUNCTION);
+   }
+}
+
+#endif // ZTS
@@ -0,0 +1,90 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 polarboy <polarboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "polarphp/vm/ZendApi.h"
+#include "polarphp/runtime/RequestExecutor.h"
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef ZTS
+
+using polar::runtime::RequestExecutor;
+
+namespace fs = std::filesystem;
+
+TEST(RequestExecutorTest, testJobStatuses)
+{
+   fs::path script = fs::temp_directory_path() / "polar_executor_job.php";
+   std::ofstream(script) << "<?php\nexit(5);\n";
+   std::atomic<int> ranCount(0);
+   {
+      RequestExecutor executor(2);
+      ASSERT_EQ(executor.getThreadCount(), 2u);
+      std::vector<std::future<int>> statuses;
+      for (int i = 0; i < 8; ++i) {
+         statuses.push_back(executor.submit([i, &ranCount]() {
+            ++ranCount;
+            return i;
+         }));
+      }
+      // a bailout ends the job with the exit status of the request
+      std::future<int> bailout = executor.submit([]() {
+         EG(exit_status) = 7;
+         zend_bailout();
+         return 0;
+      });
+      // a C++ exception reaches the future instead of terminating the worker
+      std::future<int> thrown = executor.submit([]() -> int {
+         throw std::runtime_error("job failed");
+      });
+      std::future<int> scriptStatus = executor.submitScript(script.string());
+      for (int i = 0; i < 8; ++i) {
+         ASSERT_EQ(statuses[i].get(), i);
+      }
+      ASSERT_EQ(bailout.get(), 7);
+      ASSERT_THROW(thrown.get(), std::runtime_error);
+      ASSERT_EQ(scriptStatus.get(), 5);
+      // the workers still serve jobs after the failures
+      std::future<int> after = executor.submit([]() { return 42; });
+      executor.wait();
+      ASSERT_EQ(after.get(), 42);
+   }
+   ASSERT_EQ(ranCount.load(), 8);
+   fs::remove(script);
+}
+
+TEST(RequestExecutorTest, testShutdownRunsQueuedJobs)
+{
+   std::atomic<int> ranCount(0);
+   std::vector<std::future<int>> statuses;
+   {
+      RequestExecutor executor(1);
+      for (int i = 0; i < 4; ++i) {
+         statuses.push_back(executor.submit([&ranCount]() {
+            ++ranCount;
+            return 0;
+         }));
+      }
+      // the destructor waits for the queue before stopping the workers
+   }
+   ASSERT_EQ(ranCount.load(), 4);
+   for (std::future<int> &status : statuses) {
+      ASSERT_EQ(status.get(), 0);
+   }
+}
+
+#endif // ZTS
@@ -0,0 +1,69 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 polarboy <polarboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "polarphp/vm/ZendApi.h"
+#include "polarphp/runtime/RequestSnapshot.h"
+#include "polarphp/runtime/Output.h"
+
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using polar::runtime::RequestSnapshot;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string write_script(const std::string &name, const std::string &code)
+{
+   fs::path path = fs::temp_directory_path() / name;
+   std::ofstream(path) << code;
+   return path.string();
+}
+
+} // anonymous namespace
+
+TEST(RequestSnapshotTest, testForkedRequests)
+{
+   // the bootstrap leaves a function, a global and an open output buffer
+   std::string bootstrap = write_script("polar_snapshot_bootstrap.php",
+                                        "<?php\n"
+                                        "function snapshot_answer() { return 42; }\n"
+                                        "$GLOBALS['snapshot_counter'] = 0;\n"
+                                        "ob_start();\n"
+                                        "echo 'bootstrap output';\n");
+   // every request sees the bootstrapped state and none of the buffers
+   std::string request = write_script("polar_snapshot_request.php",
+                                      "<?php\n"
+                                      "$GLOBALS['snapshot_counter']++;\n"
+                                      "exit(snapshot_answer() + $GLOBALS['snapshot_counter'] + 100 * ob_get_level());\n");
+   RequestSnapshot snapshot;
+   ASSERT_FALSE(snapshot.isCaptured());
+   ASSERT_TRUE(snapshot.capture(bootstrap));
+   ASSERT_TRUE(snapshot.isCaptured());
+#if HAVE_FORK
+   for (int i = 0; i < 3; ++i) {
+      int exitStatus = 0;
+      ASSERT_TRUE(snapshot.exec(request, exitStatus));
+      // the counter of a forked request never reaches the next one
+      ASSERT_EQ(exitStatus, 43);
+   }
+#else
+   int exitStatus = 0;
+   ASSERT_TRUE(snapshot.exec(request, exitStatus));
+#endif
+   // drop the buffer the bootstrap left open in the template request
+   polar::runtime::php_output_discard_all();
+   fs::remove(bootstrap);
+   fs::remove(request);
+}
@@ -0,0 +1,145 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 polarboy <polarboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "polarphp/vm/ZendApi.h"
+#include "polarphp/runtime/ScriptBundle.h"
+#include "polarphp/utils/Compression.h"
+#include "polarphp/utils/TarWriter.h"
+
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+using polar::runtime::ScriptBundle;
+using polar::basic::StringRef;
+using polar::utils::TarWriter;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void write_file(const fs::path &path, const std::string &code)
+{
+   std::ofstream(path) << code;
+}
+
+std::string read_file(const std::string &path)
+{
+   std::ifstream input(path, std::ios::binary);
+   return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+}
+
+/// a bundle holding the single member \p member with \p code
+void write_bundle(const std::string &bundlePath, StringRef member, StringRef code)
+{
+   auto writerOrError = TarWriter::create(bundlePath, "bundle");
+   ASSERT_TRUE(static_cast<bool>(writerOrError));
+   writerOrError.get()->append(member, code);
+}
+
+} // anonymous namespace
+
+TEST(ScriptBundleTest, testBuildLoadResolve)
+{
+   fs::path root = fs::temp_directory_path() / "polar_script_bundle_test";
+   fs::remove_all(root);
+   fs::create_directories(root / "lib" / "deep");
+   write_file(root / "index.php", "<?php require 'lib/a.php';");
+   write_file(root / "lib" / "a.php", "<?php echo 'a';");
+   write_file(root / "lib" / "deep" / "b.php", std::string(511, 'b'));
+   std::string bundlePath = (fs::temp_directory_path() / "polar_script_bundle_test.bundle").string();
+   std::vector<bool> modes{false};
+   if (polar::utils::zlib::is_available()) {
+      modes.push_back(true);
+   }
+   for (bool compress : modes) {
+      std::string errorMsg;
+      ASSERT_TRUE(ScriptBundle::build(bundlePath, root.string(), compress, errorMsg)) << errorMsg;
+      std::unique_ptr<ScriptBundle> bundle = ScriptBundle::open(bundlePath, "/srv/app/", errorMsg);
+      ASSERT_TRUE(bundle != nullptr) << errorMsg;
+      ASSERT_EQ(bundle->getMountPoint(), "/srv/app");
+      ASSERT_EQ(bundle->getFileCount(), 3u);
+      StringRef source;
+      ASSERT_TRUE(bundle->getSource("/srv/app/index.php", source));
+      ASSERT_EQ(source, "<?php require 'lib/a.php';");
+      // relative paths are resolved against the mount point
+      ASSERT_TRUE(bundle->getSource("lib/a.php", source));
+      ASSERT_EQ(source, "<?php echo 'a';");
+      ASSERT_TRUE(bundle->getSource("/srv/app/lib/./deep/b.php", source));
+      ASSERT_EQ(source.size(), 511u);
+      // the scanner reads past the end of the source
+      for (size_t i = 0; i < ZEND_MMAP_AHEAD; ++i) {
+         ASSERT_EQ(source.getData()[source.size() + i], '\0');
+      }
+      ASSERT_TRUE(bundle->isFile("/srv/app/lib/a.php"));
+      ASSERT_FALSE(bundle->isFile("/srv/app/lib"));
+      ASSERT_TRUE(bundle->isDirectory("/srv/app/lib/deep"));
+      ASSERT_FALSE(bundle->getSource("/srv/app/missing.php", source));
+      ASSERT_FALSE(bundle->getSource((root / "index.php").string(), source));
+   }
+   fs::remove(bundlePath);
+   fs::remove_all(root);
+}
+
+TEST(ScriptBundleTest, testCorruptBundle)
+{
+   fs::path root = fs::temp_directory_path() / "polar_script_bundle_corrupt_test";
+   fs::remove_all(root);
+   fs::create_directories(root);
+   write_file(root / "a.php", "<?php echo 1;");
+   std::string bundlePath = (fs::temp_directory_path() / "polar_script_bundle_corrupt_test.bundle").string();
+   std::string errorMsg;
+   ASSERT_TRUE(ScriptBundle::build(bundlePath, root.string(), false, errorMsg));
+   std::string content = read_file(bundlePath);
+   auto write_bundle_data = [&](const std::string &data) {
+      std::ofstream(bundlePath, std::ios::binary | std::ios::trunc) << data;
+   };
+   // a header byte changed after the checksum was written
+   std::string corrupt = content;
+   corrupt[10] ^= 1;
+   write_bundle_data(corrupt);
+   ASSERT_TRUE(ScriptBundle::open(bundlePath, "/srv/app", errorMsg) == nullptr);
+   ASSERT_EQ(errorMsg.find("corrupted bundle header"), 0u);
+   // the data of the member is cut
+   write_bundle_data(content.substr(0, 512 + 4));
+   errorMsg.clear();
+   ASSERT_TRUE(ScriptBundle::open(bundlePath, "/srv/app", errorMsg) == nullptr);
+   ASSERT_EQ(errorMsg, "truncated bundle");
+   ASSERT_TRUE(ScriptBundle::open(bundlePath + ".missing", "/srv/app", errorMsg) == nullptr);
+   fs::remove(bundlePath);
+   fs::remove_all(root);
+}
+
+TEST(ScriptBundleTest, testMemberPaths)
+{
+   std::string bundlePath = (fs::temp_directory_path() / "polar_script_bundle_path_test.bundle").string();
+   std::string errorMsg;
+   // a member escaping the mount point fails the whole bundle
+   for (const char *member : {"../evil.php", "lib/../../evil.php", "/etc/evil.php", ".."}) {
+      write_bundle(bundlePath, member, "<?php echo 'evil';");
+      errorMsg.clear();
+      ASSERT_TRUE(ScriptBundle::open(bundlePath, "/srv/app", errorMsg) == nullptr) << member;
+      ASSERT_NE(errorMsg.find("escapes the bundle"), std::string::npos) << member;
+   }
+   // "." components and repeated separators are dropped
+   write_bundle(bundlePath, "./lib//./a.php", "<?php echo 'a';");
+   std::unique_ptr<ScriptBundle> bundle = ScriptBundle::open(bundlePath, "/srv/app", errorMsg);
+   ASSERT_TRUE(bundle != nullptr) << errorMsg;
+   StringRef source;
+   ASSERT_TRUE(bundle->getSource("/srv/app/lib/a.php", source));
+   ASSERT_EQ(source, "<?php echo 'a';");
+   ASSERT_EQ(bundle->getFileCount(), 1u);
+   fs::remove(bundlePath);
+}
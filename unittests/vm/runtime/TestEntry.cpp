@@ -0,0 +1,24 @@
+// This source file is part of the polarphp.org open source project
+//
+// Copyright (c) 2017 - 2018 polarphp software foundation
+// Copyright (c) 2017 - 2018 zzu_softboy <zzu_softboy@163.com>
+// Licensed under Apache License v2.0 with Runtime Library Exception
+//
+// See https://polarphp.org/LICENSE.txt for license information
+// See https://polarphp.org/CONTRIBUTORS.txt for the list of polarphp project authors
+//
+// Created by polarboy on 2019/03/05.
+
+#include "gtest/gtest.h"
+
+#include "PolarEmbed.h"
+
+int main(int argc, char **argv)
+{
+   int retCode = 0;
+   polar::unittest::begin_vm_context(argc, argv);
+   ::testing::InitGoogleTest(&argc, argv);
+   retCode = RUN_ALL_TESTS();
+   polar::unittest::end_vm_context();
+   return retCode;
+}